@@ -221,6 +221,21 @@ preferences_window['draw_Appearance and rendering'] = function()
    end
    gom.set_environment_value('gfx:default_full_screen_effect', effect)
 
+   preferences_window.edit_preference_boolean(
+       'Save scenes as indexed .graphite files (parallel save/load)',
+       'gui:indexed_graphite'
+   )
+
+   preferences_window.edit_preference_boolean(
+       'Load indexed .graphite objects on demand (lazy)',
+       'gui:lazy_graphite'
+   )
+
+   preferences_window.edit_preference_boolean(
+       'Pick mesh elements on the CPU (no GPU read-back)',
+       'gui:cpu_picking'
+   )
+
    preferences_window.edit_preference_boolean(
        'Enable undo (saves state before each command)', 'gui:undo'
    )
@@ -239,6 +254,19 @@ preferences_window['draw_Appearance and rendering'] = function()
       if sel then
          gom.set_environment_value('gui:undo_depth',undo_depth)
       end
+
+      local undo_memory = tonumber(gom.get_environment_value('gui:undo_memory'))
+      if undo_memory == nil then
+         undo_memory = 1024
+      end
+      imgui.Text('Undo memory (MB)')
+      imgui.SameLine()
+      imgui.PushItemWidth(-1)
+      sel,undo_memory = imgui.InputInt('##undo_memory',undo_memory)
+      imgui.PopItemWidth()
+      if sel then
+         gom.set_environment_value('gui:undo_memory',undo_memory)
+      end
    end
 
 end
@@ -0,0 +1,222 @@
+
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2015 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact for Graphite: Bruno Levy - Bruno.Levy@inria.fr
+ *  Contact for this Plugin: Bruno Levy - Bruno.Levy@inria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL, Graphite can be linked with the following
+ * (non-GPL) libraries:
+ *     Qt, tetgen, SuperLU, WildMagic and CGAL
+ */
+
+#include <OGF/RayTracing/commands/mesh_grob_ray_tracing_commands.h>
+#include <OGF/RayTracing/shaders/mesh_grob_ray_tracing_shader.h>
+
+#include <geogram/image/image_library.h>
+#include <geogram/basic/file_system.h>
+#include <geogram/basic/string.h>
+#include <geogram/basic/stopwatch.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The camera of a frame.
+     */
+    struct Camera {
+	Camera() : light(0.0, 0.0, 1.0) {
+	    modelview.load_identity();
+	    project.load_identity();
+	}
+	mat4 modelview;
+	mat4 project;
+	vec3 light;
+    };
+
+    /**
+     * \brief Reads a 4x4 matrix from a stream.
+     * \details The coefficients are read in the order used by
+     *  operator<< for matrices.
+     * \param[in] in the input stream
+     * \param[out] M the matrix
+     * \retval true if the 16 coefficients could be read
+     * \retval false otherwise
+     */
+    bool read_matrix(std::istream& in, mat4& M) {
+	FOR(i,4) {
+	    FOR(j,4) {
+		if(!(in >> M(i,j))) {
+		    return false;
+		}
+	    }
+	}
+	return true;
+    }
+
+    /**
+     * \brief Loads a camera path.
+     * \details See MeshGrobRayTracingCommands::render_frames() for
+     *  the file format.
+     * \param[in] filename the name of the file
+     * \param[out] frames the camera of each frame
+     * \retval true if the file could be read
+     * \retval false otherwise
+     */
+    bool load_camera_path(
+	const std::string& filename, std::vector<Camera>& frames
+    ) {
+	frames.clear();
+	std::ifstream in(filename.c_str());
+	if(!in) {
+	    Logger::err("RayTracing") << filename << ": could not open file"
+				      << std::endl;
+	    return false;
+	}
+	Camera current;
+	std::string line;
+	index_t line_num = 0;
+	while(std::getline(in, line)) {
+	    ++line_num;
+	    std::istringstream line_in(line);
+	    std::string keyword;
+	    if(!(line_in >> keyword) || keyword[0] == '#') {
+		continue;
+	    }
+	    bool ok = true;
+	    if(keyword == "modelview") {
+		ok = read_matrix(line_in, current.modelview);
+		frames.push_back(current);
+	    } else if(keyword == "project") {
+		ok = read_matrix(line_in, current.project);
+	    } else if(keyword == "light") {
+		ok = bool(
+		    line_in >> current.light.x
+		            >> current.light.y
+		            >> current.light.z
+		);
+	    } else if(keyword != "size" && keyword != "viewport") {
+		ok = false;
+	    }
+	    if(!ok) {
+		Logger::err("RayTracing") << filename << ":" << line_num
+					  << ": invalid line" << std::endl;
+		return false;
+	    }
+	    // project and light also apply to the current frame.
+	    if(!frames.empty()) {
+		frames.back().project = current.project;
+		frames.back().light = current.light;
+	    }
+	}
+	return true;
+    }
+}
+
+namespace OGF {
+
+    MeshGrobRayTracingCommands::MeshGrobRayTracingCommands() {
+    }
+
+    MeshGrobRayTracingCommands::~MeshGrobRayTracingCommands() {
+    }
+
+    void MeshGrobRayTracingCommands::render_frames(
+	const FileName& camera_path,
+	const NewImageFileName& output,
+	index_t width,
+	index_t height,
+	index_t nb_samples
+    ) {
+	if(width == 0 || height == 0 || nb_samples == 0) {
+	    Logger::err("RayTracing")
+		<< "width, height and nb_samples should be non-zero"
+		<< std::endl;
+	    return;
+	}
+
+	std::vector<Camera> frames;
+	if(!load_camera_path(camera_path, frames)) {
+	    return;
+	}
+	if(frames.empty()) {
+	    Logger::err("RayTracing") << camera_path << ": no frame"
+				      << std::endl;
+	    return;
+	}
+
+	// Use the current shader if it is a RayTracing shader (then its
+	// settings and its BVH are reused), else a temporary one.
+	RayTracingMeshGrobShader* shader =
+	    dynamic_cast<RayTracingMeshGrobShader*>(mesh_grob()->get_shader());
+	SmartPointer<RayTracingMeshGrobShader> tmp_shader;
+	if(shader == nullptr) {
+	    Stopwatch W("Setup");
+	    tmp_shader = new RayTracingMeshGrobShader(mesh_grob());
+	    shader = tmp_shader;
+	}
+
+	std::string prefix =
+	    FileSystem::dir_name(output) + "/" +
+	    FileSystem::base_name(output) + "_";
+	std::string extension = FileSystem::extension(output);
+
+	Stopwatch W_total("Render", false);
+	double raytrace_time = 0.0;
+	FOR(i, frames.size()) {
+	    const Camera& camera = frames[i];
+	    Stopwatch W_frame("Frame", false);
+	    Image* image = shader->render(
+		width, height,
+		camera.modelview, camera.project, camera.light,
+		nb_samples
+	    );
+	    double frame_time = W_frame.elapsed_time();
+	    raytrace_time += frame_time;
+	    std::string filename =
+		prefix + String::format("%04d", int(i)) + "." + extension;
+	    ImageLibrary::instance()->save_image(filename, image);
+	    Logger::out("RayTracing")
+		<< filename << ": " << frame_time << " s ("
+		<< double(width) * double(height) * double(nb_samples) /
+		   (1e6 * frame_time)
+		<< " Mrays/s)" << std::endl;
+	}
+	Logger::out("RayTracing")
+	    << frames.size() << " frames in " << W_total.elapsed_time()
+	    << " s, raytracing: "
+	    << raytrace_time / double(frames.size()) << " s per frame"
+	    << std::endl;
+    }
+}
@@ -0,0 +1,104 @@
+
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2015 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact for Graphite: Bruno Levy - Bruno.Levy@inria.fr
+ *  Contact for this Plugin: Bruno Levy - Bruno.Levy@inria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL, Graphite can be linked with the following
+ * (non-GPL) libraries:
+ *     Qt, tetgen, SuperLU, WildMagic and CGAL
+ */
+
+#ifndef H__OGF_RAYTRACING_COMMANDS_MESH_GROB_RAY_TRACING_COMMANDS__H
+#define H__OGF_RAYTRACING_COMMANDS_MESH_GROB_RAY_TRACING_COMMANDS__H
+
+#include <OGF/RayTracing/common/common.h>
+#include <OGF/mesh/commands/mesh_grob_commands.h>
+
+/**
+ * \file OGF/RayTracing/commands/mesh_grob_ray_tracing_commands.h
+ * \brief Commands that render a MeshGrob with the CPU raytracer.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief Commands that render a MeshGrob with the CPU raytracer.
+     */
+    gom_class RayTracing_API MeshGrobRayTracingCommands :
+        public MeshGrobCommands {
+    public:
+
+        /**
+         * \brief MeshGrobRayTracingCommands constructor.
+         */
+        MeshGrobRayTracingCommands();
+
+        /**
+         * \brief MeshGrobRayTracingCommands destructor.
+         */
+        ~MeshGrobRayTracingCommands() override;
+
+    gom_slots:
+
+	/**
+	 * \brief Raytraces an image sequence along a camera path, without
+	 *  any window or OpenGL context.
+	 * \details The camera path is a text file. Each line that starts
+	 *  with modelview (followed by the 16 coefficients of the matrix)
+	 *  starts a new frame. The lines project (16 coefficients) and
+	 *  light (3 coordinates, in eye space) change the camera of the
+	 *  current frame and of the next ones. This is the format written
+	 *  by the save_background() slot of the RayTracing shader.
+	 *  The shading parameters are taken from the current shader of
+	 *  the object if it is a RayTracing shader. The geometry needs
+	 *  to be static: the acceleration structures are built once and
+	 *  shared by all the frames.
+	 * \param[in] camera_path the file with the camera of each frame
+	 * \param[in] output the image file name. The frame number is
+	 *  appended to it, e.g. frame.png gives frame_0000.png,
+	 *  frame_0001.png ...
+	 * \param[in] width the width of the images
+	 * \param[in] height the height of the images
+	 * \param[in] nb_samples number of rays per pixel
+	 */
+	void render_frames(
+	    const FileName& camera_path,
+	    const NewImageFileName& output = "frame.png",
+	    index_t width = 800,
+	    index_t height = 600,
+	    index_t nb_samples = 1
+	);
+    };
+}
+
+#endif
@@ -44,6 +44,7 @@
 #include <OGF/gom/types/gom_defs.h>
 #include <OGF/scene_graph/types/scene_graph_library.h>
 #include <OGF/RayTracing/shaders/mesh_grob_ray_tracing_shader.h>
+#include <OGF/RayTracing/commands/mesh_grob_ray_tracing_commands.h>
 // [includes insertion point] (do not delete this line)
 
 namespace OGF {
@@ -57,6 +58,7 @@ namespace OGF {
         gom_package_initialize(RayTracing) ;
 
         ogf_register_grob_shader<OGF::MeshGrob,RayTracingMeshGrobShader>();
+        ogf_register_grob_commands<OGF::MeshGrob,MeshGrobRayTracingCommands>();
         // [source insertion point] (do not delete this line)
 
         // Insert package initialization stuff here ...
@@ -53,8 +53,10 @@
 #define NO_INDEXED_GEOMETRY
 #define NO_CUSTOM_GEOMETRY
 
-// For now, deactivate SSE/AVX under Windows.
-#ifdef GEO_OS_WINDOWS
+// SIMD layouts and traversal are controlled by the RAYTRACING_SIMD
+// CMake option. If it is not set, deactivate SSE/AVX under Windows.
+#if defined(RAYTRACING_NO_SIMD) || \
+    (defined(GEO_OS_WINDOWS) && !defined(RAYTRACING_SIMD))
 #define TINYBVH_NO_SIMD
 #endif
 
@@ -92,6 +94,24 @@
 #endif
 #endif
 
+namespace {
+
+    /**
+     * \brief Gets the SIMD instruction set used by tinybvh.
+     * \return a string that describes the instruction set, to be
+     *  displayed in the statistics.
+     */
+    const char* tinybvh_simd_mode() {
+#if defined(BVH_USEAVX)
+	return "AVX";
+#elif defined(BVH_USENEON)
+	return "NEON";
+#else
+	return "no SIMD";
+#endif
+    }
+}
+
 namespace OGF {
 
     /**
@@ -102,10 +122,15 @@ namespace OGF {
 	/**
 	 * \brief BVH constructor
 	 * \param[in] M a surface mesh
+	 * \param[in] hq if set, use the high-quality (SBVH) builder
+	 * \param[in] packets if set, also create the BVH used to
+	 *  trace packets of rays
 	 * \details Creates an attribute ith per-corner single-precision
 	 *  coordinates, used by TinyBVH internally.
 	 */
-	BVH(Mesh& M) : M_(M) {
+	BVH(Mesh& M, bool hq = false, bool packets = false) :
+	    M_(M),
+	    has_packets_(packets) {
 	    points_vec4_.bind_if_is_defined(
 		M.facet_corners.attributes(), "point_vec4"
 	    );
@@ -122,11 +147,31 @@ namespace OGF {
 		points_vec4_[4*c+2] = float(p.z);
 		points_vec4_[4*c+3] = 0.0f;
 	    }
-	    impl_.Build( // or BuildHQ
-		(tinybvh::bvhvec4*)(points_vec4_.data()),
-		M.facets.nb()
-	    );
+	    const tinybvh::bvhvec4* vertices =
+		(const tinybvh::bvhvec4*)(points_vec4_.data());
+	    if(hq) {
+		impl_.BuildHQ(vertices, M.facets.nb());
+	    } else {
+		impl_.Build(vertices, M.facets.nb());
+	    }
 	    // impl_.optimize();
+
+	    // Packet traversal is only implemented for the
+	    // standard (binary) BVH layout.
+	    if(packets) {
+		if(hq) {
+		    packet_impl_.BuildHQ(vertices, M.facets.nb());
+		} else {
+		    packet_impl_.Build(vertices, M.facets.nb());
+		}
+	    }
+	}
+
+	/**
+	 * \brief Tests whether this BVH can trace packets of rays.
+	 */
+	bool has_packets() const {
+	    return has_packets_;
 	}
 
 	/**
@@ -139,14 +184,65 @@ namespace OGF {
 	bool ray_nearest_intersection(
 	    const Ray& R, MeshFacetsAABB::Intersection& I
 	) const {
+	    tinybvh::Ray ray = tinybvh_ray(R);
+	    impl_.Intersect(ray);
+	    return get_intersection(ray, I);
+	}
+
+	/**
+	 * \brief Computes the nearest intersections of a packet of rays.
+	 * \details The rays correspond to a tile of 16x16 pixels. They
+	 *  need to have the same origin, and to be ordered as 4x4 blocks
+	 *  of 4x4 pixels (see BVH::Intersect256Rays() in tinybvh).
+	 *  has_packets() needs to be true.
+	 * \param[in] R a pointer to 256 rays
+	 * \param[out] I a pointer to 256 intersections
+	 * \param[out] has_isect a pointer to 256 booleans, set to
+	 *  true for the rays that have an intersection
+	 */
+	void packet_nearest_intersections(
+	    const Ray* R, MeshFacetsAABB::Intersection* I, bool* has_isect
+	) const {
+	    geo_debug_assert(has_packets_);
+	    tinybvh::Ray packet[256];
+	    for(index_t k=0; k<256; ++k) {
+		packet[k] = tinybvh_ray(R[k]);
+	    }
+#ifdef BVH_USEAVX
+	    packet_impl_.Intersect256RaysSSE(packet);
+#else
+	    packet_impl_.Intersect256Rays(packet);
+#endif
+	    for(index_t k=0; k<256; ++k) {
+		has_isect[k] = get_intersection(packet[k], I[k]);
+	    }
+	}
+
+	/**
+	 * \brief Converts a ray into the tinybvh representation
+	 * \param[in] R the ray
+	 * \return the tinybvh ray, with normalized direction
+	 */
+	static tinybvh::Ray tinybvh_ray(const Ray& R) {
 	    vec3 o = R.origin;
 	    vec3 d = R.direction;
-	    tinybvh::Ray ray(
+	    return tinybvh::Ray(
 		tinybvh::bvhvec3(float(o.x), float(o.y), float(o.z)),
 		tinybvh::bvhvec3(float(d.x), float(d.y), float(d.z)),
 		1e30f
 	    );
-	    impl_.Intersect(ray);
+	}
+
+	/**
+	 * \brief Gets the intersection from a traced tinybvh ray
+	 * \param[in] ray the ray, after traversal
+	 * \param[out] I the intersection if it exists
+	 * \retval true if there was an intersection
+	 * \retval false otherwise
+	 */
+	bool get_intersection(
+	    const tinybvh::Ray& ray, MeshFacetsAABB::Intersection& I
+	) const {
 	    if(ray.hit.t >= 10000.0f) {
 		return false;
 	    }
@@ -174,14 +270,7 @@ namespace OGF {
 	 * \retval false otherwise
 	 */
 	bool ray_is_in_shadow(const Ray& R) const {
-	    vec3 o = R.origin;
-	    vec3 d = R.direction;
-	    tinybvh::Ray ray(
-		tinybvh::bvhvec3(float(o.x), float(o.y), float(o.z)),
-		tinybvh::bvhvec3(float(d.x), float(d.y), float(d.z)),
-		1e30f
-	    );
-	    return impl_.IsOccluded(ray);
+	    return impl_.IsOccluded(tinybvh_ray(R));
 	}
 
 	/**
@@ -198,6 +287,8 @@ namespace OGF {
     private:
 	Mesh& M_;
 	tinybvh::BVH4_CPU impl_;
+	tinybvh::BVH packet_impl_;
+	bool has_packets_;
 	Attribute<float> points_vec4_;
     };
 }
@@ -208,16 +299,15 @@ namespace OGF {
         OGF::MeshGrob* grob
     ):
 	MeshGrobShader(grob),
-	texture_(0),
-	AABB_(*grob)
+	texture_(0)
     {
 	use_tinybvh_ = false;
+	tinybvh_hq_ = false;
+	ray_packets_ = false;
+	perspective_ = false;
 	bvh_ = nullptr;
 	background_mesh_bvh_ = nullptr;
 
-	// AABB changed facet order, need to notify
-	mesh_grob()->update();
-
 	supersampling_ = 1;
         color_ = Color(0.5, 0.5, 1.0, 0.5);
 	spec_ = 1.0;
@@ -240,15 +330,58 @@ namespace OGF {
 	facet_corner_normal_.bind_if_is_defined(
 	    mesh_grob()->facet_corners.attributes(), "normal"
 	);
-	bool has_facet_corner_normals =
-	    (facet_corner_normal_.is_bound());
-	if(!has_facet_corner_normals) {
+	has_facet_corner_normals_ = facet_corner_normal_.is_bound();
+	if(!has_facet_corner_normals_) {
 	    facet_corner_normal_.bind(
 		mesh_grob()->facet_corners.attributes(), "normal"
 	    );
 	}
+
+	copy_background_queued_ = false;
+	save_background_queued_ = false;
+	show_stats_ = false;
+
+	core_color_ = Color(0.0, 0.0, 0.0, 1.0);
+
+	update_geometry();
+    }
+
+    RayTracingMeshGrobShader::~RayTracingMeshGrobShader() {
+	if(texture_ != 0) {
+	    glDeleteTextures(1, &texture_);
+	    texture_ = 0;
+	}
+	delete bvh_;
+	delete background_mesh_bvh_;
+    }
+
+    void RayTracingMeshGrobShader::set_tinybvh_hq(bool x) {
+	if(x != tinybvh_hq_) {
+	    tinybvh_hq_ = x;
+	    rebuild_bvh();
+	}
+	update();
+    }
+
+    void RayTracingMeshGrobShader::set_ray_packets(bool x) {
+	if(x != ray_packets_) {
+	    ray_packets_ = x;
+	    rebuild_bvh();
+	}
+	update();
+    }
+
+    void RayTracingMeshGrobShader::rebuild_bvh() {
+	Stopwatch W("BVH", show_stats_);
+	delete bvh_;
+	bvh_ = new BVH(*mesh_grob(), tinybvh_hq_, ray_packets_);
+    }
+
+    void RayTracingMeshGrobShader::update_geometry() {
+	// Done first: it may reorder (and triangulate) the facets.
+	AABB_ = mesh_grob()->facets_AABB();
 	for(index_t f: mesh_grob()->facets) {
-	    if(has_facet_corner_normals) {
+	    if(has_facet_corner_normals_) {
 		facet_normal_[f] = vec3(0.0, 0.0, 0.0);
 		for(index_t c: mesh_grob()->facets.corners(f)) {
 		    facet_normal_[f] += facet_corner_normal_[c];
@@ -277,27 +410,13 @@ namespace OGF {
 	}
 	FOR(c, mesh_grob()->facet_corners.nb()) {
 	    index_t v = mesh_grob()->facet_corners.vertex(c);
-	    if(!has_facet_corner_normals) {
+	    if(!has_facet_corner_normals_) {
 		facet_corner_normal_[c] = vertex_normal_[v];
 	    }
 	}
 	bbox_diag_ = bbox_diagonal(*mesh_grob());
-	copy_background_queued_ = false;
-	save_background_queued_ = false;
-	show_stats_ = false;
-
-	core_color_ = Color(0.0, 0.0, 0.0, 1.0);
-
-	bvh_ = new BVH(*mesh_grob());
-    }
-
-    RayTracingMeshGrobShader::~RayTracingMeshGrobShader() {
-	if(texture_ != 0) {
-	    glDeleteTextures(1, &texture_);
-	    texture_ = 0;
-	}
-	delete bvh_;
-	delete background_mesh_bvh_;
+	rebuild_bvh();
+	geometry_timestamp_ = mesh_grob()->timestamp();
     }
 
     void RayTracingMeshGrobShader::draw() {
@@ -445,7 +564,12 @@ namespace OGF {
 	    main->get_property("height",tmp);
 	    tmp.get_value(h);
 	}
+	create_or_resize_image_if_needed(w,h);
+    }
 
+    void RayTracingMeshGrobShader::create_or_resize_image_if_needed(
+	index_t w, index_t h
+    ) {
 	if(image_.is_null() ||
 	   image_->width() != w ||
 	   image_->height() != h
@@ -473,30 +597,75 @@ namespace OGF {
     void RayTracingMeshGrobShader::update_viewing_parameters() {
 	GLint viewport[4];
 	glGetIntegerv(GL_VIEWPORT, viewport);
+	double viewport_d[4];
 	FOR(i,4) {
-	    viewport_[i] = double(viewport[i]);
+	    viewport_d[i] = double(viewport[i]);
 	}
 
 	mat4 modelview;
 	glupGetMatrixdv(GLUP_MODELVIEW_MATRIX, modelview.data());
+	mat4 project;
+	glupGetMatrixdv(GLUP_PROJECTION_MATRIX, project.data());
+
+	float Lf[3];
+	glupGetLightVector3fv(Lf);
+
+	set_viewing_parameters(
+	    viewport_d, modelview, project,
+	    vec3(double(Lf[0]), double(Lf[1]), double(Lf[2]))
+	);
+    }
+
+    void RayTracingMeshGrobShader::set_viewing_parameters(
+	const double viewport[4],
+	const mat4& modelview_in, const mat4& project_in,
+	const vec3& light
+    ) {
+	FOR(i,4) {
+	    viewport_[i] = viewport[i];
+	}
+
 	mat3 normalmatrix;
 	FOR(i,3) {
 	    FOR(j,3) {
-		normalmatrix(i,j) = modelview(i,j);
+		normalmatrix(i,j) = modelview_in(i,j);
 	    }
 	}
-	modelview = modelview.transpose();
-	mat4 project;
-	glupGetMatrixdv(GLUP_PROJECTION_MATRIX, project.data());
-	project = project.transpose();
+	mat4 modelview = modelview_in.transpose();
+	mat4 project = project_in.transpose();
 
 	inv_project_modelview_ = (project*modelview).inverse();
 
-	float Lf[3];
-	glupGetLightVector3fv(Lf);
+	// The eye is the point mapped to (0,0,1,0) by the projection.
+	// It is at infinity (w = 0) for orthographic projections.
+	vec4 eye = inv_project_modelview_ * vec4(0.0, 0.0, 1.0, 0.0);
+	double eye_len = length(vec3(eye.x, eye.y, eye.z));
+	perspective_ = (::fabs(eye.w) > 1e-12 * eye_len);
+	if(perspective_) {
+	    eye_ = (1.0/eye.w)*vec3(eye.x, eye.y, eye.z);
+	}
 
-	L_ = vec3(double(Lf[0]), double(Lf[1]), double(Lf[2]));
-	L_ = normalize(normalmatrix*L_);
+	L_ = normalize(normalmatrix*light);
+    }
+
+    Image* RayTracingMeshGrobShader::render(
+	index_t width, index_t height,
+	const mat4& modelview, const mat4& project, const vec3& light,
+	index_t nb_samples
+    ) {
+	// The BVH is kept as long as the mesh is not modified, so that
+	// successive frames of a sequence only pay for the rays.
+	if(mesh_grob()->timestamp() != geometry_timestamp_) {
+	    update_geometry();
+	}
+	create_or_resize_image_if_needed(width, height);
+	double viewport[4] = { 0.0, 0.0, double(width), double(height) };
+	set_viewing_parameters(viewport, modelview, project, light);
+	index_t supersampling_bkp = supersampling_;
+	supersampling_ = nb_samples;
+	raytrace();
+	supersampling_ = supersampling_bkp;
+	return image_;
     }
 
     Ray RayTracingMeshGrobShader::primary_ray(double x, double y) {
@@ -585,16 +754,29 @@ namespace OGF {
 
     void RayTracingMeshGrobShader::raytrace() {
 	Stopwatch W("Raytracing", show_stats_);
+
+	bool packets =
+	    use_tinybvh_ && ray_packets_ && bvh_->has_packets() &&
+	    perspective_ && !xray_ && supersampling_ <= 1;
+
+	if(packets) {
+	    raytrace_packets();
+	} else {
 	// Raytrace, parallel threads in image stripes,
-	// by blocs of 4x4 pixels (better for locality)
+	// by blocs of 4x4 pixels (better for locality).
+	// The blocs on the right and top borders may be partial.
 
 	static constexpr index_t BLOC = 4;
-
-	parallel_for(0, image_->height()/BLOC,
-	   [this](index_t YY) {
-	       FOR(XX, image_->width()/BLOC) {
-	       for(index_t Y = YY*BLOC; Y < YY*BLOC+BLOC; ++Y)
-	       for(index_t X = XX*BLOC; X < XX*BLOC+BLOC; ++X)
+	index_t nb_blocs_x = (image_->width() + BLOC - 1) / BLOC;
+	index_t nb_blocs_y = (image_->height() + BLOC - 1) / BLOC;
+
+	parallel_for(0, nb_blocs_y,
+	   [this, nb_blocs_x](index_t YY) {
+	       index_t Y_end = std::min(YY*BLOC+BLOC, image_->height());
+	       FOR(XX, nb_blocs_x) {
+	       index_t X_end = std::min(XX*BLOC+BLOC, image_->width());
+	       for(index_t Y = YY*BLOC; Y < Y_end; ++Y)
+	       for(index_t X = XX*BLOC; X < X_end; ++X)
 		   if(supersampling_ <= 1) {
 		       set_pixel(X, Y, raytrace_pixel(double(X), double(Y)));
 		   } else {
@@ -611,21 +793,88 @@ namespace OGF {
 	       }
 	   }
 	);
+	}
+
 	if(show_stats_) {
+	    std::string mode = "AABB";
+	    if(use_tinybvh_) {
+		mode = std::string("tinybvh") +
+		    (tinybvh_hq_ ? " HQ" : "") +
+		    (packets ? " packets" : "") +
+		    " (" + tinybvh_simd_mode() + ")";
+	    }
 	    index_t pixels = image_->width() * image_->height();
 	    Logger::out("Raytracing")
+		<< mode << ": "
 		<< (double(pixels) / (1e6 * W.elapsed_time()))
 		<< " Mpixels/s" << std::endl;
 	}
     }
 
+    void RayTracingMeshGrobShader::raytrace_packets() {
+	static constexpr index_t TILE = 16;
+	index_t nb_tiles_x = image_->width() / TILE;
+	index_t nb_tiles_y = image_->height() / TILE;
+
+	parallel_for(0, nb_tiles_y,
+	   [this, nb_tiles_x](index_t TY) {
+	       vector<Ray> rays(TILE*TILE);
+	       vector<double> tnear(TILE*TILE);
+	       vector<MeshFacetsAABB::Intersection> isects(TILE*TILE);
+	       bool has_isect[TILE*TILE];
+	       FOR(TX, nb_tiles_x) {
+		   // Rays are ordered as 4x4 blocks of 4x4 pixels,
+		   // as expected by tinybvh.
+		   FOR(k, TILE*TILE) {
+		       index_t X = TX*TILE + ((k >> 4) & 3) * 4 + (k & 3);
+		       index_t Y = TY*TILE + (k >> 6) * 4 + ((k >> 2) & 3);
+		       Ray R = primary_ray(double(X), double(Y));
+		       vec3 farp = R.origin + R.direction;
+		       rays[k] = Ray(eye_, farp - eye_);
+		       tnear[k] = length(R.origin - eye_);
+		   }
+		   bvh_->packet_nearest_intersections(
+		       rays.data(), isects.data(), has_isect
+		   );
+		   // Shadow rays are traced in packet order, so that
+		   // successive rays traverse the same nodes.
+		   FOR(k, TILE*TILE) {
+		       index_t X = TX*TILE + ((k >> 4) & 3) * 4 + (k & 3);
+		       index_t Y = TY*TILE + (k >> 6) * 4 + ((k >> 2) & 3);
+		       // Packets start from the eye: intersections in front
+		       // of the near plane are clipped like in the
+		       // single-ray path.
+		       if(has_isect[k] && isects[k].t < tnear[k]) {
+			   set_pixel(
+			       X, Y, raytrace_pixel(double(X), double(Y))
+			   );
+			   continue;
+		       }
+		       set_pixel(
+			   X, Y, shade_pixel(rays[k], has_isect[k], isects[k])
+		       );
+		   }
+	       }
+	   }
+	);
+
+	// Pixels not covered by a full tile
+	parallel_for(0, image_->height(),
+	   [this, nb_tiles_x, nb_tiles_y](index_t Y) {
+	       index_t X_begin = (Y < nb_tiles_y*TILE) ? nb_tiles_x*TILE : 0;
+	       for(index_t X = X_begin; X < image_->width(); ++X) {
+		   set_pixel(X, Y, raytrace_pixel(double(X), double(Y)));
+	       }
+	   }
+	);
+    }
+
     vec4 RayTracingMeshGrobShader::raytrace_pixel(double x, double y) {
-	vec4 color(0.0, 0.0, 0.0, 0.0);
 	Ray ray = primary_ray(x,y);
 
 	if(xray_) {
 	    vector<MeshFacetsAABB::Intersection> isects;
-	    AABB_.ray_all_intersections(
+	    AABB_->ray_all_intersections(
 		ray,
 		[&isects](const MeshFacetsAABB::Intersection& I) {
 		    isects.push_back(I);
@@ -655,9 +904,16 @@ namespace OGF {
 	if(use_tinybvh_) {
 	    has_isect = bvh_->ray_nearest_intersection(ray, I);
 	} else {
-	    has_isect = AABB_.ray_nearest_intersection(ray, I);
+	    has_isect = AABB_->ray_nearest_intersection(ray, I);
 	}
 
+	return shade_pixel(ray, has_isect, I);
+    }
+
+    vec4 RayTracingMeshGrobShader::shade_pixel(
+	Ray& ray, bool has_isect, MeshFacetsAABB::Intersection& I
+    ) {
+	vec4 color(0.0, 0.0, 0.0, 0.0);
 	if(has_isect) {
 	    color = vec4(0.0, 0.0, 0.0, 1.0 - transp_);
 	    bool in_shadow = false;
@@ -669,7 +925,7 @@ namespace OGF {
 		    bvh_->tweak_ray_origin(I, r);
 		    in_shadow = bvh_->ray_is_in_shadow(r);
 		} else {
-		    in_shadow = AABB_.ray_intersection(
+		    in_shadow = AABB_->ray_intersection(
 			Ray(I.p,L_), Numeric::max_float64(), I.f
 		    );
 		}
@@ -792,7 +1048,7 @@ namespace OGF {
 		// r.origin -= 1e-3 * normalize(I.N);
 		has_isect = bvh_->ray_nearest_intersection(r, I);
 	    } else {
-		has_isect = AABB_.ray_nearest_intersection(r, I);
+		has_isect = AABB_->ray_nearest_intersection(r, I);
 	    }
 	    if(!has_isect) {
 		break;
@@ -54,6 +54,25 @@ namespace OGF {
         ~RayTracingMeshGrobShader() override;
         void draw() override;
 
+	/**
+	 * \brief Raytraces an image without any OpenGL context.
+	 * \details The BVH is built again only if the mesh was modified
+	 *  since the previous image, so that it is shared by all the
+	 *  frames of a sequence with static geometry.
+	 * \param[in] width , height the size of the image
+	 * \param[in] modelview , project the modelview and projection
+	 *  matrices, stored as in the GLUP state
+	 * \param[in] light the light vector, in eye space
+	 * \param[in] nb_samples number of rays per pixel
+	 * \return a pointer to the raytraced image, owned by this shader
+	 *  and valid until the next call
+	 */
+	Image* render(
+	    index_t width, index_t height,
+	    const mat4& modelview, const mat4& project, const vec3& light,
+	    index_t nb_samples = 1
+	);
+
     gom_properties:
 
         /**
@@ -240,6 +259,26 @@ namespace OGF {
 	    update();
 	}
 
+	/**
+	 * \brief Builds the tinybvh BVH with the (slower) high-quality
+	 *  SBVH builder, that gives faster traversal.
+	 */
+	bool get_tinybvh_hq() const {
+	    return tinybvh_hq_;
+	}
+
+	void set_tinybvh_hq(bool x);
+
+	/**
+	 * \brief Traces primary rays by packets of 16x16 pixels with tinybvh
+	 *  (perspective views only), and shadow rays in packet order.
+	 */
+	bool get_ray_packets() const {
+	    return ray_packets_;
+	}
+
+	void set_ray_packets(bool x);
+
     gom_slots:
 	/**
 	 * \brief Copies background into image.
@@ -276,6 +315,13 @@ namespace OGF {
 	 */
 	void create_or_resize_image_if_needed();
 
+	/**
+	 * \brief Creates the image the first time, then resizes it
+	 *  if its size changed.
+	 * \param[in] w , h the new size of the image
+	 */
+	void create_or_resize_image_if_needed(index_t w, index_t h);
+
 
 	/**
 	 * \brief Gets the viewing parameters from the current GLUP state.
@@ -283,13 +329,59 @@ namespace OGF {
 	 */
 	void update_viewing_parameters();
 
+	/**
+	 * \brief Sets the viewing parameters.
+	 * \param[in] viewport the viewport, as x, y, width and height
+	 * \param[in] modelview , project the modelview and projection
+	 *  matrices, stored as in the GLUP state
+	 * \param[in] light the light vector, in eye space
+	 */
+	void set_viewing_parameters(
+	    const double viewport[4],
+	    const mat4& modelview, const mat4& project,
+	    const vec3& light
+	);
+
+	/**
+	 * \brief Computes the normals, the bounding box and the
+	 *  acceleration structures from the current geometry.
+	 */
+	void update_geometry();
+
 	/**
 	 * \brief Raytraces the current image.
 	 */
 	void raytrace();
 
+	/**
+	 * \brief Raytraces the current image with packets of primary rays.
+	 * \details The image is traversed by tiles of 16x16 pixels. All
+	 *  the primary rays of a tile start from the eye and traverse the
+	 *  BVH together. The pixels that are not covered by a full tile are
+	 *  raytraced one by one.
+	 */
+	void raytrace_packets();
+
 	vec4 raytrace_pixel(double x, double y);
 
+	/**
+	 * \brief Computes the color of a pixel.
+	 * \param[in] ray the primary ray
+	 * \param[in] has_isect true if the primary ray hit the surface
+	 * \param[in,out] I the intersection between the primary ray
+	 *  and the surface
+	 * \return the color with 4 components in [0,1].
+	 */
+	vec4 shade_pixel(
+	    Ray& ray, bool has_isect, MeshFacetsAABB::Intersection& I
+	);
+
+	/**
+	 * \brief Creates the tinybvh BVH of the mesh, with the current
+	 *  build options.
+	 */
+	void rebuild_bvh();
+
 	/**
 	 * \brief Sets a pixel in the final image.
 	 * \param[in] X , Y the pixel integer coordinates.
@@ -410,15 +502,19 @@ namespace OGF {
 	Color core_color_;
 
 	GLuint texture_;
-	MeshFacetsAABB AABB_;
+	std::shared_ptr<const MeshFacetsAABB> AABB_;
 
 	double viewport_[4];
 	mat4 inv_project_modelview_;
+	vec3 eye_;          /**< eye position in object space. */
+	bool perspective_;  /**< false for orthographic projections. */
 	vec3 L_; /**< light vector in object space. */
 
 	Attribute<vec3> facet_normal_;
 	Attribute<vec3> vertex_normal_;
 	Attribute<vec3> facet_corner_normal_;
+	bool has_facet_corner_normals_;
+	index_t geometry_timestamp_;
 
 	double bbox_diag_;
 
@@ -429,6 +525,8 @@ namespace OGF {
 
 	class BVH;
 	bool use_tinybvh_;
+	bool tinybvh_hq_;
+	bool ray_packets_;
 	BVH* bvh_;
 	BVH* background_mesh_bvh_;
     };
@@ -0,0 +1,761 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/WarpDrive/IO/time_series.h>
+#include <geogram/basic/string.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/geometry.h>
+
+#include <cmath>
+#include <cstring>
+#include <typeinfo>
+
+namespace {
+    using namespace OGF;
+
+    const char TS_MAGIC[8]     = { 'O','G','F','T','S','E','R','1' };
+    const char TS_END_MAGIC[8] = { 'O','G','F','T','S','E','N','D' };
+    const Numeric::uint32 TS_CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+    const Numeric::uint32 TS_INDEX_MAGIC = 0x58444e49; // "INDX"
+
+    /** \brief Size of the header of a chunk, in bytes. */
+    const Numeric::uint64 TS_CHUNK_HEADER_SIZE = 20;
+
+    /** \brief Chunk flag: values are quantized integers. */
+    const index_t TS_QUANTIZED = 1;
+
+    /** \brief Chunk flag: values are differences with previous chunk. */
+    const index_t TS_DELTA = 2;
+
+    /** \brief Attribute types. */
+    enum { TS_DOUBLE = 0, TS_VEC2 = 1, TS_VEC3 = 2 };
+
+    /**
+     * \brief Quantized values larger than that are not representable
+     *  as differences of 64 bits integers.
+     */
+    const double TS_QUANTIZE_MAX = 4.0e18;
+
+    /**
+     * \brief Writes raw bytes to a file.
+     * \param[in] f the file
+     * \param[in] data a pointer to the bytes
+     * \param[in] size number of bytes
+     * \param[in,out] offset incremented by \p size
+     * \retval true on success
+     * \retval false otherwise
+     */
+    bool write_bytes(
+	FILE* f, const void* data, size_t size, Numeric::uint64& offset
+    ) {
+	if(size != 0 && fwrite(data, 1, size, f) != size) {
+	    return false;
+	}
+	offset += size;
+	return true;
+    }
+
+    template <class T> inline bool write_value(
+	FILE* f, const T& value, Numeric::uint64& offset
+    ) {
+	return write_bytes(f, &value, sizeof(T), offset);
+    }
+
+    template <class T> inline bool read_value(FILE* f, T& value) {
+	return fread(&value, sizeof(T), 1, f) == 1;
+    }
+
+    /**
+     * \brief Moves the position of a file, with 64 bits offsets.
+     */
+    bool seek(FILE* f, Numeric::uint64 offset) {
+#ifdef GEO_OS_WINDOWS
+	return _fseeki64(f, Numeric::int64(offset), SEEK_SET) == 0;
+#else
+	return fseeko(f, off_t(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    /**
+     * \brief Gets the size of a file, with 64 bits offsets.
+     */
+    Numeric::uint64 file_size(FILE* f) {
+#ifdef GEO_OS_WINDOWS
+	_fseeki64(f, 0, SEEK_END);
+	return Numeric::uint64(_ftelli64(f));
+#else
+	fseeko(f, 0, SEEK_END);
+	return Numeric::uint64(ftello(f));
+#endif
+    }
+
+    /**
+     * \brief Appends a signed integer to a buffer, with zigzag and
+     *  variable-length encoding (small magnitudes use few bytes).
+     */
+    inline void encode_integer(
+	std::vector<Numeric::uint8>& buffer, Numeric::int64 value
+    ) {
+	Numeric::uint64 x =
+	    (Numeric::uint64(value) << 1) ^ Numeric::uint64(value >> 63);
+	while(x >= 0x80) {
+	    buffer.push_back(Numeric::uint8(x | 0x80));
+	    x >>= 7;
+	}
+	buffer.push_back(Numeric::uint8(x));
+    }
+
+    /**
+     * \brief Decodes a signed integer encoded by encode_integer().
+     * \param[in,out] p pointer to the current byte, advanced
+     * \param[in] end pointer one position past the last byte
+     * \param[out] value the decoded integer
+     * \retval true on success
+     * \retval false if the buffer is exhausted
+     */
+    inline bool decode_integer(
+	const Numeric::uint8*& p, const Numeric::uint8* end,
+	Numeric::int64& value
+    ) {
+	Numeric::uint64 x = 0;
+	for(index_t shift=0; p != end && shift < 64; shift += 7) {
+	    Numeric::uint8 b = *p;
+	    ++p;
+	    x |= Numeric::uint64(b & 0x7f) << shift;
+	    if((b & 0x80) == 0) {
+		value = Numeric::int64(x >> 1) ^ -Numeric::int64(x & 1);
+		return true;
+	    }
+	}
+	return false;
+    }
+
+    /**
+     * \brief Gets the type of a vertex attribute.
+     * \param[in] store the AttributeStore
+     * \param[out] type one of TS_DOUBLE, TS_VEC2, TS_VEC3
+     * \param[out] nb_doubles number of doubles per vertex
+     * \retval true if the type is supported
+     * \retval false otherwise
+     */
+    bool get_attribute_type(
+	const AttributeStore* store, index_t& type, index_t& nb_doubles
+    ) {
+	if(store->elements_type_matches(typeid(double).name())) {
+	    type = TS_DOUBLE;
+	    nb_doubles = store->dimension();
+	} else if(store->elements_type_matches(typeid(vec2).name())) {
+	    type = TS_VEC2;
+	    nb_doubles = 2*store->dimension();
+	} else if(store->elements_type_matches(typeid(vec3).name())) {
+	    type = TS_VEC3;
+	    nb_doubles = 3*store->dimension();
+	} else {
+	    return false;
+	}
+	return true;
+    }
+}
+
+namespace OGF {
+
+    /**************************************************************/
+
+    TimeSeriesWriter::TimeSeriesWriter() :
+	file_(nullptr),
+	nb_vertices_(0),
+	dimension_(0),
+	quantum_(0.0),
+	keyframe_interval_(0),
+	has_previous_(false),
+	nb_since_keyframe_(0),
+	offset_(0),
+	error_(false) {
+    }
+
+    TimeSeriesWriter::~TimeSeriesWriter() {
+	if(is_open()) {
+	    close();
+	}
+    }
+
+    bool TimeSeriesWriter::open(
+	const std::string& filename, const Mesh& M,
+	const std::string& attributes,
+	double quantum, index_t keyframe_interval
+    ) {
+	if(is_open()) {
+	    close();
+	}
+
+	if(!M.vertices.double_precision()) {
+	    Logger::err("TimeSeries")
+		<< "Mesh vertices should be in double precision"
+		<< std::endl;
+	    return false;
+	}
+
+	attributes_.clear();
+	std::vector<std::string> names;
+	String::split_string(attributes, ';', names);
+	for(const std::string& name : names) {
+	    const AttributeStore* store =
+		M.vertices.attributes().find_attribute_store(name);
+	    if(store == nullptr) {
+		Logger::err("TimeSeries")
+		    << name << ": no such vertex attribute" << std::endl;
+		return false;
+	    }
+	    AttributeInfo info;
+	    info.name = name;
+	    if(!get_attribute_type(store, info.type, info.nb_doubles)) {
+		Logger::err("TimeSeries")
+		    << name << ": unsupported attribute type"
+		    << " (should be double, vec2 or vec3)" << std::endl;
+		return false;
+	    }
+	    attributes_.push_back(info);
+	}
+
+	file_ = fopen(filename.c_str(), "wb");
+	if(file_ == nullptr) {
+	    Logger::err("TimeSeries")
+		<< filename << ": could not create" << std::endl;
+	    return false;
+	}
+
+	filename_ = filename;
+	nb_vertices_ = M.vertices.nb();
+	dimension_ = M.vertices.dimension();
+	quantum_ = quantum;
+	keyframe_interval_ = std::max(keyframe_interval, index_t(1));
+	has_previous_ = false;
+	nb_since_keyframe_ = 0;
+	index_.clear();
+	offset_ = 0;
+	error_ = false;
+
+	index_t nb_doubles = dimension_;
+	for(const AttributeInfo& info : attributes_) {
+	    nb_doubles += info.nb_doubles;
+	}
+	frame_.assign(size_t(nb_vertices_) * size_t(nb_doubles), 0.0);
+	previous_.assign(frame_.size(), 0);
+
+	bool ok = write_bytes(file_, TS_MAGIC, 8, offset_);
+	ok = ok && write_value(file_, Numeric::uint32(nb_vertices_), offset_);
+	ok = ok && write_value(file_, Numeric::uint32(dimension_), offset_);
+	ok = ok && write_value(file_, quantum_, offset_);
+	ok = ok && write_value(
+	    file_, Numeric::uint32(attributes_.size()), offset_
+	);
+	for(const AttributeInfo& info : attributes_) {
+	    ok = ok && write_value(file_, Numeric::uint32(info.type), offset_);
+	    ok = ok && write_value(
+		file_, Numeric::uint32(info.nb_doubles), offset_
+	    );
+	    ok = ok && write_value(
+		file_, Numeric::uint32(info.name.length()), offset_
+	    );
+	    ok = ok && write_bytes(
+		file_, info.name.c_str(), info.name.length(), offset_
+	    );
+	}
+	if(!ok) {
+	    Logger::err("TimeSeries")
+		<< filename << ": could not write header" << std::endl;
+	    fclose(file_);
+	    file_ = nullptr;
+	    return false;
+	}
+	return true;
+    }
+
+    bool TimeSeriesWriter::write_timestep(index_t timestep, const Mesh& M) {
+	if(!is_open()) {
+	    Logger::err("TimeSeries") << "No file is open" << std::endl;
+	    return false;
+	}
+	if(
+	    M.vertices.nb() != nb_vertices_ ||
+	    M.vertices.dimension() != dimension_
+	) {
+	    Logger::err("TimeSeries")
+		<< "Number of vertices or dimension changed" << std::endl;
+	    return false;
+	}
+
+	// frame_ is used by the background thread, wait for it
+	// before overwriting.
+	if(!wait()) {
+	    return false;
+	}
+
+	double* to = frame_.data();
+	if(nb_vertices_ != 0) {
+	    size_t nb_bytes = sizeof(double) * nb_vertices_ * dimension_;
+	    Memory::copy(to, M.vertices.point_ptr(0), nb_bytes);
+	    to += nb_vertices_ * dimension_;
+	}
+	for(const AttributeInfo& info : attributes_) {
+	    const AttributeStore* store =
+		M.vertices.attributes().find_attribute_store(info.name);
+	    index_t type;
+	    index_t nb_doubles;
+	    if(
+		store == nullptr ||
+		!get_attribute_type(store, type, nb_doubles) ||
+		type != info.type || nb_doubles != info.nb_doubles
+	    ) {
+		Logger::err("TimeSeries")
+		    << info.name << ": attribute was removed or changed"
+		    << std::endl;
+		return false;
+	    }
+	    size_t nb_bytes = sizeof(double) * nb_vertices_ * nb_doubles;
+	    Memory::copy(to, store->data(), nb_bytes);
+	    to += nb_vertices_ * nb_doubles;
+	}
+
+	thread_ = std::thread(
+	    [this, timestep]() {
+		encode_and_write(timestep);
+	    }
+	);
+	return true;
+    }
+
+    bool TimeSeriesWriter::wait() {
+	if(thread_.joinable()) {
+	    thread_.join();
+	}
+	if(error_) {
+	    Logger::err("TimeSeries")
+		<< filename_ << ": write error" << std::endl;
+	    return false;
+	}
+	return true;
+    }
+
+    void TimeSeriesWriter::encode_and_write(index_t timestep) {
+	bool quantize = (quantum_ != 0.0);
+	if(quantize) {
+	    for(double x : frame_) {
+		if(!(std::fabs(x / quantum_) < TS_QUANTIZE_MAX)) {
+		    quantize = false;
+		    break;
+		}
+	    }
+	}
+
+	index_t flags = 0;
+	const void* payload = frame_.data();
+	size_t payload_size = sizeof(double) * frame_.size();
+
+	if(quantize) {
+	    bool keyframe = (
+		!has_previous_ || nb_since_keyframe_ >= keyframe_interval_
+	    );
+	    flags = keyframe ? TS_QUANTIZED : (TS_QUANTIZED | TS_DELTA);
+	    buffer_.clear();
+	    for(size_t i=0; i<frame_.size(); ++i) {
+		Numeric::int64 q = Numeric::int64(
+		    std::llround(frame_[i] / quantum_)
+		);
+		encode_integer(buffer_, keyframe ? q : q - previous_[i]);
+		previous_[i] = q;
+	    }
+	    has_previous_ = true;
+	    nb_since_keyframe_ = keyframe ? 1 : nb_since_keyframe_ + 1;
+	    payload = buffer_.data();
+	    payload_size = buffer_.size();
+	} else {
+	    // Values that cannot be quantized are stored as is, and
+	    // the next timestep is a keyframe.
+	    has_previous_ = false;
+	}
+
+	IndexEntry entry;
+	entry.timestep = timestep;
+	entry.flags = flags;
+	entry.offset = offset_;
+
+	bool ok = write_value(file_, TS_CHUNK_MAGIC, offset_);
+	ok = ok && write_value(file_, Numeric::uint32(timestep), offset_);
+	ok = ok && write_value(file_, Numeric::uint32(flags), offset_);
+	ok = ok && write_value(
+	    file_, Numeric::uint64(payload_size), offset_
+	);
+	ok = ok && write_bytes(file_, payload, payload_size, offset_);
+	if(ok) {
+	    index_.push_back(entry);
+	} else {
+	    error_ = true;
+	}
+    }
+
+    bool TimeSeriesWriter::close() {
+	if(!is_open()) {
+	    return false;
+	}
+	bool ok = wait();
+
+	Numeric::uint64 index_offset = offset_;
+	ok = ok && write_value(file_, TS_INDEX_MAGIC, offset_);
+	ok = ok && write_value(
+	    file_, Numeric::uint32(index_.size()), offset_
+	);
+	for(const IndexEntry& entry : index_) {
+	    ok = ok && write_value(
+		file_, Numeric::uint32(entry.timestep), offset_
+	    );
+	    ok = ok && write_value(file_, Numeric::uint32(entry.flags), offset_);
+	    ok = ok && write_value(file_, entry.offset, offset_);
+	}
+	ok = ok && write_value(file_, index_offset, offset_);
+	ok = ok && write_bytes(file_, TS_END_MAGIC, 8, offset_);
+	ok = (fclose(file_) == 0) && ok;
+	file_ = nullptr;
+
+	if(!ok) {
+	    Logger::err("TimeSeries")
+		<< filename_ << ": could not write index" << std::endl;
+	    return false;
+	}
+
+	Logger::out("TimeSeries")
+	    << filename_ << ": " << index_.size() << " timestep(s), "
+	    << String::format("%.1f", double(offset_) / 1048576.0) << " MB"
+	    << std::endl;
+	return true;
+    }
+
+    /**************************************************************/
+
+    TimeSeriesReader::TimeSeriesReader() :
+	file_(nullptr),
+	nb_vertices_(0),
+	dimension_(0),
+	quantum_(0.0),
+	file_size_(0),
+	current_(NO_INDEX) {
+    }
+
+    TimeSeriesReader::~TimeSeriesReader() {
+	close();
+    }
+
+    void TimeSeriesReader::close() {
+	if(file_ != nullptr) {
+	    fclose(file_);
+	    file_ = nullptr;
+	}
+	attributes_.clear();
+	index_.clear();
+	frame_.clear();
+	previous_.clear();
+	current_ = NO_INDEX;
+    }
+
+    bool TimeSeriesReader::open(const std::string& filename) {
+	close();
+	file_ = fopen(filename.c_str(), "rb");
+	if(file_ == nullptr) {
+	    Logger::err("TimeSeries")
+		<< filename << ": could not open" << std::endl;
+	    return false;
+	}
+	filename_ = filename;
+
+	char magic[8];
+	Numeric::uint32 nb_vertices = 0;
+	Numeric::uint32 dimension = 0;
+	Numeric::uint32 nb_attributes = 0;
+	bool ok = (fread(magic, 1, 8, file_) == 8) &&
+	    (std::memcmp(magic, TS_MAGIC, 8) == 0);
+	ok = ok && read_value(file_, nb_vertices);
+	ok = ok && read_value(file_, dimension);
+	ok = ok && read_value(file_, quantum_);
+	ok = ok && read_value(file_, nb_attributes);
+	index_t nb_doubles = dimension;
+	for(index_t i=0; ok && i<nb_attributes; ++i) {
+	    Numeric::uint32 type = 0;
+	    Numeric::uint32 attribute_nb_doubles = 0;
+	    Numeric::uint32 length = 0;
+	    ok = ok && read_value(file_, type);
+	    ok = ok && read_value(file_, attribute_nb_doubles);
+	    ok = ok && read_value(file_, length) && (length < 1024);
+	    AttributeInfo info;
+	    if(ok) {
+		info.name.resize(length);
+		ok = (length == 0) ||
+		    (fread(&info.name[0], 1, length, file_) == length);
+	    }
+	    info.type = type;
+	    info.nb_doubles = attribute_nb_doubles;
+	    attributes_.push_back(info);
+	    nb_doubles += attribute_nb_doubles;
+	}
+	if(!ok) {
+	    Logger::err("TimeSeries")
+		<< filename << ": invalid header" << std::endl;
+	    close();
+	    return false;
+	}
+	nb_vertices_ = nb_vertices;
+	dimension_ = dimension;
+	Numeric::uint64 header_size = Numeric::uint64(ftell(file_));
+
+	frame_.assign(size_t(nb_vertices_) * size_t(nb_doubles), 0.0);
+	previous_.assign(frame_.size(), 0);
+
+	// Read the index if present, else reconstruct it.
+	file_size_ = file_size(file_);
+	bool has_index = false;
+	if(file_size_ >= header_size + 16) {
+	    Numeric::uint64 index_offset = 0;
+	    Numeric::uint32 index_magic = 0;
+	    Numeric::uint32 nb_entries = 0;
+	    has_index =
+		seek(file_, file_size_ - 16) &&
+		read_value(file_, index_offset) &&
+		(fread(magic, 1, 8, file_) == 8) &&
+		(std::memcmp(magic, TS_END_MAGIC, 8) == 0) &&
+		index_offset < file_size_ &&
+		seek(file_, index_offset) &&
+		read_value(file_, index_magic) &&
+		index_magic == TS_INDEX_MAGIC &&
+		read_value(file_, nb_entries) &&
+		Numeric::uint64(nb_entries) * 16 <= file_size_;
+	    for(index_t i=0; has_index && i<nb_entries; ++i) {
+		Numeric::uint32 timestep = 0;
+		Numeric::uint32 flags = 0;
+		IndexEntry entry;
+		has_index =
+		    read_value(file_, timestep) &&
+		    read_value(file_, flags) &&
+		    read_value(file_, entry.offset);
+		entry.timestep = timestep;
+		entry.flags = flags;
+		index_.push_back(entry);
+	    }
+	}
+	if(!has_index) {
+	    index_.clear();
+	    Logger::warn("TimeSeries")
+		<< filename << ": missing index, scanning timesteps"
+		<< std::endl;
+	    scan_chunks(header_size, file_size_);
+	}
+
+	Logger::out("TimeSeries")
+	    << filename << ": " << nb_timesteps() << " timestep(s)"
+	    << std::endl;
+	return true;
+    }
+
+    void TimeSeriesReader::scan_chunks(
+	Numeric::uint64 start, Numeric::uint64 file_size
+    ) {
+	Numeric::uint64 offset = start;
+	while(offset + TS_CHUNK_HEADER_SIZE <= file_size) {
+	    Numeric::uint32 magic = 0;
+	    Numeric::uint32 timestep = 0;
+	    Numeric::uint32 flags = 0;
+	    Numeric::uint64 size = 0;
+	    if(
+		!seek(file_, offset) ||
+		!read_value(file_, magic) || magic != TS_CHUNK_MAGIC ||
+		!read_value(file_, timestep) ||
+		!read_value(file_, flags) ||
+		!read_value(file_, size) ||
+		size > file_size - offset - TS_CHUNK_HEADER_SIZE
+	    ) {
+		break;
+	    }
+	    IndexEntry entry;
+	    entry.timestep = timestep;
+	    entry.flags = flags;
+	    entry.offset = offset;
+	    index_.push_back(entry);
+	    offset += TS_CHUNK_HEADER_SIZE + size;
+	}
+    }
+
+    index_t TimeSeriesReader::find_timestep(index_t timestep) const {
+	for(index_t i=0; i<nb_timesteps(); ++i) {
+	    if(index_[i].timestep == timestep) {
+		return i;
+	    }
+	}
+	return NO_INDEX;
+    }
+
+    bool TimeSeriesReader::decode(index_t i) {
+	const IndexEntry& entry = index_[i];
+	Numeric::uint32 magic = 0;
+	Numeric::uint32 timestep = 0;
+	Numeric::uint32 flags = 0;
+	Numeric::uint64 size = 0;
+	if(
+	    !seek(file_, entry.offset) ||
+	    !read_value(file_, magic) || magic != TS_CHUNK_MAGIC ||
+	    !read_value(file_, timestep) ||
+	    !read_value(file_, flags) ||
+	    !read_value(file_, size) ||
+	    size > file_size_
+	) {
+	    return false;
+	}
+
+	if((flags & TS_QUANTIZED) == 0) {
+	    return size == sizeof(double) * frame_.size() && (
+		frame_.size() == 0 ||
+		fread(frame_.data(), sizeof(double), frame_.size(), file_) ==
+		frame_.size()
+	    );
+	}
+
+	buffer_.resize(size_t(size));
+	if(size != 0 && fread(buffer_.data(), 1, size_t(size), file_) != size) {
+	    return false;
+	}
+	bool delta = ((flags & TS_DELTA) != 0);
+	const Numeric::uint8* p = buffer_.data();
+	const Numeric::uint8* end = p + buffer_.size();
+	for(size_t j=0; j<frame_.size(); ++j) {
+	    Numeric::int64 q;
+	    if(!decode_integer(p, end, q)) {
+		return false;
+	    }
+	    if(delta) {
+		q += previous_[j];
+	    }
+	    previous_[j] = q;
+	    frame_[j] = double(q) * quantum_;
+	}
+	return true;
+    }
+
+    bool TimeSeriesReader::read_timestep(index_t i, Mesh& M) {
+	if(file_ == nullptr || i >= nb_timesteps()) {
+	    Logger::err("TimeSeries") << "Invalid timestep" << std::endl;
+	    return false;
+	}
+
+	if(i != current_) {
+	    // Start from the last keyframe, or continue from the
+	    // current timestep if there is no keyframe in-between.
+	    index_t start = i;
+	    while(start > 0 && (index_[start].flags & TS_DELTA) != 0) {
+		--start;
+	    }
+	    if(current_ != NO_INDEX && current_ >= start && current_ < i) {
+		start = current_ + 1;
+	    }
+	    for(index_t j=start; j<=i; ++j) {
+		if(!decode(j)) {
+		    current_ = NO_INDEX;
+		    Logger::err("TimeSeries")
+			<< filename_ << ": invalid timestep " << j
+			<< std::endl;
+		    return false;
+		}
+	    }
+	    current_ = i;
+	}
+
+	if(
+	    M.vertices.nb() != nb_vertices_ ||
+	    M.vertices.dimension() != dimension_
+	) {
+	    M.clear();
+	    M.vertices.set_dimension(dimension_);
+	    M.vertices.create_vertices(nb_vertices_);
+	}
+
+	const double* from = frame_.data();
+	if(nb_vertices_ != 0) {
+	    Memory::copy(
+		M.vertices.point_ptr(0), from,
+		sizeof(double) * nb_vertices_ * dimension_
+	    );
+	    from += nb_vertices_ * dimension_;
+	}
+
+	for(const AttributeInfo& info : attributes_) {
+	    AttributesManager& attributes = M.vertices.attributes();
+	    if(!attributes.is_defined(info.name)) {
+		switch(info.type) {
+		    case TS_VEC2: {
+			Attribute<vec2> attr;
+			attr.create_vector_attribute(
+			    attributes, info.name, info.nb_doubles/2
+			);
+		    } break;
+		    case TS_VEC3: {
+			Attribute<vec3> attr;
+			attr.create_vector_attribute(
+			    attributes, info.name, info.nb_doubles/3
+			);
+		    } break;
+		    default: {
+			Attribute<double> attr;
+			attr.create_vector_attribute(
+			    attributes, info.name, info.nb_doubles
+			);
+		    } break;
+		}
+	    }
+	    AttributeStore* store = attributes.find_attribute_store(info.name);
+	    index_t type;
+	    index_t nb_doubles;
+	    if(
+		store == nullptr ||
+		!get_attribute_type(store, type, nb_doubles) ||
+		nb_doubles != info.nb_doubles
+	    ) {
+		Logger::err("TimeSeries")
+		    << info.name << ": existing attribute has incompatible type"
+		    << std::endl;
+		return false;
+	    }
+	    Memory::copy(
+		store->data(), from, sizeof(double) * nb_vertices_ * nb_doubles
+	    );
+	    from += nb_vertices_ * nb_doubles;
+	}
+	return true;
+    }
+}
@@ -0,0 +1,311 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_WARPDRIVE_IO_TIME_SERIES_H
+#define H_OGF_WARPDRIVE_IO_TIME_SERIES_H
+
+#include <OGF/WarpDrive/common/common.h>
+#include <geogram/mesh/mesh.h>
+
+#include <thread>
+#include <cstdio>
+
+/**
+ * \file OGF/WarpDrive/IO/time_series.h
+ * \brief Compact storage of the successive timesteps of a simulation.
+ * \details A time series file stores, for each saved timestep, the
+ *  vertices of a mesh and a chosen set of vertex attributes (the
+ *  number of vertices is constant). Each timestep is a chunk. Values
+ *  can be quantized, and then stored as variable-length differences
+ *  with the previous timestep, with a full (key) timestep at regular
+ *  intervals. An index at the end of the file allows seeking to any
+ *  timestep. Data is stored in the byte order of the machine.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief Writes the timesteps of a simulation to a time series file.
+     * \details Encoding and writing happen in a background thread, while
+     *  the simulation computes the next timestep.
+     */
+    class WarpDrive_API TimeSeriesWriter {
+    public:
+	/**
+	 * \brief TimeSeriesWriter constructor.
+	 */
+	TimeSeriesWriter();
+
+	/**
+	 * \brief TimeSeriesWriter destructor.
+	 * \details Closes the file if it is still open.
+	 */
+	~TimeSeriesWriter();
+
+	/**
+	 * \brief Forbids copy.
+	 */
+	TimeSeriesWriter(const TimeSeriesWriter&) = delete;
+
+	/**
+	 * \brief Forbids copy.
+	 */
+	TimeSeriesWriter& operator=(const TimeSeriesWriter&) = delete;
+
+	/**
+	 * \brief Creates a time series file.
+	 * \param[in] filename the name of the file
+	 * \param[in] M the mesh, used to determine the number of vertices,
+	 *  the dimension and the type of the attributes
+	 * \param[in] attributes semicolon-separated list of the vertex
+	 *  attributes to be saved. Supported types are double (with any
+	 *  dimension), vec2 and vec3.
+	 * \param[in] quantum if non-zero, values are rounded to a multiple
+	 *  of \p quantum and stored as differences with the previous
+	 *  timestep, else they are stored as is.
+	 * \param[in] keyframe_interval in quantized mode, a timestep is
+	 *  stored without differences every \p keyframe_interval timesteps.
+	 *  It bounds the number of timesteps decoded when seeking.
+	 * \retval true on success
+	 * \retval false otherwise (and an error message is displayed)
+	 */
+	bool open(
+	    const std::string& filename, const Mesh& M,
+	    const std::string& attributes,
+	    double quantum = 0.0, index_t keyframe_interval = 32
+	);
+
+	/**
+	 * \brief Tests whether a file is open.
+	 * \retval true if a file is open
+	 * \retval false otherwise
+	 */
+	bool is_open() const {
+	    return file_ != nullptr;
+	}
+
+	/**
+	 * \brief Saves a timestep.
+	 * \details The vertices and attributes of \p M are copied, then
+	 *  written in a background thread. \p M can be modified as soon as
+	 *  this function returns.
+	 * \param[in] timestep the number of the timestep, stored in the file
+	 * \param[in] M the mesh, with the same number of vertices as in open()
+	 * \retval true on success
+	 * \retval false otherwise (and an error message is displayed)
+	 */
+	bool write_timestep(index_t timestep, const Mesh& M);
+
+	/**
+	 * \brief Waits for the pending timestep, writes the index and
+	 *  closes the file.
+	 * \retval true if all the timesteps were successfully written
+	 * \retval false otherwise
+	 */
+	bool close();
+
+    protected:
+	/**
+	 * \brief Waits until the background thread is finished.
+	 * \retval true if no error occured
+	 * \retval false otherwise
+	 */
+	bool wait();
+
+	/**
+	 * \brief Encodes frame_ and appends it to the file.
+	 * \details Called from the background thread.
+	 * \param[in] timestep the number of the timestep
+	 */
+	void encode_and_write(index_t timestep);
+
+    private:
+	struct AttributeInfo {
+	    std::string name;
+	    index_t type;
+	    index_t nb_doubles;
+	};
+
+	struct IndexEntry {
+	    index_t timestep;
+	    index_t flags;
+	    Numeric::uint64 offset;
+	};
+
+	std::string filename_;
+	FILE* file_;
+	index_t nb_vertices_;
+	index_t dimension_;
+	double quantum_;
+	index_t keyframe_interval_;
+	std::vector<AttributeInfo> attributes_;
+	std::vector<double> frame_;
+	std::vector<Numeric::int64> previous_;
+	bool has_previous_;
+	index_t nb_since_keyframe_;
+	std::vector<Numeric::uint8> buffer_;
+	std::vector<IndexEntry> index_;
+	Numeric::uint64 offset_;
+	std::thread thread_;
+	bool error_;
+    };
+
+    /**
+     * \brief Reads the timesteps of a time series file written by
+     *  TimeSeriesWriter.
+     */
+    class WarpDrive_API TimeSeriesReader {
+    public:
+	/**
+	 * \brief TimeSeriesReader constructor.
+	 */
+	TimeSeriesReader();
+
+	/**
+	 * \brief TimeSeriesReader destructor.
+	 */
+	~TimeSeriesReader();
+
+	/**
+	 * \brief Forbids copy.
+	 */
+	TimeSeriesReader(const TimeSeriesReader&) = delete;
+
+	/**
+	 * \brief Forbids copy.
+	 */
+	TimeSeriesReader& operator=(const TimeSeriesReader&) = delete;
+
+	/**
+	 * \brief Opens a time series file.
+	 * \details If the index is missing (for instance, if the simulation
+	 *  was interrupted), it is reconstructed from the chunks.
+	 * \param[in] filename the name of the file
+	 * \retval true on success
+	 * \retval false otherwise (and an error message is displayed)
+	 */
+	bool open(const std::string& filename);
+
+	/**
+	 * \brief Closes the file.
+	 */
+	void close();
+
+	/**
+	 * \brief Gets the number of stored timesteps.
+	 * \return the number of stored timesteps
+	 */
+	index_t nb_timesteps() const {
+	    return index_t(index_.size());
+	}
+
+	/**
+	 * \brief Gets the number of a stored timestep.
+	 * \param[in] i the index of the timestep in the file,
+	 *  in 0 .. nb_timesteps()-1
+	 * \return the number of the timestep, as passed to
+	 *  TimeSeriesWriter::write_timestep()
+	 */
+	index_t timestep(index_t i) const {
+	    geo_debug_assert(i < nb_timesteps());
+	    return index_[i].timestep;
+	}
+
+	/**
+	 * \brief Finds a timestep by its number.
+	 * \param[in] timestep the number of the timestep
+	 * \return the index of the timestep in the file, or NO_INDEX
+	 *  if there is no such timestep
+	 */
+	index_t find_timestep(index_t timestep) const;
+
+	/**
+	 * \brief Reads a timestep into a mesh.
+	 * \details Vertices are created if needed, and attributes are
+	 *  created if they do not exist. Reading consecutive timesteps
+	 *  only decodes each of them once.
+	 * \param[in] i the index of the timestep in the file,
+	 *  in 0 .. nb_timesteps()-1
+	 * \param[in,out] M the mesh
+	 * \retval true on success
+	 * \retval false otherwise (and an error message is displayed)
+	 */
+	bool read_timestep(index_t i, Mesh& M);
+
+    protected:
+	/**
+	 * \brief Decodes a chunk into frame_.
+	 * \param[in] i the index of the timestep in the file
+	 * \retval true on success
+	 * \retval false otherwise
+	 */
+	bool decode(index_t i);
+
+	/**
+	 * \brief Reconstructs the index by traversing the chunks.
+	 * \details Stops at the first incomplete chunk.
+	 * \param[in] start offset of the first chunk
+	 * \param[in] file_size size of the file, in bytes
+	 */
+	void scan_chunks(Numeric::uint64 start, Numeric::uint64 file_size);
+
+    private:
+	struct AttributeInfo {
+	    std::string name;
+	    index_t type;
+	    index_t nb_doubles;
+	};
+
+	struct IndexEntry {
+	    index_t timestep;
+	    index_t flags;
+	    Numeric::uint64 offset;
+	};
+
+	std::string filename_;
+	FILE* file_;
+	index_t nb_vertices_;
+	index_t dimension_;
+	double quantum_;
+	std::vector<AttributeInfo> attributes_;
+	Numeric::uint64 file_size_;
+	std::vector<IndexEntry> index_;
+	std::vector<double> frame_;
+	std::vector<Numeric::int64> previous_;
+	index_t current_;
+	std::vector<Numeric::uint8> buffer_;
+    };
+}
+
+#endif
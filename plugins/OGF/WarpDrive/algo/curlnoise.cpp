@@ -34,6 +34,26 @@
  */
  
 #include <OGF/WarpDrive/algo/curlnoise.h>
+#include <geogram/basic/process.h>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The potential is attenuated with the distance to
+     *  CURL_NOISE_CENTRE, and vanishes beyond CURL_NOISE_RADIUS.
+     */
+    const vec3 CURL_NOISE_CENTRE(0.0, 1.0, 0.0);
+    const double CURL_NOISE_RADIUS = 4.0;
+
+    /**
+     * \brief Derivative of the fade function used by
+     *  CurlNoiseVelocityField::calc(), f^3*(10-f*(15-f*6)).
+     */
+    inline double dfade(double f) {
+	return 30.0*f*f*(f-1.0)*(f-1.0);
+    }
+}
 
 namespace OGF {
 
@@ -44,6 +64,16 @@ namespace OGF {
 	double current_time, const vec3& vertex, vec3 &velocity
     ) const {
 	geo_argused(current_time);
+
+	if(lattice_.size() != 0) {
+	    velocity = lattice_velocity(vertex);
+	    return;
+	}
+
+	if(analytic_gradient_) {
+	    velocity = analytic_velocity(vertex);
+	    return;
+	}
 	
 	double x = vertex.x ;
 	double y = vertex.y ;
@@ -67,6 +97,51 @@ namespace OGF {
 	    
 	    );
         }
+
+    void CurlNoiseVelocityField::get_velocities(
+	double current_time, index_t nb_points,
+	const vec3* points, vec3* velocities
+    ) const {
+	geo_argused(current_time);
+
+	if(lattice_.size() != 0) {
+	    for(index_t i=0; i<nb_points; ++i) {
+		velocities[i] = lattice_velocity(points[i]);
+	    }
+	    return;
+	}
+
+	if(analytic_gradient_) {
+	    for(index_t i=0; i<nb_points; ++i) {
+		velocities[i] = analytic_velocity(points[i]);
+	    }
+	    return;
+	}
+
+	for(index_t i=0; i<nb_points; ++i) {
+	    double x = points[i].x;
+	    double y = points[i].y;
+	    double z = points[i].z;
+
+	    // get_velocity() evaluates the potential twice at each of the
+	    // six finite-difference samples, evaluate it only once here.
+	    vec3 px_plus  = potential(x+delta_x, y, z);
+	    vec3 px_minus = potential(x-delta_x, y, z);
+	    vec3 py_plus  = potential(x, y+delta_x, z);
+	    vec3 py_minus = potential(x, y-delta_x, z);
+	    vec3 pz_plus  = potential(x, y, z+delta_x);
+	    vec3 pz_minus = potential(x, y, z-delta_x);
+
+	    velocities[i] = vec3(
+		((py_plus.z - py_minus.z) - (pz_plus.y - pz_minus.y))
+		/ (2*delta_x),
+		((pz_plus.x - pz_minus.x) - (px_plus.z - px_minus.z))
+		/ (2*delta_x),
+		((px_plus.y - px_minus.y) - (py_plus.x - py_minus.x))
+		/ (2*delta_x)
+	    );
+	}
+    }
         
         vec3 CurlNoiseVelocityField::potential(
 	    double x, double y , double z
@@ -74,8 +149,8 @@ namespace OGF {
 	    vec3 psi(0,0,0);
 	    double height_factor=0.5;
 	    
-	    static const vec3 centre( 0.0, 1.0, 0.0 );
-	    static double radius = 4.0;
+	    const vec3& centre = CURL_NOISE_CENTRE;
+	    double radius = CURL_NOISE_RADIUS;
 	    
 	    for(unsigned int i=0; i<noise_lengthscale.size(); ++i) {
 		double sx=x/noise_lengthscale[i];
@@ -95,6 +170,193 @@ namespace OGF {
 	    return psi;
 	}
 
+    vec3 CurlNoiseVelocityField::analytic_velocity(const vec3& p) const {
+	// The potential is psi = (0, 0, phi), with
+	// phi = scale * sum_i height_factor * noise_gain[i] * noise_i,
+	// hence curl(psi) = (d phi / dy, -d phi / dx, 0).
+	double height_factor=0.5;
+	vec3 d = p - CURL_NOISE_CENTRE;
+	double dist = length(d);
+	if(dist >= CURL_NOISE_RADIUS) {
+	    return vec3(0.0, 0.0, 0.0);
+	}
+	double scale = (CURL_NOISE_RADIUS - dist) / CURL_NOISE_RADIUS;
+	vec3 grad_scale(0.0, 0.0, 0.0);
+	if(dist != 0.0) {
+	    grad_scale = (-1.0 / (dist * CURL_NOISE_RADIUS)) * d;
+	}
+
+	double noise = 0.0;
+	vec3 grad_noise(0.0, 0.0, 0.0);
+	for(unsigned int i=0; i<noise_lengthscale.size(); ++i) {
+	    double L = noise_lengthscale[i];
+	    double w = height_factor*noise_gain[i];
+	    // noise2(x,y,z) = calc(z-203.994, x+169.47, y-205.31)
+	    vec3 g;
+	    double value = calc_with_gradient(
+		p.z/L - 203.994, p.x/L + 169.47, p.y/L - 205.31, g
+	    );
+	    noise += w*value;
+	    grad_noise += (w/L) * vec3(g.y, g.z, g.x);
+	}
+
+	vec3 grad_phi = noise * grad_scale + scale * grad_noise;
+	return vec3(grad_phi.y, -grad_phi.x, 0.0);
+    }
+
+    double CurlNoiseVelocityField::calc_with_gradient(
+	double x, double y, double z, vec3& grad
+    ) const {
+	double floorx=std::floor(x), floory=std::floor(y), floorz=std::floor(z);
+
+	// Same lookups as hash_index(), with the common prefixes of the
+	// eight corners computed once and the modulos folded in perm2_.
+	unsigned int i = (unsigned int)(int)floorx % n;
+	unsigned int j = (unsigned int)(int)floory % n;
+	unsigned int k = (unsigned int)(int)floorz % n;
+	unsigned int h0  = perm2_[i];
+	unsigned int h1  = perm2_[i+1];
+	unsigned int h00 = perm2_[h0+j];
+	unsigned int h01 = perm2_[h0+j+1];
+	unsigned int h10 = perm2_[h1+j];
+	unsigned int h11 = perm2_[h1+j+1];
+	const vec3 &n000=basis[perm2_[h00+k]];
+	const vec3 &n100=basis[perm2_[h10+k]];
+	const vec3 &n010=basis[perm2_[h01+k]];
+	const vec3 &n110=basis[perm2_[h11+k]];
+	const vec3 &n001=basis[perm2_[h00+k+1]];
+	const vec3 &n101=basis[perm2_[h10+k+1]];
+	const vec3 &n011=basis[perm2_[h01+k+1]];
+	const vec3 &n111=basis[perm2_[h11+k+1]];
+
+	double fx=x-floorx, fy=y-floory, fz=z-floorz;
+	double sx=fx*fx*fx*(10-fx*(15-fx*6));
+	double sy=fy*fy*fy*(10-fy*(15-fy*6));
+	double sz=fz*fz*fz*(10-fz*(15-fz*6));
+
+	double g000 =     fx*n000.x +     fy*n000.y +     fz*n000.z;
+	double g100 = (fx-1)*n100.x +     fy*n100.y +     fz*n100.z;
+	double g010 =     fx*n010.x + (fy-1)*n010.y +     fz*n010.z;
+	double g110 = (fx-1)*n110.x + (fy-1)*n110.y +     fz*n110.z;
+	double g001 =     fx*n001.x +     fy*n001.y + (fz-1)*n001.z;
+	double g101 = (fx-1)*n101.x +     fy*n101.y + (fz-1)*n101.z;
+	double g011 =     fx*n011.x + (fy-1)*n011.y + (fz-1)*n011.z;
+	double g111 = (fx-1)*n111.x + (fy-1)*n111.y + (fz-1)*n111.z;
+
+	// Derivative of the trilinear interpolation: interpolated
+	// derivatives of the corner functions, plus the derivative of
+	// the fade function times the difference along the axis.
+	grad.x =
+	    trilerp(
+		n000.x, n100.x, n010.x, n110.x,
+		n001.x, n101.x, n011.x, n111.x,
+		sx, sy, sz
+	    ) + dfade(fx) * bilerp(
+		g100-g000, g110-g010, g101-g001, g111-g011, sy, sz
+	    );
+	grad.y =
+	    trilerp(
+		n000.y, n100.y, n010.y, n110.y,
+		n001.y, n101.y, n011.y, n111.y,
+		sx, sy, sz
+	    ) + dfade(fy) * bilerp(
+		g010-g000, g110-g100, g011-g001, g111-g101, sx, sz
+	    );
+	grad.z =
+	    trilerp(
+		n000.z, n100.z, n010.z, n110.z,
+		n001.z, n101.z, n011.z, n111.z,
+		sx, sy, sz
+	    ) + dfade(fz) * bilerp(
+		g001-g000, g101-g100, g011-g010, g111-g110, sx, sy
+	    );
+
+	return trilerp(
+	    g000, g100, g010, g110, g001, g101, g011, g111, sx, sy, sz
+	);
+    }
+
+    void CurlNoiseVelocityField::create_lattice(index_t resolution) {
+	geo_assert(resolution > 0);
+	clear_lattice();
+	vec3 origin = CURL_NOISE_CENTRE - vec3(
+	    CURL_NOISE_RADIUS, CURL_NOISE_RADIUS, CURL_NOISE_RADIUS
+	);
+	double cell_size = 2.0 * CURL_NOISE_RADIUS / double(resolution);
+	index_t N = resolution+1;
+	std::vector<Numeric::float32> lattice(
+	    3*size_t(N)*size_t(N)*size_t(N)
+	);
+	// Lattice is cleared, get_velocity() evaluates the field.
+	parallel_for(
+	    0, N,
+	    [this,&lattice,origin,cell_size,N](index_t k) {
+		for(index_t j=0; j<N; ++j) {
+		    for(index_t i=0; i<N; ++i) {
+			vec3 p = origin + cell_size * vec3(
+			    double(i), double(j), double(k)
+			);
+			vec3 V;
+			get_velocity(0.0, p, V);
+			size_t idx = 3*((size_t(k)*N + j)*N + i);
+			lattice[idx]   = Numeric::float32(V.x);
+			lattice[idx+1] = Numeric::float32(V.y);
+			lattice[idx+2] = Numeric::float32(V.z);
+		    }
+		}
+	    }
+	);
+	lattice_.swap(lattice);
+	lattice_resolution_ = resolution;
+	lattice_origin_ = origin;
+	lattice_cell_size_ = cell_size;
+    }
+
+    void CurlNoiseVelocityField::clear_lattice() {
+	lattice_.clear();
+	lattice_resolution_ = 0;
+	lattice_cell_size_ = 0.0;
+    }
+
+    vec3 CurlNoiseVelocityField::lattice_velocity(const vec3& p) const {
+	double u = (p.x - lattice_origin_.x) / lattice_cell_size_;
+	double v = (p.y - lattice_origin_.y) / lattice_cell_size_;
+	double w = (p.z - lattice_origin_.z) / lattice_cell_size_;
+	double R = double(lattice_resolution_);
+	// The lattice encloses the ball outside of which the
+	// field vanishes.
+	if(
+	    !(u >= 0.0 && u <= R) ||
+	    !(v >= 0.0 && v <= R) ||
+	    !(w >= 0.0 && w <= R)
+	) {
+	    return vec3(0.0, 0.0, 0.0);
+	}
+	index_t i = std::min(index_t(u), lattice_resolution_-1);
+	index_t j = std::min(index_t(v), lattice_resolution_-1);
+	index_t k = std::min(index_t(w), lattice_resolution_-1);
+	double fx = u - double(i);
+	double fy = v - double(j);
+	double fz = w - double(k);
+	size_t N  = size_t(lattice_resolution_)+1;
+	size_t dx = 3;
+	size_t dy = 3*N;
+	size_t dz = 3*N*N;
+	const Numeric::float32* c =
+	    lattice_.data() + 3*((size_t(k)*N + j)*N + i);
+	vec3 result;
+	for(index_t coord=0; coord<3; ++coord) {
+	    result[coord] = trilerp(
+		double(c[coord]),       double(c[coord+dx]),
+		double(c[coord+dy]),    double(c[coord+dx+dy]),
+		double(c[coord+dz]),    double(c[coord+dx+dz]),
+		double(c[coord+dy+dz]), double(c[coord+dx+dy+dz]),
+		fx, fy, fz
+	    );
+	}
+	return result;
+    }
+
     void CurlNoiseVelocityField::flow_noise3(
 	unsigned int seed, double spin_variation
     ) {
@@ -123,6 +385,9 @@ namespace OGF {
 	    unsigned int j=randhash(seed++)%(i+1);
 	    std::swap(perm[i], perm[j]);
 	}
+	for(unsigned int i=0; i<2*n; ++i) {
+	    perm2_[i] = perm[i%n];
+	}
     }
 
     double CurlNoiseVelocityField::calc(double x, double y, double z) const {
@@ -155,6 +420,7 @@ namespace OGF {
 
     void CurlNoiseVelocityField::set_time(double t) {
 	t_ = t;
+	clear_lattice();
 	for(unsigned int i=0; i<n; ++i){
 	    double theta=spin_rate[i]*t;
 	    double c=std::cos(theta), s=std::sin(theta);
@@ -60,6 +60,31 @@ namespace OGF {
 	// l'animation (pour revenir au point de départ...)
 	velocity *= sin(M_PI * current_time * 2 / get_period()) ;    
     }
+
+    void EnrightVelocityField::get_velocities(
+	double current_time, index_t nb_points,
+	const vec3* points, vec3* velocities
+    ) const {
+	// Same expressions as in get_velocity(), evaluated in the same
+	// order (so that results are identical), but the time modulation
+	// is computed once and each sine once per point.
+	double modulation = sin(M_PI * current_time * 2 / get_period());
+	for(index_t i=0; i<nb_points; ++i) {
+	    double sx  = sin(M_PI*points[i].x);
+	    double sy  = sin(M_PI*points[i].y);
+	    double sz  = sin(M_PI*points[i].z);
+	    double s2x = sin(2.0*M_PI*points[i].x);
+	    double s2y = sin(2.0*M_PI*points[i].y);
+	    double s2z = sin(2.0*M_PI*points[i].z);
+	    vec3 velocity(
+		2.0 * sx * sx * s2y * s2z,
+		-s2x * sy * sy * s2z,
+		-s2x * s2y * sz * sz
+	    );
+	    velocity *= modulation;
+	    velocities[i] = velocity;
+	}
+    }
     
     
 }
@@ -63,6 +63,11 @@ namespace OGF {
 	void get_velocity(
 	    double current_time, const vec3& vertex, vec3 &velocity
 	) const override;
+
+	void get_velocities(
+	    double current_time, index_t nb_points,
+	    const vec3* points, vec3* velocities
+	) const override;
 	
 	void set_period(double p) {
 	    period_ = p;
@@ -32,6 +32,7 @@
 
 #include <OGF/WarpDrive/algo/time_integrator.h>
 #include <OGF/WarpDrive/algo/velocity_field.h>
+#include <geogram/basic/process.h>
 
 namespace {
     using namespace OGF;
@@ -81,6 +82,118 @@ namespace {
 	k4 = delta_t * veloc_tmp;
 	veloc = (1./6. * ( k1 + k4 ) + 1./3. * ( k2 + k3 ) ) / delta_t ;
     }
+
+    /**
+     * \brief Number of points processed together by advect_points().
+     */
+    const index_t ADVECT_BLOCK_SIZE = 256;
+
+    /**
+     * \brief Number of temporary vectors per point used by the batch
+     *  time integration schemes.
+     */
+    const index_t NB_TMP_PER_POINT = 5;
+
+    /**
+     * \brief Batch version of compute_Runge_Kutta_2().
+     * \details Uses the same expressions in the same order.
+     * \param[in] tmp scratch space for 2*nb vectors, provided by the
+     *  caller so that it can be reused from one batch to the next
+     */
+    void compute_Runge_Kutta_2(
+	double current_time, double delta_t,
+	index_t nb, const vec3* vertex, vec3* veloc,
+	const VelocityField* m_veloc, vec3* tmp
+    ) {
+	vec3* velocity_tmp = tmp;
+	vec3* vertex_tmp = tmp + nb;
+	m_veloc->get_velocities(current_time, nb, vertex, velocity_tmp);
+	for(index_t i=0; i<nb; ++i) {
+	    vertex_tmp[i] = vertex[i] + velocity_tmp[i] * delta_t;
+	}
+	m_veloc->get_velocities(
+	    current_time+delta_t/2, nb, vertex_tmp, veloc
+	);
+    }
+
+    /**
+     * \brief Batch version of compute_Runge_Kutta_4().
+     * \details Uses the same expressions in the same order.
+     * \param[in] tmp scratch space for 5*nb vectors, provided by the
+     *  caller so that it can be reused from one batch to the next
+     */
+    void compute_Runge_Kutta_4(
+	double current_time, double delta_t,
+	index_t nb, const vec3* vertex, vec3* veloc,
+	const VelocityField* m_veloc, vec3* tmp
+    ) {
+	vec3* veloc_tmp = tmp;
+	vec3* vertex_tmp = tmp + nb;
+	vec3* k1 = tmp + 2*nb;
+	vec3* k2 = tmp + 3*nb;
+	vec3* k3 = tmp + 4*nb;
+
+	m_veloc->get_velocities(current_time, nb, vertex, veloc_tmp);
+	for(index_t i=0; i<nb; ++i) {
+	    k1[i] = delta_t * veloc_tmp[i];
+	    vertex_tmp[i] = vertex[i] + 0.5 * k1[i];
+	}
+
+	m_veloc->get_velocities(
+	    current_time + 0.5*delta_t, nb, vertex_tmp, veloc_tmp
+	);
+	for(index_t i=0; i<nb; ++i) {
+	    k2[i] = delta_t * veloc_tmp[i];
+	    vertex_tmp[i] = vertex[i] + 0.5 * k2[i];
+	}
+
+	m_veloc->get_velocities(
+	    current_time + 0.5*delta_t, nb, vertex_tmp, veloc_tmp
+	);
+	for(index_t i=0; i<nb; ++i) {
+	    k3[i] = delta_t * veloc_tmp[i];
+	    vertex_tmp[i] = vertex[i] + k3[i];
+	}
+
+	m_veloc->get_velocities(
+	    current_time + delta_t, nb, vertex_tmp, veloc_tmp
+	);
+	for(index_t i=0; i<nb; ++i) {
+	    vec3 k4 = delta_t * veloc_tmp[i];
+	    veloc[i] = (1./6. * ( k1[i] + k4 ) + 1./3. * ( k2[i] + k3[i] ) )
+		/ delta_t ;
+	}
+    }
+
+    /**
+     * \brief Batch time integration, with scratch space provided by the
+     *  caller.
+     * \param[in] tmp scratch space for NB_TMP_PER_POINT*nb_points vectors
+     * \see OGF::time_integrator()
+     */
+    void time_integrator_with_scratch(
+	double current_time, double delta_t,
+	index_t nb_points, const vec3* vertices, vec3* veloc,
+	time_integrator_t algo, const VelocityField* m_veloc, vec3* tmp
+    ) {
+	switch(algo) {
+	    case RUNGE_KUTTA_2 :
+		compute_Runge_Kutta_2(
+		    current_time, delta_t, nb_points, vertices, veloc,
+		    m_veloc, tmp
+		);
+		break;
+	    case RUNGE_KUTTA_4 :
+		compute_Runge_Kutta_4(
+		    current_time, delta_t, nb_points, vertices, veloc,
+		    m_veloc, tmp
+		);
+		break;
+	    case SIMPLE :
+		m_veloc->get_velocities(current_time, nb_points, vertices, veloc);
+		break;
+	}
+    }
 }
 
 namespace OGF {
@@ -105,4 +218,55 @@ namespace OGF {
 		break;
 	}
     }
+
+    void time_integrator(
+	double current_time, double delta_t,
+	index_t nb_points, const vec3* vertices, vec3* veloc,
+	time_integrator_t algo, const VelocityField* m_veloc
+    ) {
+	std::vector<vec3> tmp;
+	if(algo != SIMPLE) {
+	    tmp.resize(size_t(NB_TMP_PER_POINT) * size_t(nb_points));
+	}
+	time_integrator_with_scratch(
+	    current_time, delta_t, nb_points, vertices, veloc,
+	    algo, m_veloc, tmp.data()
+	);
+    }
+
+    void advect_points(
+	double current_time, double delta_t,
+	index_t nb_points, double* points, index_t stride,
+	time_integrator_t algo, const VelocityField* m_veloc
+    ) {
+	geo_assert(stride >= 3);
+	parallel_for_slice(
+	    0, nb_points,
+	    [=](index_t from, index_t to) {
+		// Scratch space is allocated once per thread, and
+		// reused for all the blocks.
+		vec3 X[ADVECT_BLOCK_SIZE];
+		vec3 V[ADVECT_BLOCK_SIZE];
+		std::vector<vec3> tmp(
+		    algo == SIMPLE ? 0 : NB_TMP_PER_POINT*ADVECT_BLOCK_SIZE
+		);
+		for(index_t b=from; b<to; b+=ADVECT_BLOCK_SIZE) {
+		    index_t nb = std::min(ADVECT_BLOCK_SIZE, to-b);
+		    for(index_t i=0; i<nb; ++i) {
+			X[i] = vec3(points + size_t(stride)*size_t(b+i));
+		    }
+		    time_integrator_with_scratch(
+			current_time, delta_t, nb, X, V, algo, m_veloc,
+			tmp.data()
+		    );
+		    for(index_t i=0; i<nb; ++i) {
+			double* p = points + size_t(stride)*size_t(b+i);
+			p[0] += delta_t * V[i].x;
+			p[1] += delta_t * V[i].y;
+			p[2] += delta_t * V[i].z;
+		    }
+		}
+	    }
+	);
+    }
 }
@@ -56,6 +56,46 @@ namespace OGF {
 	time_integrator_t algo, const VelocityField* m_veloc
     );
 
+    /**
+     * \brief Computes the velocities of a batch of points with the
+     *  specified algorithm and the specified velocity driver.
+     * \details Gives the same results as calling the per-point
+     *  version for each point, but queries the velocity field by
+     *  batches through VelocityField::get_velocities().
+     * \param[in] current_time the time
+     * \param[in] delta_t the timestep
+     * \param[in] nb_points number of points
+     * \param[in] vertices a pointer to the \p nb_points points
+     * \param[out] veloc a pointer to the \p nb_points velocities
+     * \param[in] algo the time integration scheme
+     * \param[in] m_veloc the velocity field
+     */
+    void WarpDrive_API time_integrator(
+	double current_time, double delta_t,
+	index_t nb_points, const vec3* vertices, vec3* veloc,
+	time_integrator_t algo, const VelocityField* m_veloc
+    );
+
+    /**
+     * \brief Moves a set of points by one timestep in a velocity field.
+     * \details Points are processed in parallel, by blocks. Each point
+     *  p is replaced with p + delta_t * V, where V is the velocity
+     *  computed by time_integrator().
+     * \param[in] current_time the time
+     * \param[in] delta_t the timestep
+     * \param[in] nb_points number of points
+     * \param[in,out] points a pointer to the coordinates of the points
+     * \param[in] stride number of doubles between two consecutive points,
+     *  the first three are the coordinates
+     * \param[in] algo the time integration scheme
+     * \param[in] m_veloc the velocity field
+     */
+    void WarpDrive_API advect_points(
+	double current_time, double delta_t,
+	index_t nb_points, double* points, index_t stride,
+	time_integrator_t algo, const VelocityField* m_veloc
+    );
+
 }
 
 #endif
@@ -50,6 +50,15 @@ namespace OGF {
 	veloc = vec3(1,0,0) ;
     }
 
+    void VelocityField::get_velocities(
+	double current_time, index_t nb_points,
+	const vec3* points, vec3* velocities
+    ) const {
+	for(index_t i=0; i<nb_points; ++i) {
+	    get_velocity(current_time, points[i], velocities[i]);
+	}
+    }
+
     VelocityField* VelocityField::create(velocity_field_t type) {
 	VelocityField* result = nullptr;
 	switch(type) {
@@ -62,6 +71,17 @@ namespace OGF {
 	    case CURLNOISE:
 		result = new CurlNoiseVelocityField();
 		break;
+	    case CURLNOISE_ANALYTIC: {
+		CurlNoiseVelocityField* curlnoise = new CurlNoiseVelocityField();
+		curlnoise->set_analytic_gradient(true);
+		result = curlnoise;
+	    } break;
+	    case CURLNOISE_LATTICE: {
+		CurlNoiseVelocityField* curlnoise = new CurlNoiseVelocityField();
+		curlnoise->set_analytic_gradient(true);
+		curlnoise->create_lattice(128);
+		result = curlnoise;
+	    } break;
 	}
 	return result;
     }
@@ -42,7 +42,7 @@
 namespace OGF {
 
     enum velocity_field_t {
-	ENRIGHT, ZALESAK, CURLNOISE
+	ENRIGHT, ZALESAK, CURLNOISE, CURLNOISE_ANALYTIC, CURLNOISE_LATTICE
     };
 
     /**
@@ -58,6 +58,24 @@ namespace OGF {
 	    double current_time, const vec3& vertex, vec3 &veloc
 	) const;
 
+	/**
+	 * \brief Computes the velocities at a batch of points.
+	 * \details The default implementation calls get_velocity() for
+	 *  each point. Derived classes can override it to factor the
+	 *  computations that do not depend on the point. Overrides need
+	 *  to give the same results as get_velocity(), bit for bit.
+	 *  It may be called concurrently from several threads.
+	 * \param[in] current_time the time
+	 * \param[in] nb_points number of points
+	 * \param[in] points a pointer to the \p nb_points points
+	 * \param[out] velocities a pointer to the \p nb_points computed
+	 *  velocities
+	 */
+	virtual void get_velocities(
+	    double current_time, index_t nb_points,
+	    const vec3* points, vec3* velocities
+	) const;
+
 	static VelocityField* create(velocity_field_t type);
     };
 
@@ -65,5 +65,19 @@ namespace OGF {
 	) ;
     }
 
+    void ZalesakVelocityField::get_velocities(
+	double current_time, index_t nb_points,
+	const vec3* points, vec3* velocities
+    ) const {
+	geo_argused(current_time);
+	for(index_t i=0; i<nb_points; ++i) {
+	    velocities[i] = vec3(
+		(M_PI/314.0)*(0.5-points[i].y),
+		(M_PI/314.0)*(points[i].x-0.5),
+		0.0
+	    );
+	}
+    }
+
 }
 
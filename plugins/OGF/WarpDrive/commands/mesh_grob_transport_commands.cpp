@@ -42,6 +42,7 @@
 
 #include <OGF/WarpDrive/commands/mesh_grob_transport_commands.h>
 #include <OGF/WarpDrive/algo/VSDM.h>
+#include <OGF/WarpDrive/IO/time_series.h>
 
 #define READ_HYDRA_LIB_ONLY
 #include <OGF/WarpDrive/IO/read_hydra.h>
@@ -72,6 +73,9 @@
 #include <geogram/basic/progress.h>
 #include <geogram/basic/permutation.h>
 #include <geogram/basic/line_stream.h>
+#include <geogram/mesh/mesh_io.h>
+
+#include <thread>
 
 // We got some classes declared locally that
 // have no out-of-line virtual functions. It is not a
@@ -124,6 +128,25 @@ namespace {
             }
         }
     }
+
+    /**
+     * \brief Displays the time spent in the optimal transport solver
+     *  by an Euler simulation.
+     * \param[in] nb_timesteps number of timesteps
+     * \param[in] total_time total time spent in the solver, in seconds
+     */
+    void log_optimal_transport_timings(
+	index_t nb_timesteps, double total_time
+    ) {
+	if(nb_timesteps == 0) {
+	    return;
+	}
+	Logger::out("Euler")
+	    << "Optimal transport: " << total_time << "s for "
+	    << nb_timesteps << " timestep(s), "
+	    << total_time / double(nb_timesteps) << "s per timestep"
+	    << std::endl;
+    }
 }
 
 namespace OGF {
@@ -667,12 +690,13 @@ namespace OGF {
 		}
 	    }
         } else {
-	    MeshCellsAABB AABB(*mesh_grob());
+	    std::shared_ptr<const MeshCellsAABB> AABB =
+		mesh_grob()->cells_AABB();
 	    for(double x=box.xyz_min[0]+l/2.0; x<=box.xyz_max[0]; x+=l) {
 		for(double y=box.xyz_min[1]+l/2.0; y<=box.xyz_max[1]; y+=l) {
 		    for(double z=box.xyz_min[2]+l/2.0; z<=box.xyz_max[2]; z+=l) {
 			vec3 p(x,y,z);
-			if(AABB.containing_tet(p) != index_t(-1)) {
+			if(AABB->containing_tet(p) != index_t(-1)) {
 			    sampling->vertices.create_vertex(p.data());
 			}
 		    }
@@ -941,7 +965,11 @@ namespace OGF {
 	const NewMeshGrobName& air_particles_name,
 	const NewMeshGrobName& fluid_omega0_name,
 	bool physical,
-	bool no_transport
+	bool no_transport,
+	bool warm_start,
+	const NewFileName& time_series,
+	const std::string& time_series_attributes,
+	double time_series_quantum
     ) {
         MeshGrob* omega = MeshGrob::find(scene_graph(),omega_name);
         if(omega == nullptr) {
@@ -1034,6 +1062,24 @@ namespace OGF {
 
 	vector<double> initial_weights(nb_pts);
 
+	// Weights of the previous timestep, used to warm-start
+	// the optimal transport solver.
+	vector<double> weights(nb_pts);
+	bool has_weights = false;
+	double OT_total_time = 0.0;
+	index_t nb_timesteps = 0;
+
+	TimeSeriesWriter time_series_writer;
+	if(
+	    save_every != 0 && time_series != "" &&
+	    !time_series_writer.open(
+		time_series, *mesh_grob(),
+		time_series_attributes, time_series_quantum
+	    )
+	) {
+	    return;
+	}
+
 	bool zero_iter = false;
 	if(nb_iter == 0) {
 	    nb_iter = 1;
@@ -1085,6 +1131,17 @@ namespace OGF {
 		    (MeshGrob::find(scene_graph(),"centroids") != nullptr);
 	    }
 
+	    // Off-limit points need the bbox-based guess, else restart
+	    // from the weights of the previous timestep if available.
+	    const double* weights_in = nullptr;
+	    if(off_limits) {
+		weights_in = initial_weights.data();
+	    } else if(warm_start && has_weights) {
+		initial_weights = weights;
+		weights_in = initial_weights.data();
+	    }
+
+	    Stopwatch W_OT("Laguerre", false);
             compute_Laguerre_centroids_2d(
                 omega, nb_pts,
 		pos[0].data(),
@@ -1092,10 +1149,20 @@ namespace OGF {
 		RVD, verbose,
 		nb_air_particles, air_particles, air_particles_stride,
 		air_fraction,
-		off_limits ? initial_weights.data() : nullptr,
-		nullptr,
+		weights_in,
+		warm_start ? weights.data() : nullptr,
 		no_transport ? 0 : 1000
             );
+	    has_weights = warm_start;
+	    OT_total_time += W_OT.elapsed_time();
+	    ++nb_timesteps;
+	    if(verbose) {
+		Logger::out("Euler")
+		    << "Timestep " << k << ": optimal transport "
+		    << W_OT.elapsed_time() << "s"
+		    << ((weights_in != nullptr) ? " (warm start)" : "")
+		    << std::endl;
+	    }
 
 	    if(show_RVD) {
 		Attribute<index_t> f_chart(RVD->facets.attributes(), "chart");
@@ -1236,14 +1303,20 @@ namespace OGF {
 		    Logger::out("Euler") << "Saving timestep..." << std::endl;
 		}
 
-		std::string iter_str = String::to_string(k + first_iter);
-		while(iter_str.length() < 5) {
-		    iter_str = "0" + iter_str;
-		}
+		if(time_series_writer.is_open()) {
+		    time_series_writer.write_timestep(
+			k + first_iter, *mesh_grob()
+		    );
+		} else {
+		    std::string iter_str = String::to_string(k + first_iter);
+		    while(iter_str.length() < 5) {
+			iter_str = "0" + iter_str;
+		    }
 
-		scene_graph()->save_current_object(
-		    "Euler_timestep_" + iter_str + ".graphite"
-		);
+		    scene_graph()->save_current_object(
+			"Euler_timestep_" + iter_str + ".graphite"
+		    );
+		}
 	    }
 
 
@@ -1255,6 +1328,11 @@ namespace OGF {
 		mesh_grob()->redraw();
 	    }
         }
+
+	if(time_series_writer.is_open()) {
+	    time_series_writer.close();
+	}
+	log_optimal_transport_timings(nb_timesteps, OT_total_time);
     }
 
     void MeshGrobTransportCommands::shell_mesh(
@@ -1667,20 +1745,17 @@ namespace OGF {
 	}
 
 
-	domain->lock_graphics();
-	MeshCellsAABB AABB(*domain);
+	std::shared_ptr<const MeshCellsAABB> AABB = domain->cells_AABB();
 	vector<index_t> to_delete(points->vertices.nb(),0);
 	FOR(v,points->vertices.nb()) {
 	    if(
-		AABB.containing_tet(vec3(points->vertices.point_ptr(v))) ==
+		AABB->containing_tet(vec3(points->vertices.point_ptr(v))) ==
 				    MeshCellsAABB::NO_TET
 	    ) {
 		to_delete[v] = 1;
 	    }
 	}
 	points->vertices.delete_elements(to_delete);
-	domain->unlock_graphics();
-	domain->update();
 	points->update();
     }
 
@@ -2208,7 +2283,11 @@ namespace OGF {
 	bool split_interface,
 	bool verbose,
 	index_t project_every,
-	bool physical
+	bool physical,
+	bool warm_start,
+	const NewFileName& time_series,
+	const std::string& time_series_attributes,
+	double time_series_quantum
     ) {
         MeshGrob* omega = MeshGrob::find(scene_graph(),omega_name);
         if(omega == nullptr) {
@@ -2244,8 +2323,28 @@ namespace OGF {
 	    interface = MeshGrob::find_or_create(scene_graph(), "interface");
 	}
 
+	TimeSeriesWriter time_series_writer;
+	if(
+	    save_every != 0 && time_series != "" &&
+	    !time_series_writer.open(
+		time_series, *mesh_grob(),
+		time_series_attributes, time_series_quantum
+	    )
+	) {
+	    return;
+	}
+
+	// Weights of the previous timestep, used to warm-start
+	// the optimal transport solver.
+	vector<double> weights(nb_pts);
+	bool has_weights = false;
+	double OT_total_time = 0.0;
+	index_t nb_timesteps = 0;
+
         for(unsigned int k=1; k<=nb_iter; ++k) {
 	    Stopwatch W("Timestep");
+	    Stopwatch W_OT("Laguerre", false);
+	    bool warm = false;
 
 	    if(verbose) {
 		Logger::out("Euler")
@@ -2280,6 +2379,32 @@ namespace OGF {
 		    mesh_split_catmull_clark(*interface);
 		}
 		interface->update();
+	    } else if(warm_start) {
+		// Same settings as compute_Laguerre_centroids_3d() in the
+		// cold-start branch below, that does not let us specify the
+		// initial weights.
+		OptimalTransportMap3d OTM(omega);
+		OTM.set_verbose(verbose);
+		OTM.set_points(
+		    nb_pts,
+		    mesh_grob()->vertices.point_ptr(0),
+		    mesh_grob()->vertices.dimension()
+		);
+		OTM.set_epsilon(0.01);
+		OTM.set_regularization(1e-3);
+		OTM.set_Newton(true);
+		if(has_weights) {
+		    FOR(i, nb_pts) {
+			OTM.set_weight(i, weights[i]);
+		    }
+		    warm = true;
+		}
+		OTM.optimize(2000);
+		OTM.compute_Laguerre_centroids(centroids[0].data());
+		FOR(i, nb_pts) {
+		    weights[i] = OTM.weight(i);
+		}
+		has_weights = true;
 	    } else {
 		compute_Laguerre_centroids_3d(
 		    omega, nb_pts,
@@ -2290,6 +2415,16 @@ namespace OGF {
 		);
 	    }
 
+	    OT_total_time += W_OT.elapsed_time();
+	    ++nb_timesteps;
+	    if(verbose) {
+		Logger::out("Euler")
+		    << "Timestep " << k << ": optimal transport "
+		    << W_OT.elapsed_time() << "s"
+		    << (warm ? " (warm start)" : "")
+		    << std::endl;
+	    }
+
 	    if(zero_iter) {
 		if(interface != nullptr) {
 		    interface->update();
@@ -2349,14 +2484,25 @@ namespace OGF {
 		    Logger::out("Euler")
 			<< "Saving timestep: " << iter_str << std::endl;
 		}
-		scene_graph()->save_current_object(
-		    "Euler_timestep_" + iter_str + ".graphite"
-		);
+		if(time_series_writer.is_open()) {
+		    time_series_writer.write_timestep(
+			k + first_iter, *mesh_grob()
+		    );
+		} else {
+		    scene_graph()->save_current_object(
+			"Euler_timestep_" + iter_str + ".graphite"
+		    );
+		}
 	    }
 
             omega->update();
             mesh_grob()->update();
         }
+
+	if(time_series_writer.is_open()) {
+	    time_series_writer.close();
+	}
+	log_optimal_transport_timings(nb_timesteps, OT_total_time);
     }
 
 
@@ -2400,6 +2546,9 @@ namespace OGF {
 	    RVD = MeshGrob::find_or_create(scene_graph(),"RVD");
 	}
 
+	double OT_total_time = 0.0;
+	index_t nb_timesteps = 0;
+
         for(unsigned int k=1; k<=nb_iter; ++k) {
 
 	    if(verbose) {
@@ -2410,6 +2559,7 @@ namespace OGF {
 
             // Step 1: get Laguerre cells centroids
 
+	    Stopwatch W_OT("Laguerre", false);
 	    compute_Laguerre_centroids_on_surface(
 		omega, nb_pts,
 		mesh_grob()->vertices.point_ptr(0),
@@ -2417,6 +2567,13 @@ namespace OGF {
 		RVD,
 		verbose
 	    );
+	    OT_total_time += W_OT.elapsed_time();
+	    ++nb_timesteps;
+	    if(verbose) {
+		Logger::out("Euler")
+		    << "Timestep " << k << ": optimal transport "
+		    << W_OT.elapsed_time() << "s" << std::endl;
+	    }
 
             // Step 2: update speeds
 
@@ -2487,6 +2644,8 @@ namespace OGF {
 		mesh_grob()->redraw();
 	    }
         }
+
+	log_optimal_transport_timings(nb_timesteps, OT_total_time);
     }
 
     void MeshGrobTransportCommands::smooth_interface() {
@@ -2971,14 +3130,32 @@ namespace OGF {
     ) {
         double t = t0;
 	VelocityField_var VF = VelocityField::create(field);
+	if(mesh_grob()->vertices.dimension() < 3) {
+	    Logger::err("Advect") << "Mesh dimension is less than 3"
+				  << std::endl;
+	    return;
+	}
+
+	// Timesteps are saved by a background thread, from a copy of
+	// the vertices, while the next timestep is computed. The Logger
+	// is not thread-safe and mesh_save() logs, hence the writer only
+	// overlaps advect_points() (that does not log), and is joined
+	// before anything else.
+	Mesh timestep;
+	std::thread writer;
+
 	FOR(i, nb_timesteps) {
-	    FOR(v, mesh_grob()->vertices.nb()) {
-		double* p = mesh_grob()->vertices.point_ptr(v);
-		vec3 V;
-		time_integrator(t, dt, vec3(p), V, integrator, VF);
-		p[0] += dt * V.x;
-		p[1] += dt * V.y;
-		p[2] += dt * V.z;
+	    if(mesh_grob()->vertices.nb() != 0) {
+		advect_points(
+		    t, dt,
+		    mesh_grob()->vertices.nb(),
+		    mesh_grob()->vertices.point_ptr(0),
+		    mesh_grob()->vertices.dimension(),
+		    integrator, VF
+		);
+	    }
+	    if(writer.joinable()) {
+		writer.join();
 	    }
 	    mesh_grob()->update();
 	    Logger::out("Advect") << "Timestep: " << t << std::endl;
@@ -2987,10 +3164,20 @@ namespace OGF {
 	      while(i_as_string.length() < 4) {
 		i_as_string = "0" + i_as_string;
 	      }
-	      mesh_grob()->save("advect_" + i_as_string + ".xyz");
+	      std::string filename = "advect_" + i_as_string + ".xyz";
+	      timestep.copy(*mesh_grob(), false, MESH_VERTICES);
+	      writer = std::thread(
+		  [&timestep, filename]() {
+		      mesh_save(timestep, filename);
+		  }
+	      );
 	    }
 	    t += dt;
 	}
+
+	if(writer.joinable()) {
+	    writer.join();
+	}
     }
 
 
@@ -3190,6 +3377,31 @@ namespace OGF {
        }
     }
 
+    void MeshGrobTransportCommands::load_time_series_timestep(
+	const FileName& filename, index_t timestep
+    ) {
+	TimeSeriesReader reader;
+	if(!reader.open(filename)) {
+	    return;
+	}
+	index_t i = reader.find_timestep(timestep);
+	if(i == NO_INDEX) {
+	    if(reader.nb_timesteps() == 0) {
+		Logger::err("TimeSeries") << "File has no timestep"
+					  << std::endl;
+	    } else {
+		Logger::err("TimeSeries")
+		    << timestep << ": no such timestep (available: "
+		    << reader.timestep(0) << " to "
+		    << reader.timestep(reader.nb_timesteps()-1) << ")"
+		    << std::endl;
+	    }
+	    return;
+	}
+	reader.read_timestep(i, *mesh_grob());
+	mesh_grob()->update();
+    }
+
 
     void MeshGrobTransportCommands::normalize_transported_volume() {
         if(mesh_grob()->vertices.dimension() != 6) {
@@ -3276,7 +3488,7 @@ namespace OGF {
 	    return;
 	}
 
-	MeshFacetsAABB AABB(*mesh_grob());
+	std::shared_ptr<const MeshFacetsAABB> AABB = mesh_grob()->facets_AABB();
 
 	vector<vec3> V(mesh_grob()->vertices.nb());
 	vector<double> d(mesh_grob()->vertices.nb(), R0);
@@ -3288,7 +3500,7 @@ namespace OGF {
 	    vec3 D(points->vertices.point_ptr(i));
 	    MeshFacetsAABB::Intersection I;
 	    vector<index_t> N;
-	    if(AABB.ray_nearest_intersection(Ray(vec3(0.0, 0.0, 0.0), D),I)) {
+	    if(AABB->ray_nearest_intersection(Ray(vec3(0.0, 0.0, 0.0), D),I)) {
 		get_facet_rings(mesh_grob(), I.f, N, nb_rings);
 		for(index_t f: N) {
 		    for(index_t lv=0;
@@ -4134,7 +4346,7 @@ namespace OGF {
     }
 
     void MeshGrobTransportCommands::remove_bubbles() {
-	MeshFacetsAABB AABB(*mesh_grob());
+	std::shared_ptr<const MeshFacetsAABB> AABB = mesh_grob()->facets_AABB();
         Attribute<index_t> chart(
 	    mesh_grob()->facets.attributes(), "chart"
         );
@@ -4157,7 +4369,7 @@ namespace OGF {
 		    Numeric::random_float64()
 		);
 		index_t count = 0;
-		AABB.ray_all_intersections(
+		AABB->ray_all_intersections(
 		    Ray(p,V), [&](const MeshFacetsAABB::Intersection& I) {
 			if(I.f != NO_INDEX && chart[I.f] != c) {
 			    ++count;
@@ -319,6 +319,15 @@ namespace OGF {
 	 * \param[in] physical true if using F=ma, else uses F=a
 	 * \param[in] no_transport if true, just use non-optimized
 	 *  Voronoi diagram
+	 * \param[in] warm_start if true, the optimal transport solver
+	 *  starts from the weights of the previous timestep
+	 * \param[in] time_series if set, timesteps saved every save_every
+	 *  are written to this time series file instead of one .graphite
+	 *  file per timestep
+	 * \param[in] time_series_attributes semicolon-separated list of
+	 *  vertex attributes written to the time series
+	 * \param[in] time_series_quantum if non-zero, values written to the
+	 *  time series are rounded to a multiple of it and delta-compressed
          */
 	void Euler2d(
             const MeshGrobName& omega,
@@ -335,7 +344,11 @@ namespace OGF {
 	    const NewMeshGrobName& air_particles="",
 	    const NewMeshGrobName& fluid_omega0="",
 	    bool physical=true,
-	    bool no_transport=false
+	    bool no_transport=false,
+	    bool warm_start=false,
+	    const NewFileName& time_series="",
+	    const std::string& time_series_attributes="mass;V",
+	    double time_series_quantum=0.0
 	);
 
         /**
@@ -360,6 +373,16 @@ namespace OGF {
 	 *  the barycenter of its cell every nnn interations.
 	 * \param[in] physical if true, then update using Newton second law,
 	 *  else update as in initial article.
+	 * \param[in] warm_start if true, the optimal transport solver
+	 *  starts from the weights of the previous timestep (not used
+	 *  when computing the interface)
+	 * \param[in] time_series if set, timesteps saved every save_every
+	 *  are written to this time series file instead of one .graphite
+	 *  file per timestep
+	 * \param[in] time_series_attributes semicolon-separated list of
+	 *  vertex attributes written to the time series
+	 * \param[in] time_series_quantum if non-zero, values written to the
+	 *  time series are rounded to a multiple of it and delta-compressed
          */
         void Euler3d(
             const MeshGrobName& omega,
@@ -373,7 +396,11 @@ namespace OGF {
 	    bool split_interface=false,
 	    bool verbose=true,
 	    index_t project_every=0,
-	    bool physical=true
+	    bool physical=true,
+	    bool warm_start=false,
+	    const NewFileName& time_series="",
+	    const std::string& time_series_attributes="mass;V",
+	    double time_series_quantum=0.0
         );
 
         /**
@@ -685,6 +712,17 @@ namespace OGF {
                const NewFileName& file_name
 	);
 
+	/**
+	 * \menu Post-processing
+	 * \brief Loads a timestep from a time series file saved by
+	 *  Euler2d() or Euler3d().
+	 * \param[in] filename the time series file
+	 * \param[in] timestep the number of the timestep
+	 */
+	void load_time_series_timestep(
+	    const FileName& filename, index_t timestep = 0
+	);
+
 	/**
 	 * \menu Post-processing
 	 * \brief Resizes the warped mesh in such a way it has the same
@@ -35,8 +35,11 @@
  */
 
 #include <OGF/gompy/interpreter/nl_vector_interop.h>
+#include <OGF/gompy/interpreter/py_graphite_object.h>
 #include <OGF/gom/reflection/meta.h>
 
+#include <cstring>
+
 
 /************** NumPy Interop **********************************/
 
@@ -90,6 +93,164 @@ namespace {
 	delete array_interface;
     }
 
+    /**
+     * \brief A NL::Vector that refers to the memory of a Python object
+     *  that supports the buffer protocol.
+     * \details The buffer is kept, and the Python object is kept alive,
+     *  until the vector is destroyed.
+     */
+    class PythonBufferVector : public NL::Vector {
+    public:
+	/**
+	 * \brief PythonBufferVector constructor.
+	 * \param[in] buffer the buffer, obtained by PyObject_GetBuffer().
+	 *  It is released by the destructor.
+	 * \param[in] size number of items
+	 * \param[in] dimension number of elements per item
+	 * \param[in] element_meta_type type of the elements.
+	 */
+	PythonBufferVector(
+	    const Py_buffer& buffer, index_t size, index_t dimension,
+	    MetaType* element_meta_type
+	) : NL::Vector(
+	        nullptr, buffer.buf, size, dimension,
+	        element_meta_type, buffer.readonly != 0
+	    ),
+	    buffer_(buffer) {
+	}
+
+	/**
+	 * \brief PythonBufferVector destructor.
+	 * \details Releases the buffer. The vector may be destroyed by
+	 *  Graphite outside of a Python call, hence the GIL is acquired.
+	 */
+	~PythonBufferVector() override {
+	    PyGILState_STATE gil_state = PyGILState_Ensure();
+	    PyBuffer_Release(&buffer_);
+	    PyGILState_Release(gil_state);
+	}
+
+    private:
+	Py_buffer buffer_;
+    };
+
+    /**
+     * \brief Gets the element type of a Python buffer.
+     * \param[in] buffer the buffer
+     * \return the MetaType of the elements, or nullptr if the format
+     *  of the buffer does not correspond to a NL::Vector element type.
+     */
+    MetaType* buffer_element_meta_type(const Py_buffer& buffer) {
+	const char* format = (buffer.format == nullptr) ? "B" : buffer.format;
+	// Native, standard native or little endian byte order
+	// (all the platforms supported by Graphite are little endian).
+	if(*format == '@' || *format == '=' || *format == '<') {
+	    ++format;
+	}
+	if(format[0] == '\0' || format[1] != '\0') {
+	    return nullptr;
+	}
+	MetaType* result = nullptr;
+	switch(format[0]) {
+	case 'd':
+	    result = ogf_meta<double>::type();
+	    break;
+	case 'f':
+	    result = ogf_meta<float>::type();
+	    break;
+	case 'i':
+	case 'l':
+	case 'q':
+	    result = ogf_meta<Numeric::int32>::type();
+	    break;
+	case 'I':
+	case 'L':
+	case 'Q':
+	    result = ogf_meta<Numeric::uint32>::type();
+	    break;
+	case 'B':
+	    result = ogf_meta<Numeric::uint8>::type();
+	    break;
+	case '?':
+	    result = ogf_meta<bool>::type();
+	    break;
+	}
+	// Formats 'l', 'q', 'L' and 'Q' are accepted if they have 32 bits.
+	if(
+	    result != nullptr &&
+	    buffer.itemsize != Py_ssize_t(result->life_cycle()->object_size())
+	) {
+	    result = nullptr;
+	}
+	return result;
+    }
+
+    /**
+     * \brief Gets the buffer protocol format of a NL::Vector element type.
+     * \param[in] element_meta_type the type of the elements
+     * \return the format in the struct module syntax, or nullptr if
+     *  the type cannot be exported.
+     */
+    const char* element_meta_type_buffer_format(MetaType* element_meta_type) {
+	if(element_meta_type == ogf_meta<double>::type()) {
+	    return "d";
+	}
+	if(element_meta_type == ogf_meta<float>::type()) {
+	    return "f";
+	}
+	if(element_meta_type == ogf_meta<Numeric::int32>::type()) {
+	    return "i";
+	}
+	if(element_meta_type == ogf_meta<Numeric::uint32>::type()) {
+	    return "I";
+	}
+	if(element_meta_type == ogf_meta<Numeric::uint8>::type()) {
+	    return "B";
+	}
+	if(element_meta_type == ogf_meta<bool>::type()) {
+	    return "?";
+	}
+	return nullptr;
+    }
+
+    /**
+     * \brief Computes a fingerprint of a memory area.
+     * \details Used to detect whether a writable buffer was actually
+     *  modified. Reading the buffer costs much less than notifying
+     *  a Grob (that updates it and its graphics).
+     * \param[in] data a pointer to the memory area
+     * \param[in] len the size of the memory area in bytes
+     * \return a 64 bits hash of the bytes
+     */
+    Numeric::uint64 buffer_fingerprint(const void* data, size_t len) {
+	const Memory::byte* p = static_cast<const Memory::byte*>(data);
+	Numeric::uint64 h = 14695981039346656037ull;
+	size_t nb_words = len / sizeof(Numeric::uint64);
+	for(size_t i=0; i<nb_words; ++i) {
+	    Numeric::uint64 w;
+	    std::memcpy(&w, p + i*sizeof(Numeric::uint64), sizeof(w));
+	    h = (h ^ w) * 1099511628211ull;
+	    h ^= (h >> 29);
+	}
+	for(size_t i=nb_words*sizeof(Numeric::uint64); i<len; ++i) {
+	    h = (h ^ Numeric::uint64(p[i])) * 1099511628211ull;
+	}
+	return h;
+    }
+
+    /**
+     * \brief Shape and strides of the buffers exported by
+     *  Graphite objects.
+     * \details Stored in Py_buffer::internal. For writable buffers,
+     *  the fingerprint of the elements is also stored, so that the
+     *  object is only notified if they were modified.
+     */
+    struct GraphiteBufferInfo {
+	Py_ssize_t shape[2];
+	Py_ssize_t strides[2];
+	Numeric::uint64 fingerprint;
+    };
+
 }
 
 
@@ -103,6 +264,53 @@ namespace OGF {
 		return false;
 	    }
 
+	    // Graphite objects are passed as is.
+	    if(PyGraphite_Check(obj)) {
+		return false;
+	    }
+
+	    // Buffer protocol (PEP 3118): the NL::Vector refers to the
+	    // memory of the Python object, and keeps the buffer until
+	    // it is destroyed.
+	    if(PyObject_CheckBuffer(obj)) {
+		Py_buffer buffer;
+		int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+		if(PyObject_GetBuffer(obj, &buffer, flags | PyBUF_WRITABLE)) {
+		    PyErr_Clear();
+		    if(PyObject_GetBuffer(obj, &buffer, flags)) {
+			PyErr_Clear();
+			Logger::err("gompy")
+			    << "Could not access array as NL::Vector"
+			    << " (only C-contiguous arrays can be referenced)"
+			    << std::endl;
+			SmartPointer<Counted> graphite_vector;
+			result.set_value(graphite_vector);
+			return true;
+		    }
+		}
+		MetaType* element_meta_type = buffer_element_meta_type(buffer);
+		if(
+		    element_meta_type == nullptr ||
+		    buffer.ndim < 1 || buffer.ndim > 2
+		) {
+		    Logger::err("gompy")
+			<< "Could not access array as NL::Vector"
+			<< " (unsupported element type or dimension)"
+			<< std::endl;
+		    PyBuffer_Release(&buffer);
+		    SmartPointer<Counted> graphite_vector;
+		    result.set_value(graphite_vector);
+		    return true;
+		}
+		index_t size = index_t(buffer.shape[0]);
+		index_t dim = (buffer.ndim == 2) ? index_t(buffer.shape[1]) : 1;
+		SmartPointer<Counted> graphite_vector =
+		    new PythonBufferVector(buffer, size, dim, element_meta_type);
+		result.set_value(graphite_vector);
+		return true;
+	    }
+
+	    // Legacy array interface (__array_struct__).
 	    if(PyObject_HasAttrString(obj,"__array_struct__")) {
 		PyObject* capsule = PyObject_GetAttrString(
 		    obj,"__array_struct__"
@@ -215,9 +423,12 @@ namespace OGF {
 	    array_interface->flags =
 		NPY_ARRAY_C_CONTIGUOUS |
 		NPY_ARRAY_ALIGNED |
-		NPY_ARRAY_WRITEABLE |
 		NPY_ARRAY_NOTSWAPPED ;
 
+	    if(!vector->get_read_only()) {
+		array_interface->flags |= NPY_ARRAY_WRITEABLE;
+	    }
+
 	    if(vector->dimension() == 1) {
 		array_interface->nd    = 1;
 		array_interface->shape = new Py_intptr_t[1];
@@ -277,5 +488,123 @@ namespace OGF {
 		array_interface, nullptr, delete_array_interface
 	    );
 	}
+
+	/**********************************************************************/
+
+	int graphite_Object_getbuffer(
+	    PyObject* self, Py_buffer* view, int flags
+	) {
+	    view->obj = nullptr;
+	    Object* object = PyGraphite_GetObject(self);
+	    Memory::pointer data = nullptr;
+	    MetaType* element_meta_type = nullptr;
+	    bool read_only = true;
+	    if(
+		object == nullptr ||
+		!object->get_elements_data(data, element_meta_type, read_only)
+	    ) {
+		PyErr_SetString(
+		    PyExc_BufferError, "Graphite object is not an array"
+		);
+		return -1;
+	    }
+	    const char* format =
+		element_meta_type_buffer_format(element_meta_type);
+	    if(format == nullptr) {
+		PyErr_SetString(
+		    PyExc_BufferError, "unsupported array element type"
+		);
+		return -1;
+	    }
+	    if((flags & PyBUF_WRITABLE) != 0 && read_only) {
+		PyErr_SetString(PyExc_BufferError, "array is read-only");
+		return -1;
+	    }
+
+	    Py_ssize_t itemsize =
+		Py_ssize_t(element_meta_type->life_cycle()->object_size());
+	    Py_ssize_t nb_elements = Py_ssize_t(object->get_nb_elements());
+	    Py_ssize_t dim = Py_ssize_t(object->get_dimension());
+
+	    // Items are stored contiguously, with their elements
+	    // (C order).
+	    GraphiteBufferInfo* info = new GraphiteBufferInfo;
+	    if(dim <= 1) {
+		view->ndim = 1;
+		info->shape[0] = nb_elements;
+		info->strides[0] = itemsize;
+	    } else {
+		view->ndim = 2;
+		info->shape[0] = nb_elements / dim;
+		info->shape[1] = dim;
+		info->strides[0] = dim * itemsize;
+		info->strides[1] = itemsize;
+	    }
+
+	    if(
+		(flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS &&
+		view->ndim == 2 && info->shape[0] > 1 && info->shape[1] > 1
+	    ) {
+		delete info;
+		PyErr_SetString(
+		    PyExc_BufferError, "array is not Fortran contiguous"
+		);
+		return -1;
+	    }
+
+	    // Empty arrays may have no memory.
+	    static Memory::byte empty_array[8];
+	    view->buf = (data != nullptr) ? data : empty_array;
+	    view->obj = self;
+	    Py_INCREF(self);
+	    view->len = nb_elements * itemsize;
+	    view->itemsize = itemsize;
+	    view->readonly = read_only ? 1 : 0;
+	    view->format = ((flags & PyBUF_FORMAT) != 0) ?
+		const_cast<char*>(format) : nullptr;
+	    view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ?
+		info->shape : nullptr;
+	    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ?
+		info->strides : nullptr;
+	    view->suboffsets = nullptr;
+	    info->fingerprint = read_only ? 0 :
+		buffer_fingerprint(view->buf, size_t(view->len));
+	    view->internal = info;
+	    return 0;
+	}
+
+	void graphite_Object_releasebuffer(PyObject* self, Py_buffer* view) {
+	    GraphiteBufferInfo* info =
+		static_cast<GraphiteBufferInfo*>(view->internal);
+	    // The elements may have been modified through a writable view.
+	    // Notify the object only if they were actually modified (most
+	    // views, e.g. numpy arrays, are writable even when only read).
+	    Object* object = PyGraphite_GetObject(self);
+	    if(!view->readonly && object != nullptr) {
+		// If the elements were moved (object resized meanwhile),
+		// the view no longer points to them, do not read it.
+		Memory::pointer data = nullptr;
+		MetaType* element_meta_type = nullptr;
+		bool read_only = true;
+		bool same_buffer =
+		    object->get_elements_data(
+			data, element_meta_type, read_only
+		    ) &&
+		    (data == view->buf || data == nullptr) &&
+		    Py_ssize_t(
+			element_meta_type->life_cycle()->object_size() *
+			object->get_nb_elements()
+		    ) == view->len;
+		if(
+		    !same_buffer ||
+		    buffer_fingerprint(view->buf, size_t(view->len)) !=
+		    info->fingerprint
+		) {
+		    object->notify_elements_modified();
+		}
+	    }
+	    delete info;
+	    view->internal = nullptr;
+	}
     }
 }
@@ -81,6 +81,31 @@ namespace OGF {
 	 * \details Used for NumPy interop.
 	 */
 	void delete_array_interface(PyObject* capsule);
+
+	/**
+	 * \brief Implementation of the buffer protocol (PEP 3118) for
+	 *  Graphite objects.
+	 * \details Exports the elements of the objects that give direct
+	 *  access to them (see Object::get_elements_data()), such as
+	 *  NL::Vector and the Grob attributes, without copy.
+	 * \param[in] self the Python wrapper of the Graphite object
+	 * \param[out] view the buffer
+	 * \param[in] flags the PyBUF_xxx flags requested by the consumer
+	 * \retval 0 on success
+	 * \retval -1 on error, with a Python BufferError
+	 */
+	int graphite_Object_getbuffer(
+	    PyObject* self, Py_buffer* view, int flags
+	);
+
+	/**
+	 * \brief Releases a buffer obtained by graphite_Object_getbuffer().
+	 * \details If the buffer was writable, the object is notified
+	 *  that its elements may have changed.
+	 * \param[in] self the Python wrapper of the Graphite object
+	 * \param[in] view the buffer
+	 */
+	void graphite_Object_releasebuffer(PyObject* self, Py_buffer* view);
     }
 }
 
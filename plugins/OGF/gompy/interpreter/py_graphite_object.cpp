@@ -67,7 +67,6 @@ namespace OGF {
 	    graphite_Object *self = (graphite_Object *)type->tp_alloc(type, 0);
 	    self->object = nullptr;
 	    self->managed = true;
-	    self->array_struct = nullptr;
 	    return (PyObject*)self;
 	}
 
@@ -79,8 +78,6 @@ namespace OGF {
 	    }
 	    self->object = nullptr;
 	    Py_TYPE(self)->tp_free((PyObject*)self);
-	    Py_XDECREF(self->array_struct);
-	    self->array_struct = nullptr;
 	}
 
 	static PyObject* graphite_Object_richcompare(
@@ -234,6 +231,50 @@ namespace OGF {
 	    return string_to_python(out.str());
 	}
 
+	/**
+	 * \brief Maximum number of arguments of the methods that are
+	 *  called by position from Python.
+	 * \details Methods with more arguments use the ArgList-based
+	 *  invocation.
+	 */
+	static constexpr index_t MAX_POSITIONAL_ARGS = 16;
+
+	/**
+	 * \brief Invokes a request with the arguments passed by position.
+	 * \details The Python arguments are converted to the types of the
+	 *  method arguments, and missing trailing arguments get their default
+	 *  values.
+	 * \param[in] r the request.
+	 * \param[in] args the tuple with the Python arguments.
+	 * \param[out] result the return value of the method.
+	 * \retval true if the method could be invoked.
+	 * \retval false otherwise.
+	 * \pre r->method()->nb_args() <= MAX_POSITIONAL_ARGS
+	 */
+	static bool graphite_call_positional(
+	    Request* r, PyObject* args, Any& result
+	) {
+	    MetaMethod* method = r->method();
+	    index_t nb_args = index_t(PyTuple_Size(args));
+	    if(nb_args > method->nb_args()) {
+		Logger::err("GOMPy")
+		    << "Graphite request: too many arguments for method "
+		    << method->container_meta_class()->name() << "::"
+		    << method->name() << std::endl;
+		return false;
+	    }
+	    Any argv[MAX_POSITIONAL_ARGS];
+	    const Any* argp[MAX_POSITIONAL_ARGS];
+	    for(index_t i=0; i<nb_args; ++i) {
+		argv[i] = python_to_graphite(
+		    PyTuple_GetItem(args,Py_ssize_t(i)),
+		    method->ith_arg_cached_type(i)
+		);
+		argp[i] = &argv[i];
+	    }
+	    return r->invoke_positional(argp, nb_args, result);
+	}
+
 	PyObject* graphite_call(
 	    PyObject* self, PyObject* args, PyObject* keywords
 	) {
@@ -276,24 +317,35 @@ namespace OGF {
 	    }
 
 
-	    ArgList gom_args;
+	    Any result;
+	    bool ok = false;
+	    Request* r = dynamic_cast<Request*>(c.get());
 
-	    // Special case: method has a single argument of type ArgList
-	    // -> pack all the arguments in a ArgList
 	    if(
-		method != nullptr &&
-		method->nb_args() == 1 &&
-		method->ith_arg_type(0) == ogf_meta<OGF::ArgList>::type()
+		r != nullptr &&
+		!method->takes_arglist() &&
+		method->nb_args() <= MAX_POSITIONAL_ARGS &&
+		(keywords == nullptr || PyDict_Size(keywords) == 0)
 	    ) {
-		python_tographiteargs(args, keywords, gom_args);
+		// Fast path: standard call, arguments are converted
+		// directly to the declared types and passed by position
+		// (no ArgList, no lookup by name).
+		ok = graphite_call_positional(r, args, result);
 	    } else {
-		// Regular case: identify each individual argument according
-		// to method declaration. Add default values if need be.
-		python_tographiteargs(args, keywords, gom_args, method);
-	    }
+		ArgList gom_args;
 
-	    Any result;
-	    bool ok = c->invoke(gom_args, result);
+		// Special case: method has a single argument of type ArgList
+		// -> pack all the arguments in a ArgList
+		if(method != nullptr && method->takes_arglist()) {
+		    python_tographiteargs(args, keywords, gom_args);
+		} else {
+		    // Regular case: identify each individual argument
+		    // according to method declaration. Add default values
+		    // if need be.
+		    python_tographiteargs(args, keywords, gom_args, method);
+		}
+		ok = c->invoke(gom_args, result);
+	    }
 	    if(!ok) {
 		if(method != nullptr) {
 		    Logger::err("GOMPy")
@@ -499,9 +551,16 @@ namespace OGF {
 	) {
 	    geo_argused(closure);
 	    geo_debug_assert(PyGraphite_Check(self_in));
-	    graphite_Object* self = reinterpret_cast<graphite_Object*>(self_in);
-	    Py_XINCREF(self->array_struct);
-	    return self->array_struct;
+	    // Created each time, because the data pointer of the vector
+	    // changes when it is resized.
+	    NL::Vector* vector = dynamic_cast<NL::Vector*>(
+		PyGraphite_GetObject(self_in)
+	    );
+	    if(vector == nullptr) {
+		PyErr_SetString(PyExc_AttributeError, "__array_struct__");
+		return nullptr;
+	    }
+	    return create_array_interface(vector);
 	}
 
 	PyObject* graphite_get_doc(PyObject* self, void* closure) {
@@ -586,6 +645,15 @@ namespace OGF {
 	    graphite_array_ass_index /* mp_ass_subscript */
 	};
 
+	/**
+	 * \brief Buffer protocol (PEP 3118) in Python wrapper around
+	 *  Graphite object.
+	 */
+	static PyBufferProcs graphite_BufferProcs = {
+	    graphite_Object_getbuffer,    /* bf_getbuffer */
+	    graphite_Object_releasebuffer /* bf_releasebuffer */
+	};
+
 	PyTypeObject graphite_ObjectType = {
 	    PyVarObject_HEAD_INIT(nullptr, 0)
 	    "graphite.Object",        // tp_name
@@ -596,6 +664,7 @@ namespace OGF {
 	void init_graphite_ObjectType() {
 	    graphite_ObjectType.tp_dealloc     = graphite_Object_dealloc;
 	    graphite_ObjectType.tp_as_mapping  = &graphite_MappingMethods;
+	    graphite_ObjectType.tp_as_buffer   = &graphite_BufferProcs;
 	    graphite_ObjectType.tp_str         = graphite_str;
 	    graphite_ObjectType.tp_getattro    = graphite_Object_getattro;
 	    graphite_ObjectType.tp_setattro    = graphite_Object_setattro;
@@ -648,16 +717,6 @@ namespace OGF {
 		    Counted::ref(impl->object);
 		}
 
-		// If object is a vector, create information for interop
-		// with numpy.
-		NL::Vector* object_as_vector = dynamic_cast<NL::Vector*>(object);
-		if(object_as_vector != nullptr) {
-		    PyObject* array_interface =
-			create_array_interface(object_as_vector);
-		    Py_INCREF(array_interface);
-		    impl->array_struct = array_interface;
-		}
-
 		impl->magic = graphite_Object_MAGIC;
 	    }
 
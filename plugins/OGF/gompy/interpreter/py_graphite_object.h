@@ -85,8 +85,7 @@ namespace OGF {
 	 *  false otherwise. Reference counting is disabled for the interpreter
 	 *  itself, else it creates a circular reference.
 	 * \details Returns an object, a callable or a meta-class depending on
-	 *  \p object type. If \p object is an NL::Vector, creates also the
-	 *  array interface for numpy interop.
+	 *  \p object type.
 	 */
 	PyObject* PyGraphiteObject_New(Object* object, bool managed=true);
 
@@ -104,9 +103,6 @@ namespace OGF {
 	    /** \brief true if reference-counted, false otherwise. */
 	    bool managed;
 
-	    /** \brief Pointer to array interface or nullptr. */
-	    PyObject* array_struct;
-
 	    /** \brief For debugging / sanity checks */
 	    Numeric::uint32 magic;
 	};
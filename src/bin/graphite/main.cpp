@@ -230,6 +230,21 @@ namespace {
 	    "shorthand for batch=true and interactive=true"
         );
 
+        CmdLine::declare_arg(
+            "dbg:gom_stats", false,
+	    "display GOM member lookup statistics on exit"
+        );
+
+        CmdLine::declare_arg(
+            "dbg:filter_benchmark", false,
+	    "compare compiled and reference filter tests (timings)"
+        );
+
+        CmdLine::declare_arg(
+            "dbg:duplicates_benchmark", false,
+	    "compare hash-based and mesh_repair duplicate facets detection"
+        );
+
         std::vector<std::string> filenames;
         if(!CmdLine::parse(argc,argv,filenames,"<inputfile>*")) {
             exit(-1);
@@ -284,6 +299,26 @@ namespace {
 	    "gui:undo_depth", 4, "number of memorized states for undo"
 	);
 
+        Preferences::declare_preference_variable(
+	    "gui:undo_memory", 1024,
+	    "memory for undo states in MB (older states are moved to disk)"
+	);
+
+        Preferences::declare_preference_variable(
+	    "gui:indexed_graphite", false,
+	    "save scenes as chunk-indexed .graphite files (parallel save/load)"
+	);
+
+        Preferences::declare_preference_variable(
+	    "gui:lazy_graphite", false,
+	    "read objects of chunk-indexed .graphite files on demand"
+	);
+
+        Preferences::declare_preference_variable(
+	    "gui:cpu_picking", false,
+	    "pick mesh elements on the CPU (no GPU read-back)"
+	);
+
         Preferences::declare_preference_variable(
 	    "gfx:default_full_screen_effect", "Plain",
 	    "full-screen effect enabled by default"
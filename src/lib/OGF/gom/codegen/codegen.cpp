@@ -209,13 +209,11 @@ namespace OGF {
         mclass->get_slots(meta_slots, false);
         for(unsigned int i=0; i<meta_slots.size(); i++) {
             MetaSlot* mslot = meta_slots[i];
-            if(
-                mslot->nb_args() == 1 &&
-                mslot->ith_arg(0)->type_name() == "OGF::ArgList"
-            ) {
+            if(takes_arglist(mslot)) {
                 generate_method_adapter_arglist(mslot);
             } else {
                 generate_method_adapter(mslot);
+                generate_positional_adapter(mslot);
             }
         }
 
@@ -224,10 +222,16 @@ namespace OGF {
         mclass->get_properties(meta_properties, false);
         for(unsigned int i=0; i<meta_properties.size(); i++) {
             generate_method_adapter(meta_properties[i]->meta_method_get());
+            generate_positional_adapter(
+                meta_properties[i]->meta_method_get()
+            );
             if(!meta_properties[i]->read_only()) {
                 generate_method_adapter(
                     meta_properties[i]->meta_method_set()
                 );
+                generate_positional_adapter(
+                    meta_properties[i]->meta_method_set()
+                );
             }
         }
 
@@ -392,6 +396,13 @@ namespace OGF {
                   << method_adapter_name(prop->meta_method_get())
                   << std::endl;
             out() << "      );" << std::endl;
+            out() << "      ";
+            out() << "cur_prop->meta_method_get()->set_positional_adapter("
+                  << std::endl;
+            out() << "         "
+                  << positional_adapter_name(prop->meta_method_get())
+                  << std::endl;
+            out() << "      );" << std::endl;
 
             if(!prop->read_only()) {
                 out() << "      " <<
@@ -401,6 +412,13 @@ namespace OGF {
                       << method_adapter_name(prop->meta_method_set())
                       << std::endl;
                 out() << "      );" << std::endl;
+                out() << "      " <<
+                    "cur_prop->meta_method_set()->set_positional_adapter("
+                      << std::endl;
+                out() << "         "
+                      << positional_adapter_name(prop->meta_method_set())
+                      << std::endl;
+                out() << "      );" << std::endl;
             }
             generate_attributes(prop, "cur_prop");
             out() << "   }" << std::endl;
@@ -439,6 +457,13 @@ namespace OGF {
             out() << "      cur_slot->set_method_adapter(" << std::endl
                   << "         " << method_adapter_name(slot) << std::endl
                   << "      );" << std::endl;
+            if(!takes_arglist(slot)) {
+                out() << "      cur_slot->set_positional_adapter("
+                      << std::endl
+                      << "         " << positional_adapter_name(slot)
+                      << std::endl
+                      << "      );" << std::endl;
+            }
 
             generate_attributes(slot, "cur_slot");
 
@@ -592,6 +617,63 @@ namespace OGF {
         out() << std::endl;
     }
 
+    void GomCodeGenerator::generate_positional_adapter(MetaMethod* method) {
+        out() << "static bool " << positional_adapter_name(method)
+              << "(" << std::endl
+              << "   Object* gom__target_in__, " << std::endl
+              << "   const Any* const* gom__args__, " << std::endl
+              << "   Any& gom__result_any__" << std::endl
+              << ") {"
+              << std::endl;
+
+        out() << "   " << method->container_meta_class()->name()
+              << "* gom__target__ = "
+              << "dynamic_cast<" << method->container_meta_class()->name()
+              << "*>(" << std::endl
+              << "      gom__target_in__" << std::endl
+              << "   );" << std::endl;
+
+        out() << "   if(gom__target__ == nullptr) { return false; }"
+              << std::endl;
+
+        for(index_t i=0; i<method->nb_args(); i++) {
+            const MetaArg* arg = method->ith_arg(i);
+            std::string name = arg->name();
+            std::string type = arg->type()->name();
+            out() << "   "  << type << " " << name << "="
+                  << "ArgList::positional_arg_value<" << type << ">("
+                  << "*gom__args__[" << i << "]," << i << ");" << std::endl;
+        }
+
+        out() << "   ";
+        if(method->return_type_name() != "void") {
+            out() << method->return_type()->name() << " "
+                  << " gom__result__ = ";
+        }
+        out() << "gom__target__->" << method->name() << "(";
+
+        for(index_t i=0; i<method->nb_args(); i++) {
+            const MetaArg* arg = method->ith_arg(i);
+            std::string name = arg->name();
+            out() << name;
+            if(i < method->nb_args() - 1) {
+                out() << ", ";
+            }
+        }
+
+        out() << "); " << std::endl;
+
+        if(method->return_type_name() != "void") {
+            out() << "   gom__result_any__.set_value("
+                  << "gom__result__);"
+                  << std::endl;
+        }
+        out() << "   return true;" << std::endl;
+
+        out() << "}" << std::endl;
+        out() << std::endl;
+    }
+
     void GomCodeGenerator::generate_signal_adapter(MetaSignal* signal) {
         out() << "void "
               << signal->container_meta_class()->name()
@@ -739,6 +821,19 @@ namespace OGF {
             "__" + method->name() + "__";
     }
 
+    std::string GomCodeGenerator::positional_adapter_name(
+        MetaMethod* method
+    ) {
+        return method_adapter_name(method) + "positional__";
+    }
+
+    bool GomCodeGenerator::takes_arglist(MetaMethod* method) {
+        return (
+            method->nb_args() == 1 &&
+            method->ith_arg(0)->type_name() == "OGF::ArgList"
+        );
+    }
+
     std::string GomCodeGenerator::factory_name(MetaConstructor* method) {
         return "GOM__" +
             colons_to_underscores(method->container_meta_class()->name()) +
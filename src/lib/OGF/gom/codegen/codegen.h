@@ -156,6 +156,16 @@ namespace OGF {
          */
         void generate_method_adapter_arglist(MetaMethod* method);
 
+        /**
+         * \brief Generates a positional method adapter.
+         * \details The generated adapter takes the arguments already
+         *  resolved and ordered as in the method declaration.
+         *  C++ code is generated in the stream returned by out().
+         * \param[in] method a pointer to the MetaMethod
+         * \see generate_method_adapter(), gom_method_positional_adapter
+         */
+        void generate_positional_adapter(MetaMethod* method);
+
         /**
          * \brief Generates a signal adapter.
          * \details C++ code is generated in the stream returned by out().
@@ -226,6 +236,23 @@ namespace OGF {
          */
         std::string method_adapter_name(MetaMethod* method);
 
+        /**
+         * \brief Generates a C++ name for a positional method adapter
+         *  from a MetaMethod.
+         * \param[in] method a pointer to the MetaMethod
+         * \return a valid and unique C++ name for a positional adapter
+         */
+        std::string positional_adapter_name(MetaMethod* method);
+
+        /**
+         * \brief Tests whether a method takes a single ArgList argument.
+         * \param[in] method a pointer to the MetaMethod
+         * \retval true if \p method takes a single argument of type
+         *  OGF::ArgList
+         * \retval false otherwise
+         */
+        bool takes_arglist(MetaMethod* method);
+
         /**
          * \brief Generates a C++ name for a factory from
          *  a MetaMethod.
@@ -39,8 +39,10 @@
 #include <OGF/gom/types/gom.h>
 #include <OGF/gom/types/gom_implementation.h>
 #include <OGF/gom/interpreter/interpreter.h>
+#include <OGF/gom/reflection/meta_class.h>
 #include <OGF/basic/modules/module.h>
 #include <geogram/basic/geometry.h>
+#include <geogram/basic/command_line.h>
 #include <string>
 
 namespace GEO {
@@ -148,6 +150,13 @@ namespace OGF {
 
         //_____________________________________________________________
 
+        if(
+            CmdLine::arg_is_declared("dbg:gom_stats") &&
+            CmdLine::get_arg_bool("dbg:gom_stats")
+        ) {
+            MetaClass::show_member_cache_statistics();
+        }
+
         Meta::terminate();
 	Interpreter::terminate();
 
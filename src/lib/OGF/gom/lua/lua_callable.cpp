@@ -108,6 +108,7 @@ namespace OGF {
 		lua_pcall(lua_state_, int(args.nb_args()), 1, 0) == 0
 	    );
 	}
+	lua_flush_elements_modified();
 
 	if(result) {
 	    lua_tographiteval(lua_state_,-1,ret_val);
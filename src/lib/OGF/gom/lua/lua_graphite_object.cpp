@@ -53,6 +53,46 @@ namespace OGF {
 
 	/*********************************************************************/
 
+	/**
+	 * \brief The objects that had elements written in place from LUA
+	 *  since the latest call to lua_flush_elements_modified().
+	 */
+	static std::vector<Object_var> elements_modified;
+
+	/**
+	 * \brief Defers the notification of an object that had elements
+	 *  written in place.
+	 * \param[in] object a pointer to the object
+	 * \see lua_flush_elements_modified()
+	 */
+	static void defer_elements_modified(Object* object) {
+	    // Most of the time, the same object is written several times.
+	    if(
+		!elements_modified.empty() &&
+		elements_modified.back().get() == object
+	    ) {
+		return;
+	    }
+	    for(const Object_var& o: elements_modified) {
+		if(o.get() == object) {
+		    return;
+		}
+	    }
+	    elements_modified.push_back(object);
+	}
+
+	void lua_flush_elements_modified() {
+	    if(elements_modified.empty()) {
+		return;
+	    }
+	    // Notification may run LUA code that writes elements again.
+	    std::vector<Object_var> objects;
+	    objects.swap(elements_modified);
+	    for(const Object_var& o: objects) {
+		o->notify_elements_modified();
+	    }
+	}
+
 	/**
 	 * \brief Tests whether an object in the Lua stack is a name-value table
 	 * \param[in] L a pointer to the LUA state.
@@ -365,6 +405,340 @@ namespace OGF {
 	    return 1;
 	}
 
+	/**
+	 * \brief Types of the elements that are read and written in place
+	 *  by the array fast path.
+	 * \see Object::get_elements_data()
+	 */
+	enum ElementType {
+	    ELEMENT_OTHER,
+	    ELEMENT_DOUBLE,
+	    ELEMENT_FLOAT,
+	    ELEMENT_INT32,
+	    ELEMENT_UINT32,
+	    ELEMENT_UINT8,
+	    ELEMENT_BOOL
+	};
+
+	/**
+	 * \brief Gets direct access to the elements of an object.
+	 * \param[in] object a pointer to the object
+	 * \param[out] data a pointer to the first element
+	 * \param[out] read_only true if the elements cannot be modified
+	 * \return the type of the elements, or ELEMENT_OTHER if they cannot
+	 *  be accessed in place (then the generic path needs to be used).
+	 */
+	static ElementType get_elements_data(
+	    Object* object, Memory::pointer& data, bool& read_only
+	) {
+	    MetaType* mtype = nullptr;
+	    if(
+		object == nullptr ||
+		!object->get_elements_data(data, mtype, read_only) ||
+		data == nullptr
+	    ) {
+		return ELEMENT_OTHER;
+	    }
+	    if(mtype == ogf_meta<double>::type()) {
+		return ELEMENT_DOUBLE;
+	    }
+	    if(mtype == ogf_meta<float>::type()) {
+		return ELEMENT_FLOAT;
+	    }
+	    if(mtype == ogf_meta<Numeric::int32>::type()) {
+		return ELEMENT_INT32;
+	    }
+	    if(mtype == ogf_meta<Numeric::uint32>::type()) {
+		return ELEMENT_UINT32;
+	    }
+	    if(mtype == ogf_meta<Numeric::uint8>::type()) {
+		return ELEMENT_UINT8;
+	    }
+	    if(mtype == ogf_meta<bool>::type()) {
+		return ELEMENT_BOOL;
+	    }
+	    return ELEMENT_OTHER;
+	}
+
+	/**
+	 * \brief Reads a value from memory.
+	 * \details Memory::copy() avoids alignment assumptions, and
+	 *  compiles to a single load.
+	 */
+	template <class T> inline T load_element(Memory::pointer p) {
+	    T result;
+	    Memory::copy(&result, p, sizeof(T));
+	    return result;
+	}
+
+	/**
+	 * \brief Writes a value to memory.
+	 */
+	template <class T> inline void store_element(Memory::pointer p, T x) {
+	    Memory::copy(p, &x, sizeof(T));
+	}
+
+	/**
+	 * \brief Pushes an element onto the LUA stack.
+	 * \param[in] L a pointer to the LUA state.
+	 * \param[in] type the type of the elements, not ELEMENT_OTHER
+	 * \param[in] data a pointer to the first element
+	 * \param[in] i the index of the element
+	 */
+	static void lua_pushelement(
+	    lua_State* L, ElementType type, Memory::pointer data, index_t i
+	) {
+	    switch(type) {
+	    case ELEMENT_DOUBLE:
+		lua_pushnumber(
+		    L, lua_Number(load_element<double>(data + 8*size_t(i)))
+		);
+		break;
+	    case ELEMENT_FLOAT:
+		lua_pushnumber(
+		    L, lua_Number(load_element<float>(data + 4*size_t(i)))
+		);
+		break;
+	    case ELEMENT_INT32:
+		lua_pushinteger(
+		    L, lua_Integer(
+			load_element<Numeric::int32>(data + 4*size_t(i))
+		    )
+		);
+		break;
+	    case ELEMENT_UINT32:
+		lua_pushinteger(
+		    L, lua_Integer(
+			load_element<Numeric::uint32>(data + 4*size_t(i))
+		    )
+		);
+		break;
+	    case ELEMENT_UINT8:
+		lua_pushinteger(L, lua_Integer(data[i]));
+		break;
+	    case ELEMENT_BOOL:
+		lua_pushboolean(L, data[i] != 0);
+		break;
+	    case ELEMENT_OTHER:
+		geo_assert_not_reached;
+	    }
+	}
+
+	/**
+	 * \brief Writes an element from the LUA stack.
+	 * \param[in] L a pointer to the LUA state.
+	 * \param[in] index the stack index of the value
+	 * \param[in] type the type of the elements, not ELEMENT_OTHER
+	 * \param[in] data a pointer to the first element
+	 * \param[in] i the index of the element
+	 * \retval true if the element could be written
+	 * \retval false if the value is not a number (nor a boolean for
+	 *  boolean elements). Then the generic conversion needs to be used.
+	 */
+	static bool lua_toelement(
+	    lua_State* L, int index,
+	    ElementType type, Memory::pointer data, index_t i
+	) {
+	    if(type == ELEMENT_BOOL && lua_type(L,index) == LUA_TBOOLEAN) {
+		data[i] = Numeric::uint8(lua_toboolean(L,index) ? 1 : 0);
+		return true;
+	    }
+	    if(lua_type(L,index) != LUA_TNUMBER) {
+		return false;
+	    }
+	    if(type == ELEMENT_DOUBLE || type == ELEMENT_FLOAT) {
+		double x = double(lua_tonumber(L,index));
+		if(type == ELEMENT_DOUBLE) {
+		    store_element<double>(data + 8*size_t(i), x);
+		} else {
+		    store_element<float>(data + 4*size_t(i), float(x));
+		}
+		return true;
+	    }
+	    lua_Integer x = lua_isinteger(L,index) ?
+		lua_tointeger(L,index) : lua_Integer(lua_tonumber(L,index));
+	    switch(type) {
+	    case ELEMENT_INT32:
+		store_element<Numeric::int32>(
+		    data + 4*size_t(i), Numeric::int32(x)
+		);
+		break;
+	    case ELEMENT_UINT32:
+		store_element<Numeric::uint32>(
+		    data + 4*size_t(i), Numeric::uint32(x)
+		);
+		break;
+	    case ELEMENT_UINT8:
+		data[i] = Numeric::uint8(x);
+		break;
+	    case ELEMENT_BOOL:
+		data[i] = Numeric::uint8(x != 0 ? 1 : 0);
+		break;
+	    case ELEMENT_DOUBLE:
+	    case ELEMENT_FLOAT:
+	    case ELEMENT_OTHER:
+		geo_assert_not_reached;
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Implementation of get_slice() for objects with
+	 *  direct access to their elements.
+	 * \details Called as v.get_slice(from [,to]), with v as an upvalue.
+	 *  Returns a LUA table with the elements from..to-1 of v,
+	 *  indexed from 1. Default value for to is the number of elements.
+	 * \param[in] L a pointer to the LUA state.
+	 * \return the number of LUA objects pushed onto the stack (here 1).
+	 */
+	static int graphite_vector_get_slice(lua_State* L) {
+	    Object* object = lua_tographite(L,lua_upvalueindex(1));
+	    if(object == nullptr) {
+		return luaL_error(L, "tried to index nil Graphite object");
+	    }
+	    lua_Integer nb = lua_Integer(object->get_nb_elements());
+	    lua_Integer from = luaL_checkinteger(L,1);
+	    lua_Integer to = luaL_optinteger(L,2,nb);
+	    if(from < 0 || from > to || to > nb) {
+		return luaL_error(L, "get_slice(): invalid range");
+	    }
+	    Memory::pointer data = nullptr;
+	    bool read_only = true;
+	    ElementType type = get_elements_data(object, data, read_only);
+	    lua_createtable(L, int(to-from), 0);
+	    for(lua_Integer i=from; i<to; ++i) {
+		if(type != ELEMENT_OTHER) {
+		    lua_pushelement(L, type, data, index_t(i));
+		} else {
+		    Any value;
+		    object->get_element(index_t(i), value);
+		    lua_pushgraphiteval(L, value);
+		}
+		lua_rawseti(L, -2, i-from+1);
+	    }
+	    return 1;
+	}
+
+	/**
+	 * \brief Implementation of set_slice() for objects with
+	 *  direct access to their elements.
+	 * \details Called as v.set_slice(from, values), with v as an upvalue.
+	 *  Copies the LUA table values (indexed from 1) into the elements
+	 *  of v starting from index from. The object is notified once.
+	 * \param[in] L a pointer to the LUA state.
+	 * \return the number of LUA objects pushed onto the stack (here 0).
+	 */
+	static int graphite_vector_set_slice(lua_State* L) {
+	    Object* object = lua_tographite(L,lua_upvalueindex(1));
+	    if(object == nullptr) {
+		return luaL_error(L, "tried to index nil Graphite object");
+	    }
+	    lua_Integer nb = lua_Integer(object->get_nb_elements());
+	    lua_Integer from = luaL_checkinteger(L,1);
+	    luaL_checktype(L,2,LUA_TTABLE);
+	    lua_Integer n = lua_Integer(lua_rawlen(L,2));
+	    if(from < 0 || from + n > nb) {
+		return luaL_error(L, "set_slice(): invalid range");
+	    }
+	    Memory::pointer data = nullptr;
+	    bool read_only = true;
+	    ElementType type = get_elements_data(object, data, read_only);
+	    if(read_only) {
+		type = ELEMENT_OTHER;
+	    }
+	    bool modified = false;
+	    for(lua_Integer k=0; k<n; ++k) {
+		lua_rawgeti(L, 2, k+1);
+		index_t i = index_t(from+k);
+		if(
+		    type != ELEMENT_OTHER &&
+		    lua_toelement(L, -1, type, data, i)
+		) {
+		    modified = true;
+		} else {
+		    Any value;
+		    lua_tographiteval(L, -1, value);
+		    object->set_element(i, value);
+		}
+		lua_pop(L,1);
+	    }
+	    if(modified) {
+		defer_elements_modified(object);
+		lua_flush_elements_modified();
+	    }
+	    return 0;
+	}
+
+	/**
+	 * \brief Implementation of __index() metamethod for graphite objects
+	 *  with direct access to their elements.
+	 * \details Integer indices read the element in place. The get_slice
+	 *  and set_slice keys give the bulk access functions. Everything
+	 *  else is routed to graphite_index().
+	 * \param[in] L a pointer to the LUA state.
+	 * \return the number of LUA objects pushed onto the stack.
+	 */
+	static int graphite_vector_index(lua_State* L) {
+	    if(lua_isinteger(L,2)) {
+		Object* object = lua_tographite(L,1);
+		Memory::pointer data = nullptr;
+		bool read_only = true;
+		ElementType type = get_elements_data(object, data, read_only);
+		lua_Integer i = lua_tointeger(L,2);
+		if(
+		    type != ELEMENT_OTHER && i >= 0 &&
+		    i < lua_Integer(object->get_nb_elements())
+		) {
+		    lua_pushelement(L, type, data, index_t(i));
+		    return 1;
+		}
+		// Other types and invalid indices (reported there)
+		return graphite_array_index(L);
+	    }
+	    if(lua_type(L,2) == LUA_TSTRING) {
+		const char* name = lua_tostring(L,2);
+		if(!strcmp(name,"get_slice")) {
+		    lua_pushvalue(L,1);
+		    lua_pushcclosure(L,graphite_vector_get_slice,1);
+		    return 1;
+		}
+		if(!strcmp(name,"set_slice")) {
+		    lua_pushvalue(L,1);
+		    lua_pushcclosure(L,graphite_vector_set_slice,1);
+		    return 1;
+		}
+	    }
+	    return graphite_index(L);
+	}
+
+	/**
+	 * \brief Implementation of __newindex() metamethod for graphite
+	 *  objects with direct access to their elements.
+	 * \details Numbers (and booleans for boolean elements) written at
+	 *  integer indices are stored in place. Everything else is routed
+	 *  to graphite_newindex().
+	 * \param[in] L a pointer to the LUA state.
+	 * \return the number of LUA objects pushed onto the stack.
+	 */
+	static int graphite_vector_newindex(lua_State* L) {
+	    if(lua_isinteger(L,2)) {
+		Object* object = lua_tographite(L,1);
+		Memory::pointer data = nullptr;
+		bool read_only = true;
+		ElementType type = get_elements_data(object, data, read_only);
+		lua_Integer i = lua_tointeger(L,2);
+		if(
+		    type != ELEMENT_OTHER && !read_only && i >= 0 &&
+		    i < lua_Integer(object->get_nb_elements()) &&
+		    lua_toelement(L, 3, type, data, index_t(i))
+		) {
+		    defer_elements_modified(object);
+		    return 0;
+		}
+	    }
+	    return graphite_newindex(L);
+	}
+
 	/**
 	 * \brief Implementation of __gc() metamethod for graphite objects.
 	 * \param[in] L a pointer to the LUA state.
@@ -382,6 +756,45 @@ namespace OGF {
 	    return 0;
 	}
 
+	/**
+	 * \brief Maximum number of arguments of the methods that are
+	 *  called by position from Lua.
+	 * \details Methods with more arguments use the ArgList-based
+	 *  invocation.
+	 */
+	static constexpr index_t MAX_POSITIONAL_ARGS = 16;
+
+	/**
+	 * \brief Invokes a request with the arguments passed by position.
+	 * \details The LUA arguments, from stack index 2 to the end of the
+	 *  stack, are converted to the types of the method arguments, and
+	 *  missing trailing arguments get their default values.
+	 * \param[in] L a pointer to the LUA state.
+	 * \param[in] r the request.
+	 * \param[out] result the return value of the method.
+	 * \retval true if the method could be invoked.
+	 * \retval false otherwise.
+	 * \pre r->method()->nb_args() <= MAX_POSITIONAL_ARGS
+	 * \pre the number of LUA arguments is not larger than
+	 *  r->method()->nb_args()
+	 */
+	static bool graphite_call_positional(
+	    lua_State* L, Request* r, Any& result
+	) {
+	    MetaMethod* method = r->method();
+	    index_t nb_args = index_t(lua_gettop(L) - 1);
+	    geo_debug_assert(nb_args <= method->nb_args());
+	    Any argv[MAX_POSITIONAL_ARGS];
+	    const Any* argp[MAX_POSITIONAL_ARGS];
+	    for(index_t i=0; i<nb_args; ++i) {
+		lua_tographiteval(
+		    L, 2 + int(i), argv[i], method->ith_arg_cached_type(i)
+		);
+		argp[i] = &argv[i];
+	    }
+	    return r->invoke_positional(argp, nb_args, result);
+	}
+
 	/**
 	 * \brief Implementation of __call() metamethod for graphite callables.
 	 * \details Routes the call to GOM.
@@ -392,6 +805,8 @@ namespace OGF {
 	    if(!lua_isgraphite(L,1)) {
 		geo_assert_not_reached;
 	    }
+	    // The called function may use the elements written from LUA.
+	    lua_flush_elements_modified();
 	    Callable* c = dynamic_cast<Callable*>(lua_tographite(L,1));
 	    if(c == nullptr) {
 		return luaL_error(
@@ -401,22 +816,41 @@ namespace OGF {
 
 	    Request* r = dynamic_cast<Request*>(c);
 	    if(r != nullptr) {
-		ArgList args;
-		// Special case: method has a single argument of type ArgList
-		// -> pack all the arguments in a ArgList
+		MetaMethod* method = r->method();
+		Any result;
+		bool ok = false;
 		if(
-		    r->method()->nb_args() == 1 &&
-		    r->method()->ith_arg_type(0) ==
-		    ogf_meta<OGF::ArgList>::type()
+		    !method->takes_arglist() &&
+		    method->nb_args() <= MAX_POSITIONAL_ARGS &&
+		    !is_namevaluetable(L,2)
 		) {
-		    lua_tographiteargs(L,args,2);
+		    // Fast path: standard call, arguments are converted
+		    // directly to the declared types and passed by position
+		    // (no ArgList, no lookup by name).
+		    if(index_t(lua_gettop(L) - 1) > method->nb_args()) {
+			return luaL_error(
+			    L,(
+				"too many arguments for " +
+				r->object()->meta_class()->name() +
+				"::" + method->name()
+			    ).c_str()
+			);
+		    }
+		    ok = graphite_call_positional(L, r, result);
 		} else {
-		    // Regular case: identify each individual argument according
-		    // to method declaration. Add default values if need be.
-		    lua_tographiteargs(L,args,2,r->method());
+		    ArgList args;
+		    // Special case: method has a single argument of type ArgList
+		    // -> pack all the arguments in a ArgList
+		    if(method->takes_arglist()) {
+			lua_tographiteargs(L,args,2);
+		    } else {
+			// Name-value pairs call (or method with many args):
+			// identify each individual argument according to
+			// method declaration.
+			lua_tographiteargs(L,args,2,method);
+		    }
+		    ok = r->invoke(args, result);
 		}
-		Any result;
-		bool ok = r->invoke(args, result);
 		if(!ok) {
 		    return luaL_error(
 			L,(
@@ -479,53 +913,70 @@ namespace OGF {
 	    return 1;
 	}
 
-	/*********************************************************************/
+	/**
+	 * \brief Creates a "metatable" for graphite objects and pushes it
+	 *  onto the LUA stack.
+	 * \param[in] L a pointer to the LUA state.
+	 * \param[in] index_func the implementation of __index()
+	 * \param[in] newindex_func the implementation of __newindex()
+	 */
+	static void create_graphite_vtbl(
+	    lua_State* L, lua_CFunction index_func, lua_CFunction newindex_func
+	) {
+	    lua_newtable(L);
 
-	void init_lua_graphite(LuaInterpreter* interpreter) {
-	    lua_State* L = interpreter->lua_state();
+	    // Attribute access (read)
+	    lua_pushliteral(L,"__index");
+	    lua_pushcfunction(L,index_func);
+	    lua_settable(L,-3);
 
-	    // Create the "metatable" for
-	    // graphite objects.
-	    {
-		lua_newtable(L);
+	    // Attribute access (write)
+	    lua_pushliteral(L,"__newindex");
+	    lua_pushcfunction(L,newindex_func);
+	    lua_settable(L,-3);
 
-		// Attribute access (read)
-		lua_pushliteral(L,"__index");
-		lua_pushcfunction(L,graphite_index);
-		lua_settable(L,-3);
+	    // Length
+	    lua_pushliteral(L,"__len");
+	    lua_pushcfunction(L,graphite_array_len);
+	    lua_settable(L,-3);
 
-		// Attribute access (write)
-		lua_pushliteral(L,"__newindex");
-		lua_pushcfunction(L,graphite_newindex);
-		lua_settable(L,-3);
+	    // Garbage collection of Graphite objects
+	    lua_pushliteral(L,"__gc");
+	    lua_pushcfunction(L,graphite_gc);
+	    lua_settable(L,-3);
 
-		// Length
-		lua_pushliteral(L,"__len");
-		lua_pushcfunction(L,graphite_array_len);
-		lua_settable(L,-3);
+	    // Function call
+	    lua_pushliteral(L,"__call");
+	    lua_pushcfunction(L,graphite_call);
+	    lua_settable(L,-3);
 
-		// Garbage collection of Graphite objects
-		lua_pushliteral(L,"__gc");
-		lua_pushcfunction(L,graphite_gc);
-		lua_settable(L,-3);
+	    // String conversion
+	    lua_pushliteral(L,"__tostring");
+	    lua_pushcfunction(L,graphite_tostring);
+	    lua_settable(L,-3);
 
-		// Function call
-		lua_pushliteral(L,"__call");
-		lua_pushcfunction(L,graphite_call);
-		lua_settable(L,-3);
+	    // Equality
+	    lua_pushliteral(L,"__eq");
+	    lua_pushcfunction(L,graphite_equals);
+	    lua_settable(L,-3);
+	}
 
-		// String conversion
-		lua_pushliteral(L,"__tostring");
-		lua_pushcfunction(L,graphite_tostring);
-		lua_settable(L,-3);
+	/*********************************************************************/
 
-		// Equality
-		lua_pushliteral(L,"__eq");
-		lua_pushcfunction(L,graphite_equals);
-		lua_settable(L,-3);
+	void init_lua_graphite(LuaInterpreter* interpreter) {
+	    lua_State* L = interpreter->lua_state();
 
-		lua_setfield(L, LUA_REGISTRYINDEX, "graphite_vtbl");
-	    }
+	    // Create the "metatable" for
+	    // graphite objects.
+	    create_graphite_vtbl(L, graphite_index, graphite_newindex);
+	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_vtbl");
+
+	    // Create the "metatable" for graphite objects with
+	    // direct access to their elements (NL::Vector).
+	    create_graphite_vtbl(
+		L, graphite_vector_index, graphite_vector_newindex
+	    );
+	    lua_setfield(L, LUA_REGISTRYINDEX, "graphite_vector_vtbl");
 
 	    // Create the global table for gom2lua connections
 	    {
@@ -555,7 +1006,16 @@ namespace OGF {
 	    if(managed && object != nullptr) {
 		GR->object->ref();
 	    }
-	    lua_getfield(L,LUA_REGISTRYINDEX,"graphite_vtbl");
+	    // Objects with direct access to their elements get the
+	    // metatable with the fast array path.
+	    Memory::pointer data = nullptr;
+	    MetaType* element_meta_type = nullptr;
+	    bool read_only = true;
+	    if(object->get_elements_data(data, element_meta_type, read_only)) {
+		lua_getfield(L,LUA_REGISTRYINDEX,"graphite_vector_vtbl");
+	    } else {
+		lua_getfield(L,LUA_REGISTRYINDEX,"graphite_vtbl");
+	    }
 	    lua_setmetatable(L,-2);
 	}
 
@@ -580,10 +1040,18 @@ namespace OGF {
 	    if(!lua_isuserdata(L,index)) {
 		return false;
 	    }
-	    lua_getmetatable(L,index);
+	    if(!lua_getmetatable(L,index)) {
+		return false;
+	    }
 	    lua_getfield(L,LUA_REGISTRYINDEX,"graphite_vtbl");
 	    bool result = (lua_compare(L, -1, -2, LUA_OPEQ) != 0);
-	    lua_pop(L,2);
+	    lua_pop(L,1);
+	    if(!result) {
+		lua_getfield(L,LUA_REGISTRYINDEX,"graphite_vector_vtbl");
+		result = (lua_compare(L, -1, -2, LUA_OPEQ) != 0);
+		lua_pop(L,1);
+	    }
+	    lua_pop(L,1);
 	    return result;
 	}
 
@@ -119,6 +119,18 @@ namespace OGF {
 	 * \param[in] interpreter a pointer to the LuaInterpreter.
 	 */
 	void init_lua_graphite(LuaInterpreter* interpreter);
+
+	/**
+	 * \brief Notifies the objects that had elements written in place
+	 *  from LUA.
+	 * \details Writing an element from LUA (v[i] = x) does not notify
+	 *  the object each time, since this may update a Grob. The
+	 *  notifications are deferred to the next call of a Graphite
+	 *  function from LUA, or to the end of the LUA command or callback,
+	 *  where this function is called.
+	 * \see Object::notify_elements_modified()
+	 */
+	void lua_flush_elements_modified();
     }
 }
 
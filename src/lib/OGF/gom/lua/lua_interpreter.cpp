@@ -191,6 +191,7 @@ namespace OGF {
 	    display_error_message(msg);
 	    result = false;
 	}
+	lua_flush_elements_modified();
         return result;
     }
 
@@ -210,6 +211,7 @@ namespace OGF {
 	    Logger::err("Lua") << msg << std::endl;
 	    result = false;
 	}
+	lua_flush_elements_modified();
         return result;
     }
 
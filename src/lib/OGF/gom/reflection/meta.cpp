@@ -35,6 +35,7 @@
  */
 
 #include <OGF/gom/reflection/meta.h>
+#include <OGF/gom/reflection/meta_class.h>
 #include <OGF/gom/types/gom_implementation.h>
 
 //___________________________________________________
@@ -86,6 +87,7 @@ namespace OGF {
             return false ;
         }
         type_name_to_meta_type_[meta_type->name()] = meta_type ;
+        MetaClass::invalidate_member_caches();
         return true ;
     }
 
@@ -94,6 +96,7 @@ namespace OGF {
     ) {
 	geo_debug_assert(meta_type_is_bound(meta_type->name()));
 	type_name_to_meta_type_[alias] = meta_type ;
+        MetaClass::invalidate_member_caches();
     }
 
     bool Meta::bind_meta_type(
@@ -122,6 +125,7 @@ namespace OGF {
             typeid_name_to_meta_type_[typeid_name] = meta_type ;
             meta_type->set_typeid_name(typeid_name);
         }
+        MetaClass::invalidate_member_caches();
         return true ;
     }
 
@@ -147,6 +151,7 @@ namespace OGF {
                 }
             }
         }
+        MetaClass::invalidate_member_caches();
         return true ;
     }
 
@@ -38,6 +38,8 @@
 #include <OGF/gom/reflection/meta_constructor.h>
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/gom/reflection/dynamic_object.h>
+#include <geogram/basic/stopwatch.h>
+#include <atomic>
 
 /*****************************************************************************/
 
@@ -93,6 +95,22 @@ namespace {
         }
         return result;
     }
+
+    /**
+     * \brief Statistics about MetaClass member lookup tables.
+     * \details Updated by MetaClass::find_member() when called with
+     *  super=true.
+     */
+    struct MemberCacheStatistics {
+        std::atomic<Numeric::uint64> nb_hits{0};
+        std::atomic<Numeric::uint64> nb_misses{0};
+        std::atomic<Numeric::uint64> nb_found{0};
+        std::atomic<Numeric::uint64> nb_rebuilds{0};
+        std::atomic<Numeric::uint64> nb_compares_saved{0};
+        std::atomic<Numeric::uint64> rebuild_time_us{0};
+    };
+
+    MemberCacheStatistics member_cache_stats;
 }
 
 /*****************************************************************************/
@@ -108,6 +126,7 @@ namespace OGF {
             set_factory(new FactoryMetaClass(this));
         }
 	instance_ = nullptr;
+        member_cache_ = nullptr;
     }
 
     MetaClass::MetaClass(
@@ -118,9 +137,15 @@ namespace OGF {
         if(!abstract) {
             set_factory(new FactoryMetaClass(this));
         }
+	instance_ = nullptr;
+        member_cache_ = nullptr;
     }
 
     MetaClass::~MetaClass() {
+        delete member_cache_.load();
+        for(const MemberTable* table : member_cache_retired_) {
+            delete table;
+        }
     }
 
     Object* MetaClass::create(const ArgList& args) {
@@ -257,18 +282,136 @@ namespace OGF {
         }
     }
 
+    std::atomic<index_t> MetaClass::members_timestamp_(0);
+
+    void MetaClass::add_member(MetaMember* member) {
+        members_.push_back(member);
+        invalidate_member_caches();
+    }
+
+    void MetaClass::invalidate_member_caches() {
+        members_timestamp_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    const MetaClass::MemberTable* MetaClass::update_member_cache() const {
+        std::lock_guard<std::mutex> lock(member_cache_lock_);
+        index_t timestamp = members_timestamp_.load(std::memory_order_acquire);
+        const MemberTable* table = member_cache_.load(
+            std::memory_order_acquire
+        );
+        // Another thread may have rebuilt the table in the meanwhile
+        if(table != nullptr && table->timestamp == timestamp) {
+            return table;
+        }
+        Stopwatch W("GOM",false);
+        MemberTable* new_table = new MemberTable;
+        index_t rank = 0;
+        for(
+            const MetaClass* mclass = this; mclass != nullptr;
+            mclass = mclass->super_class()
+        ) {
+            for(const MetaMember_var& cur : mclass->members_) {
+                ++rank;
+                // emplace() does not replace existing entries, so that
+                // members of derived classes shadow inherited ones, as
+                // in the linear search.
+                new_table->members.emplace(
+                    cur->name(), std::make_pair(cur.get(), rank)
+                );
+            }
+        }
+        new_table->nb_members = rank;
+        new_table->timestamp = timestamp;
+        if(table != nullptr) {
+            member_cache_retired_.push_back(table);
+        }
+        member_cache_.store(new_table, std::memory_order_release);
+        member_cache_stats.nb_rebuilds.fetch_add(
+            1, std::memory_order_relaxed
+        );
+        member_cache_stats.rebuild_time_us.fetch_add(
+            Numeric::uint64(W.elapsed_time() * 1e6),
+            std::memory_order_relaxed
+        );
+        return new_table;
+    }
+
+    void MetaClass::show_member_cache_statistics() {
+        const MemberCacheStatistics& S = member_cache_stats;
+        Numeric::uint64 nb_hits = S.nb_hits;
+        Numeric::uint64 nb_misses = S.nb_misses;
+        Numeric::uint64 nb_lookups = nb_hits + nb_misses;
+        Numeric::uint64 nb_rebuilds = S.nb_rebuilds;
+        Numeric::uint64 nb_compares_saved = S.nb_compares_saved;
+        Logger::out("GOM") << "Member lookups: " << nb_lookups
+                           << " (found: " << S.nb_found << ")"
+                           << std::endl;
+        if(nb_lookups != 0) {
+            // hit: the lookup table was up to date,
+            // miss: the lookup table needed to be rebuilt.
+            Logger::out("GOM")
+                << "Member lookup table hit rate: "
+                << 100.0 * double(nb_hits) / double(nb_lookups) << "%"
+                << std::endl;
+            Logger::out("GOM")
+                << "String comparisons saved: " << nb_compares_saved
+                << " (" << double(nb_compares_saved) / double(nb_lookups)
+                << " per lookup)"
+                << std::endl;
+        }
+        Logger::out("GOM") << "Member lookup tables rebuilt "
+                           << nb_rebuilds << " times in "
+                           << double(S.rebuild_time_us) * 1e-6 << "s"
+                           << std::endl;
+    }
+
     MetaMember* MetaClass::find_member(
         const std::string& member_name, bool super
     ) const {
+        if(super) {
+            // Fast path: the published table is immutable and can be
+            // read without taking the lock.
+            const MemberTable* table = member_cache_.load(
+                std::memory_order_acquire
+            );
+            if(
+                table != nullptr &&
+                table->timestamp ==
+                members_timestamp_.load(std::memory_order_acquire)
+            ) {
+                member_cache_stats.nb_hits.fetch_add(
+                    1, std::memory_order_relaxed
+                );
+            } else {
+                table = update_member_cache();
+                member_cache_stats.nb_misses.fetch_add(
+                    1, std::memory_order_relaxed
+                );
+            }
+            MetaMember* result = nullptr;
+            index_t nb_compares = table->nb_members;
+            auto it = table->members.find(member_name);
+            if(it != table->members.end()) {
+                result = it->second.first;
+                nb_compares = it->second.second;
+                member_cache_stats.nb_found.fetch_add(
+                    1, std::memory_order_relaxed
+                );
+            }
+            // One hashed lookup replaces nb_compares string comparisons
+            if(nb_compares > 1) {
+                member_cache_stats.nb_compares_saved.fetch_add(
+                    nb_compares - 1, std::memory_order_relaxed
+                );
+            }
+            return result;
+        }
         for(unsigned int i=0; i<members_.size(); i++) {
             MetaMember* cur = members_[i];
             if(cur->name() == member_name) {
                 return cur;
             }
         }
-        if(super && super_class() != nullptr) {
-            return super_class()->find_member(member_name, true);
-        }
         return nullptr;
     }
 
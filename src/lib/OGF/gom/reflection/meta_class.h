@@ -48,6 +48,9 @@
 
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 /**
  * \file OGF/gom/reflection/meta_class.h
@@ -324,9 +327,7 @@ namespace OGF {
          *  to be added. Ownership is transfered to this
          *  MetaClass.
          */
-        void add_member(MetaMember* member) {
-            members_.push_back(member);
-        }
+        void add_member(MetaMember* member);
 
         /**
          * \brief Gets all the members
@@ -470,6 +471,22 @@ namespace OGF {
 	    instance_ = object;
 	}
 
+        /**
+         * \brief Invalidates the member lookup tables of all MetaClasses.
+         * \details Called each time a member is added to a MetaClass
+         *  and each time a MetaType is bound or unbound, since this can
+         *  change the members inherited by the subclasses. The tables
+         *  are lazily rebuilt by the next call to find_member().
+         */
+        static void invalidate_member_caches();
+
+        /**
+         * \brief Displays statistics about the member lookup tables
+         *  (number of lookups, hit rate and string comparisons saved
+         *  as compared to a linear search).
+         */
+        static void show_member_cache_statistics();
+
     protected:
 
         /**
@@ -533,6 +550,33 @@ namespace OGF {
             std::vector<MetaProperty*>& result, bool super = true
         ) const;
 
+        /**
+         * \brief A flattened member lookup table.
+         * \details Contains the members declared in a class and the
+         *  inherited ones. If a name is declared several times, the
+         *  member that was first found by the linear search (i.e., the
+         *  one of the most derived class) is kept. Each entry also
+         *  stores the number of string comparisons that the linear
+         *  search needs to find the member (used for statistics).
+         *  A table is never modified once it is published, so that it
+         *  can be read without locking.
+         */
+        struct MemberTable {
+            std::unordered_map<
+                std::string, std::pair<MetaMember*, index_t>
+            > members;
+            index_t nb_members;
+            index_t timestamp;
+        };
+
+        /**
+         * \brief Gets the flattened member lookup table, and rebuilds
+         *  it if it was invalidated since its last construction.
+         * \return a pointer to an up-to-date table. It remains valid
+         *  until this MetaClass is destroyed.
+         */
+        const MemberTable* update_member_cache() const;
+
     private:
         std::string super_class_name_;
         std::vector<MetaMember_var> members_;
@@ -540,6 +584,12 @@ namespace OGF {
         Factory_var factory_;
         friend class ::OGF::MetaConstructor;
 	Object* instance_; // For singletons
+
+        mutable std::atomic<const MemberTable*> member_cache_;
+        // Outdated tables, kept alive for concurrent readers
+        mutable std::vector<const MemberTable*> member_cache_retired_;
+        mutable std::mutex member_cache_lock_;
+        static std::atomic<index_t> members_timestamp_;
     };
 
     /**
@@ -44,13 +44,47 @@
 
 namespace OGF {
 
+    namespace {
+
+        /**
+         * \brief Pointers to the argument values passed to a positional
+         *  method adapter.
+         * \details Stored on the stack for the common case of methods
+         *  with few arguments.
+         */
+        class PositionalArgs {
+        public:
+            explicit PositionalArgs(size_t nb) : nb_(nb) {
+                if(nb_ > NB_STATIC) {
+                    dynamic_.resize(nb_);
+                }
+            }
+
+            const Any*& operator[](index_t i) {
+                geo_debug_assert(i < nb_);
+                return (nb_ > NB_STATIC) ? dynamic_[i] : static_[i];
+            }
+
+            const Any* const* data() const {
+                return (nb_ > NB_STATIC) ? dynamic_.data() : static_;
+            }
+
+        private:
+            enum { NB_STATIC = 16 };
+            size_t nb_;
+            const Any* static_[NB_STATIC];
+            std::vector<const Any*> dynamic_;
+        };
+    }
+
     MetaMethod::MetaMethod(
         const std::string& name,
         MetaClass* container,
         const std::string& return_type_name 
     ) : MetaMember(name,container),
         return_type_name_(return_type_name), 
-        adapter_(nullptr) {
+        adapter_(nullptr),
+        positional_adapter_(nullptr) {
     }
     
     MetaMethod::MetaMethod(
@@ -59,7 +93,8 @@ namespace OGF {
         MetaType* return_type
     ) : MetaMember(name,container),
         return_type_name_(return_type->name()), 
-        adapter_(nullptr) {
+        adapter_(nullptr),
+        positional_adapter_(nullptr) {
     }
 
     MetaMethod::~MetaMethod(){
@@ -68,6 +103,19 @@ namespace OGF {
     void MetaMethod::pre_delete() {
 	MetaMember::pre_delete();
 	meta_args_.clear();
+	arg_types_cache_.clear();
+    }
+
+    void MetaMethod::cache_arg_types() {
+        arg_types_cache_.clear();
+        for(index_t i=0; i<nb_args(); ++i) {
+            MetaType* type = meta_args_[i].type();
+            if(type == nullptr) {
+                arg_types_cache_.clear();
+                return;
+            }
+            arg_types_cache_.push_back(type);
+        }
     }
 
 
@@ -159,29 +207,94 @@ namespace OGF {
                                       << std::endl ;
             return false ;
         }
-        if(!check_args(args)) {
-            Logger::err("MetaMethod") << "MetaMethod "
-                                      << container_meta_class()->name()
-                                      << "::"
-                                      << name()
-                                      << " : missing arguments"
+
+        // If a positional adapter is available, resolve the arguments
+        // by position: no lookup by name in the adapter, and no copy of
+        // the ArgList when default values are needed.
+        if(positional_adapter() != nullptr) {
+            PositionalArgs argv(nb_args());
+            bool args_ok = true;
+            for(index_t i=0; i<nb_args(); ++i) {
+                const MetaArg* arg = ith_arg(i) ;
+                // Fast path: arguments given in declaration order.
+                index_t j = (
+                    i < args.nb_args() && args.ith_arg_name(i) == arg->name()
+                ) ? i : args.find_arg_index(arg->name()) ;
+                if(j != NO_INDEX) {
+                    argv[i] = &args.ith_arg_value(j) ;
+                } else if(arg->has_default_value()) {
+                    argv[i] = &arg->default_value() ;
+                } else {
+                    args_ok = false;
+                    break;
+                }
+            }
+            if(args_ok) {
+                return positional_adapter()(
+                    target, argv.data(), return_value
+                ) ;
+            }
+        } else if(check_args(args)) {
+            if(nb_default_args(args) != 0) {
+                ArgList all_args = args ;
+                add_default_args(all_args) ;
+                return method_adapter()(
+                    target, name(), all_args, return_value
+                ) ;
+            }
+            return method_adapter()(target, name(), args, return_value) ;
+        }
+
+        Logger::err("MetaMethod") << "MetaMethod "
+                                  << container_meta_class()->name()
+                                  << "::"
+                                  << name()
+                                  << " : missing arguments"
+                                  << std::endl ;
+        Logger::err("MetaMethod") << " got:   " << std::endl ;
+        for(unsigned int i=0; i<args.nb_args(); i++) {
+            Logger::err("MetaMethod") << "    "
+                                      << args.ith_arg_name(i)
+                                      << " = "
+                                      << args.ith_arg_value(i).as_string()
                                       << std::endl ;
-            Logger::err("MetaMethod") << " got:   " << std::endl ;
-            for(unsigned int i=0; i<args.nb_args(); i++) {
-                Logger::err("MetaMethod") << "    "
-                                          << args.ith_arg_name(i)
-                                          << " = "
-                                          << args.ith_arg_value(i).as_string()
+        }
+        return false ;
+    }
+
+    bool MetaMethod::invoke_positional(
+        Object* target, const Any* const* args, index_t nb_positional_args,
+        Any& return_value
+    ) {
+        ogf_assert(nb_positional_args <= nb_args()) ;
+        for(index_t i=nb_positional_args; i<nb_args(); ++i) {
+            if(!ith_arg(i)->has_default_value()) {
+                Logger::err("MetaMethod") << "MetaMethod "
+                                          << container_meta_class()->name()
+                                          << "::"
+                                          << name()
+                                          << " : missing argument "
+                                          << ith_arg_name(i)
                                           << std::endl ;
+                return false ;
             }
-            return false ;
         }
-        if(nb_default_args(args) != 0) {
-            ArgList all_args = args ;
-            add_default_args(all_args) ;
-            return method_adapter()(target, name(), all_args, return_value) ;
+        if(positional_adapter() == nullptr) {
+            ArgList all_args ;
+            for(index_t i=0; i<nb_positional_args; ++i) {
+                all_args.create_arg(ith_arg_name(i), *args[i]) ;
+            }
+            return invoke(target, all_args, return_value) ;
+        }
+        if(nb_positional_args == nb_args()) {
+            return positional_adapter()(target, args, return_value) ;
+        }
+        PositionalArgs argv(nb_args());
+        for(index_t i=0; i<nb_args(); ++i) {
+            argv[i] = (i < nb_positional_args) ?
+                args[i] : &ith_arg(i)->default_value() ;
         }
-        return method_adapter()(target, name(), args, return_value) ;
+        return positional_adapter()(target, argv.data(), return_value) ;
     }
 
     bool MetaMethod::emit_signal(
@@ -66,6 +66,22 @@ namespace OGF {
         Any& ret_val
     ) ;
 
+    /**
+     * \brief Function pointer type for positional method adapters.
+     * \details A positional method adapter does the same thing as a
+     *  gom_method_adapter, except that the arguments are already resolved
+     *  and ordered as in the method declaration, hence no lookup by name
+     *  nor ArgList allocation is needed. Positional method adapters are
+     *  automatically generated by the GOM generator.
+     * \param[in] target the target object
+     * \param[in] args an array of pointers to the argument values, one
+     *  per argument of the method, in declaration order
+     * \param[out] ret_val the return value
+     */
+    typedef bool (*gom_method_positional_adapter)(
+        Object* target, const Any* const* args, Any& ret_val
+    ) ;
+
     /**
      * \brief The representation of a method in the Meta repository.
      */
@@ -279,6 +295,42 @@ namespace OGF {
          */
         void add_arg(const MetaArg& arg) {
             meta_args_.push_back(arg) ;
+            arg_types_cache_.clear() ;
+        }
+
+        /**
+         * \brief Gets the type of an argument by index, using a cache.
+         * \details Unlike ith_arg_type(), that resolves the type by name
+         *  each time it is called, the types of all the arguments are
+         *  resolved once and kept. Used by the scripting language bindings
+         *  on each call.
+         * \param[in] i index of the argument
+         * \return a pointer to the MetaType of the \p i th argument
+         * \pre i < nb_args()
+         */
+        MetaType* ith_arg_cached_type(index_t i) {
+            ogf_assert(i < meta_args_.size());
+            if(arg_types_cache_.size() != meta_args_.size()) {
+                cache_arg_types();
+            }
+            return (arg_types_cache_.size() == meta_args_.size()) ?
+                arg_types_cache_[i] : meta_args_[i].type() ;
+        }
+
+        /**
+         * \brief Tests whether this method takes a single ArgList
+         *  argument.
+         * \details Such methods receive all the arguments packed in an
+         *  ArgList, and cannot be invoked by position.
+         * \retval true if this method takes a single argument of type
+         *  OGF::ArgList
+         * \retval false otherwise
+         */
+        bool takes_arglist() const {
+            return (
+                meta_args_.size() == 1 &&
+                meta_args_[0].type_name() == "OGF::ArgList"
+            );
         }
 
         /**
@@ -324,6 +376,43 @@ namespace OGF {
             adapter_ = adapter ;
         }
 
+        /**
+         * \brief Gets the positional method adapter.
+         * \return the positional method adapter if available, else nil
+         * \see gom_method_positional_adapter
+         */
+        gom_method_positional_adapter positional_adapter() const {
+            return positional_adapter_ ;
+        }
+
+        /**
+         * \brief Sets the positional method adapter.
+         * \param[in] adapter the positional method adapter
+         * \see gom_method_positional_adapter
+         */
+        void set_positional_adapter(gom_method_positional_adapter adapter) {
+            positional_adapter_ = adapter ;
+        }
+
+        /**
+         * \brief Invokes this method with arguments passed by position.
+         * \details Uses the positional method adapter if available, else
+         *  falls back to invoke() with an ArgList created from the
+         *  arguments. Missing trailing arguments are replaced with their
+         *  default values.
+         * \param[in] target a pointer to the target object
+         * \param[in] args an array of pointers to the argument values,
+         *  in declaration order
+         * \param[in] nb_positional_args the number of pointers in \p args
+         * \param[out] return_value the return value
+         * \pre target->meta_class() == meta_class()
+         * \pre nb_positional_args <= nb_args()
+         */
+        bool invoke_positional(
+            Object* target, const Any* const* args, index_t nb_positional_args,
+            Any& return_value
+        ) ;
+
         /**
          * \brief Invokes this method on a target object.
          * \details The default invokation mechanism uses the method
@@ -398,6 +487,14 @@ namespace OGF {
         virtual void add_default_args(ArgList& args) ;
 
     protected:
+        /**
+         * \brief Resolves and caches the types of all the arguments.
+         * \details Nothing is cached if one of the types cannot be
+         *  resolved yet.
+         * \see ith_arg_cached_type()
+         */
+        void cache_arg_types() ;
+
         /**
          * \brief Emits a signal in a target object.
          * \param[in] target a pointer to the target object
@@ -429,6 +526,8 @@ namespace OGF {
         std::string return_type_name_ ;
         MetaArgList meta_args_ ;
         gom_method_adapter adapter_ ;
+        gom_method_positional_adapter positional_adapter_ ;
+        std::vector<MetaType*> arg_types_cache_ ;
     } ;
 
     /**
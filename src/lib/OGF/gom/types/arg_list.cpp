@@ -106,6 +106,27 @@ namespace OGF {
 	//geo_assert_not_reached;
     }
 
+    void ArgList::positional_arg_type_error(
+	const Any& value, index_t i, const std::string& expected_typeid_name
+    ) {
+	MetaType* expected_type = Meta::instance()->
+	    resolve_meta_type_by_typeid_name(expected_typeid_name);
+
+	MetaType* current_type = value.meta_type();
+
+	Logger::err("GOM")
+            << "Arg type error:"
+            << " i = " << i
+            << " type = " <<(
+	    value.is_null() ? "null" : (
+		((current_type != nullptr) ? current_type->name() : "unknown")
+	    ))
+            << " expected type = "
+            << ((expected_type != nullptr) ? expected_type->name() :
+                "unknown: " + expected_typeid_name)
+            << std::endl;
+    }
+
     bool ArgList::get_object_name(const Any& object, Any& name) {
         Object* object_ptr;
         if(!object.get_value(object_ptr)) {
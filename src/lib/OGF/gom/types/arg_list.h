@@ -467,6 +467,42 @@ namespace OGF {
 
 	void serialize(std::ostream& out) const;
 
+        /**
+         * \brief Converts an argument value passed by position.
+         * \details Applies the same conversion rules as get_arg(), but
+         *  works on a value that is not stored in an ArgList. It is used
+         *  by the positional method adapters generated by gomgen.
+         * \param[in] value the argument value
+         * \param[in] i the index of the argument, used in error messages
+         * \return the value of the argument converted to \p T
+         * \tparam T the type of the argument
+         */
+        template <class T> static T positional_arg_value(
+            const Any& value, index_t i
+        ) {
+	    T result;
+	    if(
+                !value.get_value(result) &&
+                !get_name(value, result)
+            ) {
+		positional_arg_type_error(value, i, typeid(T).name());
+	    }
+	    return result;
+        }
+
+	/**
+	 * \brief Displays an error message for invalid argument type
+	 *  in a positional call.
+	 * \param[in] value the value of the concerned argument.
+	 * \param[in] i the index of the concerned argument.
+	 * \param[in] expected_typeid_name the typeid name that corresponds
+	 *  to the expected type (that we did not have).
+	 */
+	static void positional_arg_type_error(
+	    const Any& value, index_t i,
+	    const std::string& expected_typeid_name
+	);
+
 	/**
 	 * \brief Displays an error message for invalid argument type.
 	 * \param[in] i the index of the concerned argument.
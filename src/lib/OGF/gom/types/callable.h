@@ -130,6 +130,26 @@ namespace OGF {
 	  */
 	  bool invoke(const ArgList& args, Any& ret_val) override;
 
+	 /**
+	  * \brief Invokes the method with arguments passed by position.
+	  * \details Bypasses the lookup of the method and of the arguments
+	  *  by name.
+	  * \param[in] args an array of pointers to the argument values,
+	  *  in declaration order
+	  * \param[in] nb_args the number of pointers in \p args
+	  * \param[out] ret_val the return value
+	  * \retval true if the method could be sucessfully invoked
+	  * \retval false otherwise
+	  * \see Object::invoke_method_positional()
+	  */
+	  bool invoke_positional(
+	      const Any* const* args, index_t nb_args, Any& ret_val
+	  ) {
+	      return object_->invoke_method_positional(
+		  method_, args, nb_args, ret_val
+	      );
+	  }
+
 
 	 /**
 	  * \copydoc Object::get_doc()
@@ -183,6 +183,30 @@ namespace OGF {
         return false;
     }
 
+    bool Object::invoke_method_positional(
+        MetaMethod* method, const Any* const* args, index_t nb_args,
+        Any& ret_val
+    ) {
+        if( !slots_enabled_ &&
+            method->name() != "enable_slots" &&
+            method->name() != "slots_enabled"
+        ) {
+            return true;
+        }
+        return method->invoke_positional(this, args, nb_args, ret_val);
+    }
+
+    bool Object::invoke_method_positional_by_name(
+        MetaMethod* method, const Any* const* args, index_t nb_args,
+        Any& ret_val
+    ) {
+        ArgList all_args;
+        for(index_t i=0; i<nb_args; ++i) {
+            all_args.create_arg(method->ith_arg_name(i), *args[i]);
+        }
+        return invoke_method(method->name(), all_args, ret_val);
+    }
+
     void Object::help() const {
         Logger::out("GOM") << get_doc() << std::endl;
     }
@@ -326,6 +350,18 @@ namespace OGF {
 			   << std::endl;
     }
 
+    bool Object::get_elements_data(
+	Memory::pointer& data, MetaType*& element_meta_type, bool& read_only
+    ) {
+	geo_argused(data);
+	geo_argused(element_meta_type);
+	geo_argused(read_only);
+	return false;
+    }
+
+    void Object::notify_elements_modified() {
+    }
+
     std::string Object::get_doc() const {
         return meta_class()->get_doc();
     }
@@ -53,6 +53,7 @@ namespace OGF {
 
     class MetaType;
     class MetaClass;
+    class MetaMethod;
     class Object;
     class Connection;
     class ConnectionTable;
@@ -173,6 +174,28 @@ namespace OGF {
             return invoke_method(method_name, args, ret_val);
         }
 
+        /**
+         * \brief Invokes an already resolved method with arguments
+         *  passed by position.
+         * \details This is the fast path used by the scripting language
+         *  bindings. It does not look up the method nor the arguments by
+         *  name. Classes that override invoke_method() to intercept calls
+         *  should also override this function (for instance by calling
+         *  invoke_method_positional_by_name()).
+         * \param[in] method a pointer to the method, that belongs to the
+         *  meta-class of this Object or one of its super-classes
+         * \param[in] args an array of pointers to the argument values,
+         *  in declaration order
+         * \param[in] nb_args the number of pointers in \p args
+         * \param[out] ret_val the return value as an Any
+         * \retval true if the method could be sucessfully invoked
+         * \retval false otherwise
+         */
+        virtual bool invoke_method_positional(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        );
+
 	/**
 	 * \brief Tests whether a property is defined
          * \param[in] prop_name name of the property
@@ -278,6 +301,33 @@ namespace OGF {
 	    set_element(item * get_dimension() + component, value);
 	}
 
+	/**
+	 * \brief Gets direct access to the elements.
+	 * \details Part of the array interface. Objects that store their
+	 *  elements contiguously override this function, so that scripting
+	 *  languages can read and write them in place instead of going
+	 *  through get_element() and set_element(). After writing elements
+	 *  in place, notify_elements_modified() needs to be called.
+	 * \param[out] data a pointer to the first element. It may change
+	 *  each time the object is modified, and it is nullptr if there
+	 *  is no element.
+	 * \param[out] element_meta_type the type of the elements
+	 * \param[out] read_only true if the elements cannot be modified
+	 * \retval true if the elements can be accessed directly
+	 * \retval false otherwise. Then the output parameters are
+	 *  not modified.
+	 */
+	virtual bool get_elements_data(
+	    Memory::pointer& data, MetaType*& element_meta_type,
+	    bool& read_only
+	);
+
+	/**
+	 * \brief Indicates that elements were written in place.
+	 * \see get_elements_data()
+	 */
+	virtual void notify_elements_modified();
+
         /**
          * \brief Displays the names of all objects that
          *   contain a substring
@@ -487,6 +537,25 @@ namespace OGF {
         ) const;
 
     protected:
+        /**
+         * \brief Invokes a method with arguments passed by position,
+         *  through invoke_method().
+         * \details Creates an ArgList from the arguments and calls
+         *  invoke_method(). Can be used by the classes that override
+         *  invoke_method() to implement invoke_method_positional().
+         * \param[in] method a pointer to the method
+         * \param[in] args an array of pointers to the argument values,
+         *  in declaration order
+         * \param[in] nb_args the number of pointers in \p args
+         * \param[out] ret_val the return value as an Any
+         * \retval true if the method could be sucessfully invoked
+         * \retval false otherwise
+         */
+        bool invoke_method_positional_by_name(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        );
+
 
         /**
          * \brief Sets an individual property
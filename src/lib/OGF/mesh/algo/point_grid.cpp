@@ -0,0 +1,156 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL, Graphite can be linked
+ *  with the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+
+
+#include <OGF/mesh/algo/point_grid.h>
+#include <geogram/basic/process.h>
+
+#include <cmath>
+
+namespace OGF {
+
+    PointGrid::PointGrid() : inv_cell_size_(0.0) {
+	for(index_t c=0; c<3; ++c) {
+	    origin_[c] = 0.0;
+	    nb_cells_[c] = 1;
+	}
+    }
+
+    void PointGrid::set_points(
+	index_t nb_points, const double* points, index_t stride, double radius
+    ) {
+	geo_assert(stride >= 3);
+	point_index_.clear();
+	point_.clear();
+
+	double xyzmin[3] = { 0.0, 0.0, 0.0 };
+	double xyzmax[3] = { 0.0, 0.0, 0.0 };
+	for(index_t v=0; v<nb_points; ++v) {
+	    const double* p = points + size_t(stride)*size_t(v);
+	    for(index_t c=0; c<3; ++c) {
+		if(v == 0 || p[c] < xyzmin[c]) {
+		    xyzmin[c] = p[c];
+		}
+		if(v == 0 || p[c] > xyzmax[c]) {
+		    xyzmax[c] = p[c];
+		}
+	    }
+	}
+
+	double extent = std::max(
+	    xyzmax[0]-xyzmin[0],
+	    std::max(xyzmax[1]-xyzmin[1], xyzmax[2]-xyzmin[2])
+	);
+	double cell_size = radius;
+	if(!(cell_size > 0.0)) {
+	    cell_size = (extent > 0.0) ?
+		extent / std::cbrt(double(std::max(nb_points, index_t(1)))) :
+		1.0;
+	}
+
+	// Enlarge the cells if there are too many of them (for instance,
+	// if the radius is very small as compared to the extent of the
+	// point set).
+	double max_nb_cells = 4.0 * double(nb_points) + 64.0;
+	for(;;) {
+	    double nb_cells = 1.0;
+	    for(index_t c=0; c<3; ++c) {
+		nb_cells *= std::floor((xyzmax[c]-xyzmin[c]) / cell_size) + 1.0;
+	    }
+	    if(nb_cells <= max_nb_cells) {
+		break;
+	    }
+	    cell_size *= std::max(1.1, std::cbrt(nb_cells / max_nb_cells));
+	}
+
+	inv_cell_size_ = 1.0 / cell_size;
+	for(index_t c=0; c<3; ++c) {
+	    origin_[c] = xyzmin[c];
+	    nb_cells_[c] = index_t(
+		std::floor((xyzmax[c]-xyzmin[c]) / cell_size)
+	    ) + 1;
+	}
+	index_t nb_cells = nb_cells_[0]*nb_cells_[1]*nb_cells_[2];
+
+	// Sort the points by cell (counting sort).
+	vector<index_t> cell(nb_points);
+	parallel_for_slice(
+	    0, nb_points,
+	    [this,points,stride,&cell](index_t from, index_t to) {
+		for(index_t v=from; v<to; ++v) {
+		    const double* p = points + size_t(stride)*size_t(v);
+		    cell[v] = (
+			cell_coord(p[2],2)*nb_cells_[1] + cell_coord(p[1],1)
+		    )*nb_cells_[0] + cell_coord(p[0],0);
+		}
+	    }
+	);
+
+	cell_start_.assign(nb_cells+1, 0);
+	for(index_t v=0; v<nb_points; ++v) {
+	    ++cell_start_[cell[v]+1];
+	}
+	for(index_t c=0; c<nb_cells; ++c) {
+	    cell_start_[c+1] += cell_start_[c];
+	}
+
+	vector<index_t> cell_next(cell_start_);
+	point_index_.resize(nb_points);
+	point_.resize(nb_points);
+	for(index_t v=0; v<nb_points; ++v) {
+	    index_t p = cell_next[cell[v]];
+	    ++cell_next[cell[v]];
+	    point_index_[p] = v;
+	    point_[p] = vec3(points + size_t(stride)*size_t(v));
+	}
+    }
+
+    void PointGrid::get_points_in_ball(
+	const vec3& center, double radius, vector<index_t>& neighbors
+    ) const {
+	neighbors.clear();
+	for_each_point_in_ball(
+	    center, radius,
+	    [&neighbors](index_t v, double d2) {
+		geo_argused(d2);
+		neighbors.push_back(v);
+		return true;
+	    }
+	);
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL, Graphite can be linked
+ *  with the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+
+
+#ifndef H_OGF_MESH_ALGO_POINT_GRID_H
+#define H_OGF_MESH_ALGO_POINT_GRID_H
+
+#include <OGF/mesh/common/common.h>
+#include <geogram/basic/geometry.h>
+
+/**
+ * \file OGF/mesh/algo/point_grid.h
+ * \brief Fixed-radius neighbor queries in point sets.
+ */
+
+namespace OGF {
+
+    /**
+     * \brief A regular grid over a point set, for fixed-radius
+     *  neighbor queries.
+     * \details Unlike k-nearest neighbor queries, the number of
+     *  neighbors does not need to be known in advance. Cells are
+     *  sized after the query radius, so that a query only traverses
+     *  the cells that overlap the bounding box of the ball.
+     */
+    class MESH_API PointGrid {
+    public:
+	/**
+	 * \brief PointGrid constructor.
+	 */
+	PointGrid();
+
+	/**
+	 * \brief Sets the points and builds the grid.
+	 * \details The coordinates are copied.
+	 * \param[in] nb_points number of points
+	 * \param[in] points pointer to the coordinates of the first point
+	 * \param[in] stride number of doubles between two consecutive
+	 *  points (the first three ones are used)
+	 * \param[in] radius the typical query radius. Cells may be larger
+	 *  to bound the number of cells.
+	 */
+	void set_points(
+	    index_t nb_points, const double* points, index_t stride,
+	    double radius
+	);
+
+	/**
+	 * \brief Gets the number of points.
+	 * \return the number of points
+	 */
+	index_t nb_points() const {
+	    return index_t(point_index_.size());
+	}
+
+	/**
+	 * \brief Calls a function for all the points in a ball.
+	 * \param[in] center the center of the ball
+	 * \param[in] radius the radius of the ball
+	 * \param[in] callback a function called with the index of each
+	 *  point at distance smaller or equal to \p radius and its squared
+	 *  distance to \p center. It returns false to stop the traversal.
+	 *  Points are traversed in no particular order.
+	 */
+	template <class CALLBACK> void for_each_point_in_ball(
+	    const vec3& center, double radius, const CALLBACK& callback
+	) const {
+	    if(nb_points() == 0) {
+		return;
+	    }
+	    double R2 = radius*radius;
+	    index_t imin = cell_coord(center.x - radius, 0);
+	    index_t imax = cell_coord(center.x + radius, 0);
+	    index_t jmin = cell_coord(center.y - radius, 1);
+	    index_t jmax = cell_coord(center.y + radius, 1);
+	    index_t kmin = cell_coord(center.z - radius, 2);
+	    index_t kmax = cell_coord(center.z + radius, 2);
+	    for(index_t k=kmin; k<=kmax; ++k) {
+		for(index_t j=jmin; j<=jmax; ++j) {
+		    index_t c = (k*nb_cells_[1] + j)*nb_cells_[0];
+		    index_t b = cell_start_[c + imin];
+		    index_t e = cell_start_[c + imax + 1];
+		    for(index_t p=b; p<e; ++p) {
+			const vec3& q = point_[p];
+			double dx = q.x - center.x;
+			double dy = q.y - center.y;
+			double dz = q.z - center.z;
+			double d2 = dx*dx + dy*dy + dz*dz;
+			if(d2 <= R2 && !callback(point_index_[p], d2)) {
+			    return;
+			}
+		    }
+		}
+	    }
+	}
+
+	/**
+	 * \brief Gets all the points in a ball.
+	 * \param[in] center the center of the ball
+	 * \param[in] radius the radius of the ball
+	 * \param[out] neighbors the indices of the points at distance smaller
+	 *  or equal to \p radius, in no particular order
+	 */
+	void get_points_in_ball(
+	    const vec3& center, double radius, vector<index_t>& neighbors
+	) const;
+
+    protected:
+	/**
+	 * \brief Gets the cell coordinate along an axis.
+	 * \param[in] x the coordinate of a point along the axis
+	 * \param[in] axis one of 0,1,2
+	 * \return the coordinate of the cell that contains \p x, clamped
+	 *  to the grid
+	 */
+	index_t cell_coord(double x, index_t axis) const {
+	    double u = (x - origin_[axis]) * inv_cell_size_;
+	    if(!(u > 0.0)) {
+		return 0;
+	    }
+	    if(u >= double(nb_cells_[axis] - 1)) {
+		return nb_cells_[axis] - 1;
+	    }
+	    return index_t(u);
+	}
+
+    private:
+	double origin_[3];
+	double inv_cell_size_;
+	index_t nb_cells_[3];
+	vector<index_t> cell_start_;
+	vector<index_t> point_index_;
+	vector<vec3> point_;
+    };
+}
+
+#endif
@@ -38,6 +38,8 @@
 
 #include <OGF/mesh/commands/filter.h>
 
+#include <algorithm>
+
 namespace OGF {
 
     Filter::Filter(
@@ -49,6 +51,7 @@ namespace OGF {
         } else {
             parse_items(description);            
         }
+        compile(floating_point);
     }
 
     void Filter::parse_items(const std::string& description) {
@@ -149,7 +152,92 @@ namespace OGF {
         }
     }
     
+    void Filter::compile(bool floating_point) {
+        merge_intervals(include_items_, include_intervals_, include_);
+        merge_intervals(exclude_items_, exclude_intervals_, exclude_);
+        bits_.clear();
+        if(floating_point) {
+            return;
+        }
+        // In 'items' mode, all bounds are integers in [0,size_-1]
+        // ('*' on an empty array gives an interval out of bounds)
+        bits_.assign(size_, false);
+        if(size_ == 0) {
+            return;
+        }
+        double last = double(size_-1);
+        for(const std::pair<double, double>& I: include_) {
+            std::fill(
+                bits_.begin() + std::ptrdiff_t(I.first),
+                bits_.begin() + std::ptrdiff_t(std::min(I.second,last)) + 1,
+                true
+            );
+        }
+        for(const std::pair<double, double>& I: exclude_) {
+            std::fill(
+                bits_.begin() + std::ptrdiff_t(I.first),
+                bits_.begin() + std::ptrdiff_t(std::min(I.second,last)) + 1,
+                false
+            );
+        }
+    }
+
+    void Filter::merge_intervals(
+        const vector<double>& items,
+        const vector<std::pair<double, double> >& intervals,
+        vector<std::pair<double, double> >& result
+    ) {
+        result.clear();
+        result.reserve(items.size() + intervals.size());
+        for(double v: items) {
+            result.push_back(std::make_pair(v,v));
+        }
+        for(const std::pair<double, double>& I: intervals) {
+            result.push_back(I);
+        }
+        std::sort(result.begin(), result.end());
+        // Tests are done on closed intervals, merge the ones that
+        // overlap or touch.
+        index_t nb = 0;
+        for(index_t i=0; i<result.size(); ++i) {
+            if(nb != 0 && result[i].first <= result[nb-1].second) {
+                result[nb-1].second = std::max(
+                    result[nb-1].second, result[i].second
+                );
+            } else {
+                result[nb] = result[i];
+                ++nb;
+            }
+        }
+        result.resize(nb);
+    }
+
+    bool Filter::in_intervals(
+        const vector<std::pair<double, double> >& intervals,
+        double value
+    ) {
+        // First interval that starts after value, the candidate
+        // is the one just before.
+        auto it = std::upper_bound(
+            intervals.begin(), intervals.end(), value,
+            [](double v, const std::pair<double, double>& I)->bool {
+                return v < I.first;
+            }
+        );
+        if(it == intervals.begin()) {
+            return false;
+        }
+        --it;
+        return (value <= it->second);
+    }
+
     bool Filter::test(double value) const {
+        return
+            in_intervals(include_, value) &&
+            !in_intervals(exclude_, value);
+    }
+
+    bool Filter::test_reference(double value) const {
         bool result = false;
         for(double v: include_items_) {
             if(value == v) {
@@ -176,6 +264,9 @@ namespace OGF {
 
     bool Filter::test(index_t item) const {
         geo_debug_assert(item < size_);
+        if(item < bits_.size()) {
+            return bits_[item];
+        }
         return test(double(item));
     }
 }
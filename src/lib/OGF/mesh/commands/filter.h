@@ -89,6 +89,18 @@ namespace OGF {
          */
         bool test(double value) const;
 
+        /**
+         * \brief Tests an element by value, without using the
+         *  compiled representation.
+         * \details Scans all the items and intervals of the description.
+         *  It is much slower than test(), and only used for checking
+         *  and benchmarking.
+         * \param[in] value the element value to be tested
+         * \retval true if the element is in the subset
+         * \retval false otherwise
+         */
+        bool test_reference(double value) const;
+
     protected:
         /**
          * \brief used in 'items' mode (ctor, floating_point = false)
@@ -100,12 +112,53 @@ namespace OGF {
          */
         void parse_values(const std::string& destription);
 
+        /**
+         * \brief Creates the representation used by test()
+         * \details Items and intervals are merged into sorted
+         *  sets of disjoint intervals, that can be tested by
+         *  binary search. In 'items' mode, a bitset with the
+         *  result of the test for each element is created as well.
+         * \param[in] floating_point true in 'values' mode, false in
+         *  'items' mode
+         */
+        void compile(bool floating_point);
+
+        /**
+         * \brief Merges items and intervals into a sorted set
+         *  of disjoint intervals
+         * \param[in] items the individual items
+         * \param[in] intervals the intervals
+         * \param[out] result the sorted disjoint intervals
+         */
+        static void merge_intervals(
+            const vector<double>& items,
+            const vector<std::pair<double, double> >& intervals,
+            vector<std::pair<double, double> >& result
+        );
+
+        /**
+         * \brief Tests whether a value is in a sorted set of
+         *  disjoint intervals
+         * \param[in] intervals the sorted disjoint intervals
+         * \param[in] value the value to be tested
+         * \retval true if \p value is in one of the intervals
+         * \retval false otherwise
+         */
+        static bool in_intervals(
+            const vector<std::pair<double, double> >& intervals,
+            double value
+        );
+
     private:
         index_t size_;
         vector<double> include_items_;
         vector<std::pair<double, double> > include_intervals_;
         vector<double> exclude_items_;
         vector<std::pair<double, double> > exclude_intervals_;
+
+        vector<std::pair<double, double> > include_;
+        vector<std::pair<double, double> > exclude_;
+        std::vector<bool> bits_;
     };
 }
 
@@ -237,10 +237,7 @@ namespace OGF {
                                     << std::endl;
             return;
         }
-        //   We need to lock the graphics because the AABB will change
-        // the order of the surface facets.
-        surface->lock_graphics();
-        MeshFacetsAABB AABB(*surface);
+        std::shared_ptr<const MeshFacetsAABB> AABB = surface->facets_AABB();
         Attribute<double> attribute(
             mesh_grob()->vertices.attributes(), attribute_name
         );
@@ -249,13 +246,12 @@ namespace OGF {
 	    0, mesh_grob()->vertices.nb(),
 	    [&attribute, &AABB, this](index_t v) {
 		attribute[v] = ::sqrt(
-		    AABB.squared_distance(
+		    AABB->squared_distance(
 			vec3(mesh_grob()->vertices.point_ptr(v))
 			)
 		    );
 	    }
 	);
-        surface->unlock_graphics();
 	show_attribute("vertices."+attribute_name);
         mesh_grob()->update();
     }
@@ -420,7 +416,8 @@ namespace OGF {
 	}
 
 	if(surface->facets.nb() != 0) {
-	    MeshFacetsAABB AABB(*surface);
+	    std::shared_ptr<const MeshFacetsAABB> AABB =
+		surface->facets_AABB();
 
 	    parallel_for(
 		0, mesh_grob()->vertices.nb(),
@@ -428,7 +425,7 @@ namespace OGF {
 		    vec3 p(mesh_grob()->vertices.point_ptr(v));
 		    vec3 q;
 		    double sqdist;
-		    index_t f = AABB.nearest_facet(p,q,sqdist);
+		    index_t f = AABB->nearest_facet(p,q,sqdist);
 		    vec2 uv;
 		    if(from_tex_coord_v.is_bound()) {
 			uv = interpolate_tex_coord(
@@ -466,10 +463,8 @@ namespace OGF {
 	}
 
 	if(from_tex_coord_v.is_bound()) {
-	    NearestNeighborSearch_var NN = NearestNeighborSearch::create(3);
-	    NN->set_points(
-		surface->vertices.nb(), surface->vertices.point_ptr(0)
-	    );
+	    std::shared_ptr<const NearestNeighborSearch> NN =
+		surface->vertices_NN();
 
 	    parallel_for(
 		0, mesh_grob()->vertices.nb(),
@@ -508,64 +503,191 @@ namespace OGF {
 
 /************************************************************************/
 
+    namespace {
+
+	/**
+	 * \brief Hashes a 64 bits integer (splitmix64 finalizer).
+	 * \details Used to derive per-vertex random numbers that do
+	 *  not depend on the order in which the threads process the
+	 *  vertices.
+	 */
+	inline Numeric::uint64 hash64(Numeric::uint64 x) {
+	    x += 0x9e3779b97f4a7c15ull;
+	    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	    return x ^ (x >> 31);
+	}
+
+	/**
+	 * \brief Converts a 64 bits integer into a double in [0,1).
+	 */
+	inline double to_unit_double(Numeric::uint64 x) {
+	    return double(x >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	/**
+	 * \brief Generates the i-th direction of a Fibonacci lattice
+	 *  shifted by (r1,r2) (Cranley-Patterson rotation).
+	 * \param[in] i index of the sample
+	 * \param[in] n number of samples
+	 * \param[in] r1 , r2 the shift, in [0,1)
+	 * \param[in] N if non-null, directions are cosine-distributed
+	 *  on the hemisphere around N, else uniformly distributed on
+	 *  the sphere
+	 * \return a unit vector
+	 */
+	vec3 AO_direction(
+	    index_t i, index_t n, double r1, double r2, const vec3* N
+	) {
+	    static const double golden = 0.6180339887498949;
+	    double u1 = (double(i) + 0.5) / double(n) + r1;
+	    double u2 = double(i) * golden + r2;
+	    u1 -= ::floor(u1);
+	    u2 -= ::floor(u2);
+	    double theta = 2.0 * M_PI * u2;
+	    if(N == nullptr) {
+		double z = 1.0 - 2.0 * u1;
+		double r = ::sqrt(std::max(0.0, 1.0 - z*z));
+		return vec3(r*::cos(theta), r*::sin(theta), z);
+	    }
+	    // Orthonormal frame around N
+	    vec3 T = (::fabs(N->x) > 0.5) ? vec3(0.0, 1.0, 0.0)
+		                          : vec3(1.0, 0.0, 0.0);
+	    vec3 B = normalize(cross(*N, T));
+	    T = cross(B, *N);
+	    double r = ::sqrt(u1);
+	    return r*::cos(theta)*T + r*::sin(theta)*B +
+		::sqrt(std::max(0.0, 1.0 - u1)) * (*N);
+	}
+    }
+
     void MeshGrobAttributesCommands::compute_ambient_occlusion(
 	const std::string& attribute, index_t nb_rays_per_vertex,
-	index_t nb_smoothing_iter
+	index_t nb_smoothing_iter, bool hemisphere
     ) {
-	Attribute<double> AO(mesh_grob()->vertices.attributes(), attribute);
-	MeshFacetsAABB AABB(*mesh_grob());
+	if(nb_rays_per_vertex == 0) {
+	    Logger::err("AO") << "nb_rays_per_vertex should be non-zero"
+			      << std::endl;
+	    return;
+	}
 
-	parallel_for(
-	    0, mesh_grob()->vertices.nb(),
-	    [this,&AABB,&AO,nb_rays_per_vertex](index_t v) {
-		double ao = 0.0;
-		vec3 p(mesh_grob()->vertices.point_ptr(v));
-		for(index_t i=0; i<nb_rays_per_vertex; ++i) {
-		    // https://math.stackexchange.com/questions/1585975/
-		    //   how-to-generate-random-points-on-a-sphere
-		    double u1 = Numeric::random_float64();
-		    double u2 = Numeric::random_float64();
-		    double theta = 2.0 * M_PI * u2;
-		    double phi = acos(2.0 * u1 - 1.0) - M_PI / 2.0;
-		    vec3 d(
-			cos(theta)*cos(phi),
-			sin(theta)*cos(phi),
-			sin(phi)
-		    );
-		    if(!AABB.ray_intersection(Ray(p + 1e-3*d, d))) {
-			ao += 1.0;
+	MeshGrob* M = mesh_grob();
+	index_t nv = M->vertices.nb();
+	Attribute<double> AO(M->vertices.attributes(), attribute);
+	std::shared_ptr<const MeshFacetsAABB> AABB = M->facets_AABB();
+
+	// Vertex adjacency, used for normals and smoothing. Stored in
+	// compressed row form. Neighbors are listed once per facet edge
+	// (like the previous serial smoothing), in a deterministic order.
+	vector<index_t> adj_ptr(nv+1,0);
+	vector<index_t> adj;
+	for(index_t f: M->facets) {
+	    index_t d = M->facets.nb_vertices(f);
+	    for(index_t lv=0; lv < d; ++lv) {
+		++adj_ptr[M->facets.vertex(f,lv)+1];
+		++adj_ptr[M->facets.vertex(f,(lv + 1) % d)+1];
+	    }
+	}
+	for(index_t v=0; v<nv; ++v) {
+	    adj_ptr[v+1] += adj_ptr[v];
+	}
+	adj.resize(adj_ptr[nv]);
+	{
+	    vector<index_t> cur(adj_ptr.begin(), adj_ptr.end()-1);
+	    for(index_t f: M->facets) {
+		index_t d = M->facets.nb_vertices(f);
+		for(index_t lv=0; lv < d; ++lv) {
+		    index_t v1 = M->facets.vertex(f,lv);
+		    index_t v2 = M->facets.vertex(f,(lv + 1) % d);
+		    adj[cur[v1]++] = v2;
+		    adj[cur[v2]++] = v1;
+		}
+	    }
+	}
+
+	vector<vec3> N;
+	if(hemisphere) {
+	    N.assign(nv, vec3(0.0, 0.0, 0.0));
+	    for(index_t f: M->facets) {
+		vec3 fN = Geom::mesh_facet_normal(*M, f);
+		for(index_t lv=0; lv<M->facets.nb_vertices(f); ++lv) {
+		    N[M->facets.vertex(f,lv)] += fN;
+		}
+	    }
+	    parallel_for(
+		0, nv, [&N](index_t v) {
+		    double l = length(N[v]);
+		    N[v] = (l == 0.0) ? vec3(0.0, 0.0, 1.0) : (1.0/l) * N[v];
+		}
+	    );
+	}
+
+	// Rays are generated and traced per block of vertices. The random
+	// shift of the sampling pattern only depends on the vertex index,
+	// hence the result does not depend on the number of threads.
+	static const index_t BLOCK_SIZE = 64;
+	double eps = 1e-6 * bbox_diagonal(*M);
+	parallel_for_slice(
+	    0, nv,
+	    [&](index_t from, index_t to) {
+		vector<Ray> rays;
+		rays.reserve(BLOCK_SIZE * nb_rays_per_vertex);
+		for(index_t b=from; b<to; b+=BLOCK_SIZE) {
+		    index_t e = std::min(b+BLOCK_SIZE, to);
+		    rays.clear();
+		    for(index_t v=b; v<e; ++v) {
+			vec3 p(M->vertices.point_ptr(v));
+			Numeric::uint64 h = hash64(Numeric::uint64(v));
+			double r1 = to_unit_double(h);
+			double r2 = to_unit_double(hash64(h));
+			const vec3* Nv = hemisphere ? &N[v] : nullptr;
+			vec3 offset = (Nv != nullptr) ? eps * (*Nv)
+			                              : vec3(0.0, 0.0, 0.0);
+			for(index_t i=0; i<nb_rays_per_vertex; ++i) {
+			    vec3 d = AO_direction(
+				i, nb_rays_per_vertex, r1, r2, Nv
+			    );
+			    rays.push_back(Ray(p + offset + 1e-3*d, d));
+			}
+		    }
+		    for(index_t v=b; v<e; ++v) {
+			index_t nb_visible = 0;
+			const Ray* R = &rays[(v-b)*nb_rays_per_vertex];
+			for(index_t i=0; i<nb_rays_per_vertex; ++i) {
+			    if(!AABB->ray_intersection(R[i])) {
+				++nb_visible;
+			    }
+			}
+			AO[v] = double(nb_visible) / double(nb_rays_per_vertex);
 		    }
 		}
-		ao /= double(nb_rays_per_vertex);
-		AO[v] = ao;
 	    }
 	);
 
-	vector<double> next_val;
-	vector<index_t> degree;
+	// Smoothing, in parallel, with a double buffer.
+	vector<double> cur_val(nv);
+	vector<double> next_val(nv);
+	for(index_t v=0; v<nv; ++v) {
+	    cur_val[v] = AO[v];
+	}
 	for(index_t i=0; i<nb_smoothing_iter; ++i) {
-	    next_val.assign(mesh_grob()->vertices.nb(),0.0);
-	    degree.assign(mesh_grob()->vertices.nb(),1);
-	    for(index_t v: mesh_grob()->vertices) {
-		next_val[v] = AO[v];
-	    }
-	    for(index_t f: mesh_grob()->facets) {
-		index_t d = mesh_grob()->facets.nb_vertices(f);
-		for(index_t lv=0; lv < d; ++lv) {
-		    index_t v1 = mesh_grob()->facets.vertex(f,lv);
-		    index_t v2 = mesh_grob()->facets.vertex(f,(lv + 1) % d);
-		    degree[v1]++;
-		    degree[v2]++;
-		    next_val[v1] += AO[v2];
-		    next_val[v2] += AO[v1];
+	    parallel_for(
+		0, nv, [&](index_t v) {
+		    double sum = cur_val[v];
+		    for(index_t k=adj_ptr[v]; k<adj_ptr[v+1]; ++k) {
+			sum += cur_val[adj[k]];
+		    }
+		    next_val[v] = sum / double(1 + adj_ptr[v+1] - adj_ptr[v]);
 		}
-	    }
-	    for(index_t v: mesh_grob()->vertices) {
-		AO[v] = next_val[v] / double(degree[v]);
-	    }
+	    );
+	    cur_val.swap(next_val);
 	}
+	for(index_t v=0; v<nv; ++v) {
+	    AO[v] = cur_val[v];
+	}
+
 	show_attribute("vertices."+attribute);
-	mesh_grob()->update();
+	M->update();
     }
 
 
@@ -171,17 +171,23 @@ namespace OGF {
 
         /**
          * \brief Computes per-vertex ambient occlusion.
+         * \details Directions are sampled with a stratified pattern,
+         *  randomly shifted for each vertex. The result is the same
+         *  from one run to the next, whatever the number of threads.
          * \param[in] attribute the name of the vertex attribute
 	 * \param[in] nb_rays_per_vertex number of rays used to
 	 *  sample directions. The higher, the more precise.
 	 * \param[in] nb_smoothing_iterations blur the result
 	 *  a little bit to hide sampling noise
+	 * \param[in] hemisphere if set, sample the hemisphere around the
+	 *  vertex normal (cosine-weighted), else sample the whole sphere
          * \menu Vertices
          */
         void compute_ambient_occlusion(
             const std::string& attribute="AO",
 	    index_t nb_rays_per_vertex = 100,
-	    index_t nb_smoothing_iterations = 2
+	    index_t nb_smoothing_iterations = 2,
+	    bool hemisphere = false
         );
 
         /**
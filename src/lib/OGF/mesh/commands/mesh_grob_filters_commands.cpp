@@ -40,6 +40,84 @@
 #include <OGF/mesh/commands/mesh_grob_filters_commands.h>
 #include <OGF/mesh/commands/filter.h>
 
+#include <geogram/basic/process.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/command_line.h>
+
+#include <atomic>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Compares the timings of compiled and reference filter
+     *  tests, if dbg:filter_benchmark is set.
+     * \param[in] filter the Filter
+     * \param[in] nb the number of elements
+     * \param[in] value a function that gives the value to be tested
+     *  for an element, as a double
+     * \param[in] test a function that tests an element with the
+     *  compiled filter
+     */
+    template <class VALUE_F, class TEST_F> void benchmark_filter(
+        const Filter& filter, index_t nb,
+        const VALUE_F& value, const TEST_F& test
+    ) {
+        if(
+            !CmdLine::arg_is_declared("dbg:filter_benchmark") ||
+            !CmdLine::get_arg_bool("dbg:filter_benchmark")
+        ) {
+            return;
+        }
+
+        index_t nb_ref = 0;
+        double t_ref = 0.0;
+        {
+            Stopwatch W("Filter ref",false);
+            for(index_t i=0; i<nb; ++i) {
+                nb_ref += index_t(filter.test_reference(value(i)));
+            }
+            t_ref = W.elapsed_time();
+        }
+
+        std::atomic<index_t> nb_compiled(0);
+        std::atomic<index_t> nb_mismatch(0);
+        double t_compiled = 0.0;
+        {
+            Stopwatch W("Filter compiled",false);
+            parallel_for_slice(
+                0, nb, [&](index_t from, index_t to) {
+                    index_t local_nb = 0;
+                    for(index_t i=from; i<to; ++i) {
+                        local_nb += index_t(test(i));
+                    }
+                    nb_compiled += local_nb;
+                }
+            );
+            t_compiled = W.elapsed_time();
+        }
+
+        for(index_t i=0; i<nb; ++i) {
+            if(test(i) != filter.test_reference(value(i))) {
+                ++nb_mismatch;
+            }
+        }
+
+        Logger::out("Filter")
+            << "reference: " << t_ref << " s (" << nb_ref << " selected) "
+            << "compiled: " << t_compiled << " s ("
+            << index_t(nb_compiled) << " selected) "
+            << "speedup: x" << (t_compiled > 0.0 ? t_ref/t_compiled : 0.0)
+            << std::endl;
+        if(nb_mismatch != 0) {
+            Logger::warn("Filter")
+                << index_t(nb_mismatch)
+                << " elements differ between compiled and reference tests"
+                << std::endl;
+        }
+    }
+}
+
 namespace OGF {
 
     /*********************************************************/
@@ -266,7 +344,12 @@ namespace OGF {
 
         try {
             Filter filter(attribute.size(), filter_string);
-            for(index_t i=0; i<attribute.size(); ++i) {
+            benchmark_filter(
+                filter, attribute.size(),
+                [](index_t i)->double { return double(i); },
+                [&](index_t i)->bool { return filter.test(i); }
+            );
+            parallel_for(0, attribute.size(), [&](index_t i) {
                 switch(op) {
                 case FILTER_SET:
                     attribute[i] = Numeric::uint8(
@@ -284,7 +367,7 @@ namespace OGF {
                     );
                     break;
                 }
-            }
+            });
         } catch(...) {
             Logger::err("Attributes") << "Invalid filter specification"
                                       << std::endl;
@@ -342,7 +425,12 @@ namespace OGF {
 
         try {
             Filter filter(attribute.size(), filter_string, true);
-            for(index_t i=0; i<attribute.size(); ++i) {
+            benchmark_filter(
+                filter, attribute.size(),
+                [&](index_t i)->double { return attribute[i]; },
+                [&](index_t i)->bool { return filter.test(attribute[i]); }
+            );
+            parallel_for(0, attribute.size(), [&](index_t i) {
                 switch(op) {
                 case FILTER_SET: {
                     filter_attribute[i] =
@@ -361,7 +449,7 @@ namespace OGF {
                         );
                 } break;
                 }
-            }
+            });
         } catch(...) {
             Logger::err("Attributes") << "Invalid filter specification"
                                       << std::endl;
@@ -37,8 +37,9 @@
 
 
 #include <OGF/mesh/commands/mesh_grob_points_commands.h>
+#include <OGF/mesh/algo/point_grid.h>
 #include <geogram/points/co3ne.h>
-#include <geogram/points/kd_tree.h>
+#include <geogram/points/principal_axes.h>
 #include <geogram/mesh/mesh_geometry.h>
 #include <geogram/mesh/mesh_repair.h>
 #include <geogram/mesh/mesh_AABB.h>
@@ -59,9 +60,71 @@ namespace OGF {
 
     void MeshGrobPointsCommands::smooth_point_set(
         unsigned int nb_iterations,
-        unsigned int nb_neighbors
+        unsigned int nb_neighbors,
+        double radius,
+        bool relative_radius
     ) {
-        GEO::Co3Ne_smooth(*mesh_grob(), nb_neighbors, nb_iterations);
+        if(radius <= 0.0) {
+            GEO::Co3Ne_smooth(*mesh_grob(), nb_neighbors, nb_iterations);
+            mesh_grob()->update();
+            return;
+        }
+
+        if(mesh_grob()->vertices.dimension() < 3) {
+            Logger::err("Smooth") << "Mesh dimension needs to be >= 3"
+                                  << std::endl;
+            return;
+        }
+
+	if(relative_radius) {
+	    radius *= bbox_diagonal(*mesh_grob());
+	}
+
+	index_t nb_vertices = mesh_grob()->vertices.nb();
+	index_t dim = mesh_grob()->vertices.dimension();
+	PointGrid grid;
+	vector<vec3> new_point(nb_vertices);
+	for(unsigned int iter=0; iter<nb_iterations; ++iter) {
+	    grid.set_points(
+		nb_vertices, mesh_grob()->vertices.point_ptr(0), dim, radius
+	    );
+	    parallel_for_slice(
+		0, nb_vertices,
+		[this,radius,&grid,&new_point](index_t from, index_t to) {
+		    for(index_t v=from; v<to; ++v) {
+			vec3 p(mesh_grob()->vertices.point_ptr(v));
+			PrincipalAxes3d axes;
+			index_t nb = 0;
+			axes.begin();
+			grid.for_each_point_in_ball(
+			    p, radius,
+			    [this,&axes,&nb](index_t w, double d2) {
+				geo_argused(d2);
+				axes.add_point(
+				    vec3(mesh_grob()->vertices.point_ptr(w))
+				);
+				++nb;
+				return true;
+			    }
+			);
+			axes.end();
+			// Project the point onto the tangent plane, if
+			// there are enough neighbors to estimate it.
+			if(nb >= 3) {
+			    vec3 n = axes.normal();
+			    p -= dot(p - axes.center(), n) * n;
+			}
+			new_point[v] = p;
+		    }
+		}
+	    );
+	    for(index_t v=0; v<nb_vertices; ++v) {
+		double* p = mesh_grob()->vertices.point_ptr(v);
+		p[0] = new_point[v].x;
+		p[1] = new_point[v].y;
+		p[2] = new_point[v].z;
+	    }
+	}
         mesh_grob()->update();
     }
 
@@ -262,12 +325,13 @@ namespace OGF {
 			points->vertices.attributes(), "normal", 3
 		    );
 		}
-		MeshFacetsAABB AABB(*mesh_grob());
+		std::shared_ptr<const MeshFacetsAABB> AABB =
+		    mesh_grob()->facets_AABB();
 		for(index_t i: points->vertices) {
 		    vec3 p(points->vertices.point_ptr(i));
 		    vec3 q;
 		    double sq_dist;
-		    index_t f = AABB.nearest_facet(p,q,sq_dist);
+		    index_t f = AABB->nearest_facet(p,q,sq_dist);
 		    vec3 N = normalize(Geom::mesh_facet_normal(*mesh_grob(),f));
 		    for(index_t c=0; c<3; ++c) {
 			points->vertices.point_ptr(i)[c] = q[c];
@@ -388,14 +452,15 @@ namespace OGF {
     void MeshGrobPointsCommands::detect_outliers(
 	index_t N, double R, bool relative_R
     ) {
+        if(mesh_grob()->vertices.dimension() < 3) {
+            Logger::err("Outliers") << "Mesh dimension needs to be >= 3"
+                                    << std::endl;
+            return;
+        }
+
 	// Remove duplicated vertices
 	mesh_repair(*mesh_grob(), GEO::MESH_REPAIR_COLOCATE, 0.0);
 
-	// Compute nearest neighbors using a KdTree.
-	NearestNeighborSearch_var NN = new BalancedKdTree(3); // 3 is for 3D
-	NN->set_points(
-	    mesh_grob()->vertices.nb(), mesh_grob()->vertices.point_ptr(0)
-	);
         Attribute<bool> is_outlier(
             mesh_grob()->vertices.attributes(), "selection"
         );
@@ -404,20 +469,29 @@ namespace OGF {
 	    R *= bbox_diagonal(*mesh_grob());
 	}
 
-	double R2 = R*R; // squared threshold
-	// (KD-tree returns squared distances)
+	// A point is an outlier if there are less than N points
+	// (including itself) within distance R.
+	PointGrid grid;
+	grid.set_points(
+	    mesh_grob()->vertices.nb(), mesh_grob()->vertices.point_ptr(0),
+	    mesh_grob()->vertices.dimension(), R
+	);
 
 	parallel_for_slice(
 	    0,mesh_grob()->vertices.nb(),
-	    [this,N,&NN,R2,&is_outlier](index_t from, index_t to) {
-		vector<index_t> neigh(N);
-		vector<double> neigh_sq_dist(N);
+	    [this,N,R,&grid,&is_outlier](index_t from, index_t to) {
 		for(index_t v=from; v<to; ++v) {
-		    NN->get_nearest_neighbors(
-			N, mesh_grob()->vertices.point_ptr(v),
-			neigh.data(), neigh_sq_dist.data()
+		    index_t nb = 0;
+		    grid.for_each_point_in_ball(
+			vec3(mesh_grob()->vertices.point_ptr(v)), R,
+			[N,&nb](index_t w, double d2) {
+			    geo_argused(w);
+			    geo_argused(d2);
+			    ++nb;
+			    return (nb < N);
+			}
 		    );
-		    is_outlier[v] = (neigh_sq_dist[N-1] > R2);
+		    is_outlier[v] = (nb < N);
 		}
 	    }
 	);
@@ -428,6 +502,12 @@ namespace OGF {
     void MeshGrobPointsCommands::estimate_density(
 	double R, bool relative_R, const std::string& attribute
     ) {
+        if(mesh_grob()->vertices.dimension() < 3) {
+            Logger::err("Density") << "Mesh dimension needs to be >= 3"
+                                   << std::endl;
+            return;
+        }
+
 	if(relative_R) {
 	    R *= bbox_diagonal(*mesh_grob());
 	}
@@ -437,34 +517,29 @@ namespace OGF {
 	Attribute<double> density(
 	    mesh_grob()->vertices.attributes(), attribute
 	);
-	NearestNeighborSearch_var NN = new BalancedKdTree(3); // 3 is for 3D
-	NN->set_points(
-	    mesh_grob()->vertices.nb(), mesh_grob()->vertices.point_ptr(0)
+	PointGrid grid;
+	grid.set_points(
+	    mesh_grob()->vertices.nb(), mesh_grob()->vertices.point_ptr(0),
+	    mesh_grob()->vertices.dimension(), R
 	);
 
 	double Bvol = (4.0 / 3.0) * M_PI * R*R*R;
 
 	parallel_for_slice(
 	    0,mesh_grob()->vertices.nb(),
-	    [this,R2,&NN,&density,Bvol](index_t from, index_t to) {
-		vector<index_t> neigh;
-		vector<double> neigh_sq_dist;
+	    [this,R,R2,&grid,&density,Bvol](index_t from, index_t to) {
 		for(index_t v=from; v<to; ++v) {
-		    index_t N=0;
-		    while(N == 0 || neigh_sq_dist[N-1] < R2) {
-			N = (N == 0) ? 50 : index_t(double(N)*1.2);
-			N = std::min(N, mesh_grob()->vertices.nb());
-			neigh.resize(N);
-			neigh_sq_dist.resize(N);
-			NN->get_nearest_neighbors(
-			    N, mesh_grob()->vertices.point_ptr(v),
-			    neigh.data(), neigh_sq_dist.data()
-			);
-		    }
 		    index_t nb = 0;
-		    for(nb = 0; neigh_sq_dist[nb] < R2; ++nb) {
-		    }
-		    geo_assert(nb < N);
+		    grid.for_each_point_in_ball(
+			vec3(mesh_grob()->vertices.point_ptr(v)), R,
+			[R2,&nb](index_t w, double d2) {
+			    geo_argused(w);
+			    if(d2 < R2) {
+				++nb;
+			    }
+			    return true;
+			}
+		    );
 		    density[v] = double(nb) / Bvol;
 		}
 	    }
@@ -558,22 +633,18 @@ namespace OGF {
 	    return;
 	}
 
-        //   We need to lock the graphics because the AABB will change
-        // the order of the surface facets.
-        surface->lock_graphics();
-        MeshFacetsAABB AABB(*surface);
+        std::shared_ptr<const MeshFacetsAABB> AABB = surface->facets_AABB();
 
 	for(index_t i: mesh_grob()->vertices) {
 	    vec3 p(mesh_grob()->vertices.point_ptr(i));
 	    vec3 q;
 	    double sq_dist;
-	    AABB.nearest_facet(p,q,sq_dist);
+	    AABB->nearest_facet(p,q,sq_dist);
 	    for(index_t c=0; c<3; ++c) {
 		mesh_grob()->vertices.point_ptr(i)[c] = q[c];
 	    }
 	}
 
-        surface->unlock_graphics();
         mesh_grob()->update();
     }
 
@@ -74,10 +74,17 @@ namespace OGF {
          * \param[in] nb_iterations number of smoothing iterations.
          * \param[in] nb_neighbors number of neighbors for estimating
          *   tangent plane.
+         * \param[in] radius if non-zero, the tangent plane is estimated
+         *   from the points within this radius instead of the
+         *   nb_neighbors nearest neighbors.
+         * \param[in] relative_radius radius is relative to
+         *   object bbox diagonal.
          */
         void smooth_point_set(
             unsigned int nb_iterations = 1,
-            unsigned int nb_neighbors = 30
+            unsigned int nb_neighbors = 30,
+            double radius = 0.0,
+            bool relative_radius = true
         );
 
         /********************************************************/
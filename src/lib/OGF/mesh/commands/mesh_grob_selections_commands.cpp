@@ -44,6 +44,13 @@
 #include <geogram/mesh/mesh_repair.h>
 #include <geogram/numerics/predicates.h>
 #include <geogram/points/colocate.h>
+#include <geogram/basic/algorithm.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/stopwatch.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace OGF {
 
@@ -108,120 +115,307 @@ namespace OGF {
         mesh_grob()->update();
     }
 
-    void MeshGrobSelectionsCommands::enlarge_selection(index_t nb_times) {
-        MeshElementsFlags where = visible_selection();
-        if(where == MESH_NONE) {
-            Logger::err("Selection") << "No visible selection"
-                                     << std::endl;
-            return;
-        }
+    namespace {
 
-        for(index_t k=0; k<nb_times; ++k) {
-            Attribute<bool> selection(
-                mesh_grob()->get_subelements_by_type(where).attributes(),
-                "selection"
-            );
+	/**
+	 * \brief Grows or shrinks a selection by rings of elements, with a
+	 *  breadth-first frontier.
+	 * \details Vertices are neighbors if they share a facet edge or a
+	 *  cell facet edge, facets if they share an edge and cells if they
+	 *  share a facet. The initial frontier is the boundary of the set
+	 *  of elements that have the propagated value, and the cost of each
+	 *  ring is proportional to the size of the frontier, instead of the
+	 *  size of the mesh.
+	 */
+	class SelectionGrowth {
+	public:
 
-            vector<bool> new_selection(
-                mesh_grob()->get_subelements_by_type(where).nb(), false
-            );
+	    /**
+	     * \brief SelectionGrowth constructor.
+	     * \param[in] M the mesh
+	     * \param[in] where one of MESH_VERTICES, MESH_FACETS, MESH_CELLS
+	     */
+	    SelectionGrowth(
+		MeshGrob* M, MeshElementsFlags where
+	    ) : M_(M), where_(where) {
+		if(where_ == MESH_VERTICES) {
+		    init_vertices_adjacency();
+		}
+	    }
 
-            switch(where) {
-            case MESH_VERTICES: {
-                for(index_t f: mesh_grob()->facets) {
-                    index_t N = mesh_grob()->facets.nb_vertices(f);
-                    for(index_t lv1=0; lv1<N; ++lv1){
-                        index_t lv2=(lv1+1) % N;
-                        index_t v1 = mesh_grob()->facets.vertex(f,lv1);
-                        index_t v2 = mesh_grob()->facets.vertex(f,lv2);
-                        if(selection[v1] || selection[v2]) {
-                            new_selection[v1] = true;
-                            new_selection[v2] = true;
-                        }
-                    }
-                }
-                for(index_t c: mesh_grob()->cells) {
-                    for(
-                        index_t lf = 0; lf<mesh_grob()->cells.nb_facets(c); ++lf
-                    ) {
-                        index_t N = mesh_grob()->cells.facet_nb_vertices(c,lf);
-                        for(index_t lv1=0; lv1<N; ++lv1) {
-                            index_t lv2=(lv1+1) % N;
-                            index_t v1 =
-                                mesh_grob()->cells.facet_vertex(c,lf,lv1);
-                            index_t v2 =
-                                mesh_grob()->cells.facet_vertex(c,lf,lv2);
-                            if(selection[v1] || selection[v2]) {
-                                new_selection[v1] = true;
-                                new_selection[v2] = true;
-                            }
-                        }
-                    }
-                }
-            } break;
-            case MESH_FACETS: {
-                for(index_t f: mesh_grob()->facets) {
-                    if(selection[f]) {
-                        new_selection[f] = true;
-                    }
-                    for(
-                        index_t le=0;
-                        le<mesh_grob()->facets.nb_vertices(f); ++le
-                    ) {
-                        index_t g = mesh_grob()->facets.adjacent(f,le);
-                        if(g != NO_INDEX && selection[g]) {
-                            new_selection[f] = true;
-                        }
-                    }
-                }
-            } break;
-            case MESH_CELLS: {
-                for(index_t c: mesh_grob()->cells) {
-                    if(selection[c]) {
-                        new_selection[c] = true;
-                    }
-                    for(
-                        index_t lf=0; lf<mesh_grob()->cells.nb_facets(c); ++lf
-                    ) {
-                        index_t d = mesh_grob()->cells.adjacent(c,lf);
-                        if(d != NO_INDEX && selection[d]) {
-                            new_selection[c] = true;
-                        }
-                    }
-                }
-            } break;
-	    case MESH_NONE:
-	    case MESH_EDGES:
-	    case MESH_ALL_ELEMENTS:
-	    case MESH_FACET_CORNERS:
-	    case MESH_CELL_CORNERS:
-	    case MESH_CELL_FACETS:
-	    case MESH_ALL_SUBELEMENTS: {
+	    /**
+	     * \brief Propagates a selection value by rings.
+	     * \details Each element at a distance smaller than or equal to
+	     *  \p nb_rings from an element with \p value gets \p value.
+	     *  Enlarging the selection propagates true, shrinking it
+	     *  propagates false.
+	     * \param[in,out] selection the selection
+	     * \param[in] value the propagated value
+	     * \param[in] nb_rings the number of rings
+	     */
+	    void propagate(
+		Attribute<bool>& selection, bool value, index_t nb_rings
+	    ) {
+		index_t n = selection.size();
+		std::unique_ptr<std::atomic<Numeric::uint8>[]> mark(
+		    new std::atomic<Numeric::uint8>[n]
+		);
+		for(index_t i=0; i<n; ++i) {
+		    bool has_value = (selection[i] == value);
+		    mark[i].store(has_value ? 1 : 0, std::memory_order_relaxed);
+		}
+
+		// Initial frontier: the elements with the value that have a
+		// neighbor without it (the other ones cannot propagate it).
+		// When shrinking a small selection, this avoids starting from
+		// the whole complement of the selection.
+		vector<index_t> frontier;
+		auto find_boundary = [&](
+		    index_t from, index_t to, vector<index_t>& boundary
+		) {
+		    for(index_t i=from; i<to; ++i) {
+			if(mark[i].load(std::memory_order_relaxed) == 0) {
+			    continue;
+			}
+			bool on_boundary = false;
+			for_each_neighbor(i, [&](index_t j) {
+			    if(mark[j].load(std::memory_order_relaxed) == 0) {
+				on_boundary = true;
+			    }
+			});
+			if(on_boundary) {
+			    boundary.push_back(i);
+			}
+		    }
+		};
+		if(n < PARALLEL_THRESHOLD) {
+		    find_boundary(0, n, frontier);
+		} else {
+		    std::mutex lock;
+		    parallel_for_slice(
+			0, n,
+			[&](index_t from, index_t to) {
+			    vector<index_t> local_frontier;
+			    find_boundary(from, to, local_frontier);
+			    std::lock_guard<std::mutex> guard(lock);
+			    frontier.insert(
+				frontier.end(),
+				local_frontier.begin(), local_frontier.end()
+			    );
+			}
+		    );
+		}
+
+		vector<index_t> next;
+		for(index_t r=0; r<nb_rings && !frontier.empty(); ++r) {
+		    next.clear();
+		    if(frontier.size() < PARALLEL_THRESHOLD) {
+			expand(mark.get(), frontier, 0, frontier.size(), next);
+		    } else {
+			std::mutex lock;
+			parallel_for_slice(
+			    0, index_t(frontier.size()),
+			    [&](index_t from, index_t to) {
+				vector<index_t> local_next;
+				expand(mark.get(), frontier, from, to, local_next);
+				std::lock_guard<std::mutex> guard(lock);
+				next.insert(
+				    next.end(), local_next.begin(), local_next.end()
+				);
+			    }
+			);
+		    }
+		    for(index_t i: next) {
+			selection[i] = value;
+		    }
+		    frontier.swap(next);
+		}
+	    }
+
+	protected:
+	    /**
+	     * \brief Calls a function for each neighbor of an element.
+	     * \param[in] i the element
+	     * \param[in] f the function, called with the index of each
+	     *  neighbor (some neighbors may be visited several times)
+	     */
+	    template <class F> void for_each_neighbor(
+		index_t i, const F& f
+	    ) const {
+		switch(where_) {
+		case MESH_VERTICES: {
+		    for(index_t a=v_adj_ptr_[i]; a<v_adj_ptr_[i+1]; ++a) {
+			f(v_adj_[a]);
+		    }
+		} break;
+		case MESH_FACETS: {
+		    index_t N = M_->facets.nb_vertices(i);
+		    for(index_t le=0; le<N; ++le) {
+			index_t j = M_->facets.adjacent(i,le);
+			if(j != NO_INDEX) {
+			    f(j);
+			}
+		    }
+		} break;
+		case MESH_CELLS: {
+		    index_t N = M_->cells.nb_facets(i);
+		    for(index_t lf=0; lf<N; ++lf) {
+			index_t j = M_->cells.adjacent(i,lf);
+			if(j != NO_INDEX) {
+			    f(j);
+			}
+		    }
+		} break;
+		default:
+		    geo_assert_not_reached;
+		}
+	    }
+
+	    /**
+	     * \brief Visits the neighbors of the elements of a frontier.
+	     * \details Can be called concurrently on disjoint ranges of
+	     *  the frontier.
+	     * \param[in,out] mark one flag per element, set for the elements
+	     *  that already have the propagated value
+	     * \param[in] frontier the current frontier
+	     * \param[in] from , to the range of the frontier to be visited
+	     * \param[out] next the newly marked elements are appended there
+	     */
+	    void expand(
+		std::atomic<Numeric::uint8>* mark,
+		const vector<index_t>& frontier, size_t from, size_t to,
+		vector<index_t>& next
+	    ) const {
+		auto visit = [&](index_t j) {
+		    if(
+			mark[j].load(std::memory_order_relaxed) == 0 &&
+			mark[j].exchange(1, std::memory_order_relaxed) == 0
+		    ) {
+			next.push_back(j);
+		    }
+		};
+		for(size_t k=from; k<to; ++k) {
+		    for_each_neighbor(frontier[k], visit);
+		}
+	    }
+
+	    /**
+	     * \brief Computes the vertex-to-vertex adjacency, in compressed
+	     *  row form.
+	     * \details Two vertices are adjacent if they share a facet edge
+	     *  or a cell facet edge. Neighbors may be listed several times.
+	     */
+	    void init_vertices_adjacency() {
+		index_t nv = M_->vertices.nb();
+		v_adj_ptr_.assign(nv+1, 0);
+		for(int pass=0; pass<2; ++pass) {
+		    vector<index_t> cur;
+		    if(pass == 1) {
+			for(index_t v=0; v<nv; ++v) {
+			    v_adj_ptr_[v+1] += v_adj_ptr_[v];
+			}
+			v_adj_.resize(v_adj_ptr_[nv]);
+			cur.assign(v_adj_ptr_.begin(), v_adj_ptr_.end()-1);
+		    }
+		    auto add_edge = [&](index_t v1, index_t v2) {
+			if(pass == 0) {
+			    ++v_adj_ptr_[v1+1];
+			    ++v_adj_ptr_[v2+1];
+			} else {
+			    v_adj_[cur[v1]++] = v2;
+			    v_adj_[cur[v2]++] = v1;
+			}
+		    };
+		    for(index_t f: M_->facets) {
+			index_t N = M_->facets.nb_vertices(f);
+			for(index_t lv1=0; lv1<N; ++lv1) {
+			    index_t lv2 = (lv1+1) % N;
+			    add_edge(
+				M_->facets.vertex(f,lv1),
+				M_->facets.vertex(f,lv2)
+			    );
+			}
+		    }
+		    for(index_t c: M_->cells) {
+			for(index_t lf=0; lf<M_->cells.nb_facets(c); ++lf) {
+			    index_t N = M_->cells.facet_nb_vertices(c,lf);
+			    for(index_t lv1=0; lv1<N; ++lv1) {
+				index_t lv2 = (lv1+1) % N;
+				add_edge(
+				    M_->cells.facet_vertex(c,lf,lv1),
+				    M_->cells.facet_vertex(c,lf,lv2)
+				);
+			    }
+			}
+		    }
+		}
+	    }
+
+	private:
+	    /**
+	     * \brief Frontiers larger than this are expanded in parallel.
+	     */
+	    static constexpr size_t PARALLEL_THRESHOLD = 65536;
+
+	    MeshGrob* M_;
+	    MeshElementsFlags where_;
+	    vector<index_t> v_adj_ptr_;
+	    vector<index_t> v_adj_;
+	};
+
+	/**
+	 * \brief Tests whether selection growth is supported for a
+	 *  given localisation.
+	 * \param[in] where the localisation
+	 * \retval true if \p where is one of MESH_VERTICES, MESH_FACETS,
+	 *  MESH_CELLS
+	 * \retval false otherwise (and an error message is displayed)
+	 */
+	bool check_growth_localisation(MeshElementsFlags where) {
+	    if(where == MESH_NONE) {
+		Logger::err("Selection") << "No visible selection"
+					 << std::endl;
+		return false;
+	    }
+	    if(
+		where != MESH_VERTICES &&
+		where != MESH_FACETS &&
+		where != MESH_CELLS
+	    ) {
                 Logger::err("Selection") << "Invalid localisation"
                                          << std::endl;
-            } break;
-            }
+		return false;
+	    }
+	    return true;
+	}
+    }
 
-            for(index_t i: mesh_grob()->get_subelements_by_type(where)) {
-                selection[i] = new_selection[i];
-            }
+    void MeshGrobSelectionsCommands::enlarge_selection(index_t nb_times) {
+        MeshElementsFlags where = visible_selection();
+        if(!check_growth_localisation(where)) {
+            return;
         }
-
+        Attribute<bool> selection(
+            mesh_grob()->get_subelements_by_type(where).attributes(),
+            "selection"
+        );
+        SelectionGrowth growth(mesh_grob(), where);
+        growth.propagate(selection, true, nb_times);
         mesh_grob()->update();
     }
 
     void MeshGrobSelectionsCommands::shrink_selection(index_t nb_times) {
         MeshElementsFlags where = visible_selection();
-        if(where == MESH_NONE) {
-            Logger::err("Selection") << "No visible selection"
-                                     << std::endl;
+        if(!check_growth_localisation(where)) {
             return;
         }
-        // Feeling lazy today !
-        // (shrink selection <=> enlarge complement of selection)
-        invert_selection();
-        enlarge_selection(nb_times);
-        invert_selection();
+        // shrink selection <=> enlarge complement of selection
+        Attribute<bool> selection(
+            mesh_grob()->get_subelements_by_type(where).attributes(),
+            "selection"
+        );
+        SelectionGrowth growth(mesh_grob(), where);
+        growth.propagate(selection, false, nb_times);
         mesh_grob()->update();
     }
 
@@ -230,17 +424,17 @@ namespace OGF {
         index_t hole_size
     ) {
         MeshElementsFlags where = visible_selection();
-        if(where == MESH_NONE) {
-            Logger::err("Selection") << "No visible selection"
-                                     << std::endl;
+        if(!check_growth_localisation(where)) {
             return;
         }
-        for(index_t i=0; i<hole_size; ++i) {
-            enlarge_selection();
-        }
-        for(index_t i=0; i<hole_size; ++i) {
-            shrink_selection();
-        }
+        Attribute<bool> selection(
+            mesh_grob()->get_subelements_by_type(where).attributes(),
+            "selection"
+        );
+        SelectionGrowth growth(mesh_grob(), where);
+        growth.propagate(selection, true, hole_size);
+        growth.propagate(selection, false, hole_size);
+        mesh_grob()->update();
     }
 
     void MeshGrobSelectionsCommands::delete_selected_elements(
@@ -531,9 +725,9 @@ namespace OGF {
 
         bool has_intersections = false;
 
-        MeshFacetsAABB AABB(*mesh_grob());
+        std::shared_ptr<const MeshFacetsAABB> AABB = mesh_grob()->facets_AABB();
         vector<std::pair<index_t, index_t> > candidates;
-        AABB.compute_facet_bbox_intersections(
+        AABB->compute_facet_bbox_intersections(
             [&](index_t f1, index_t f2) {
                 if(f1 == f2) {
                     return;
@@ -591,25 +785,219 @@ namespace OGF {
         mesh_grob()->update();
     }
 
+    namespace {
+
+	/**
+	 * \brief Detects duplicated mesh elements by hashing their sorted
+	 *  vertex tuples.
+	 * \details Works in place on the mesh. Memory usage is a hash and
+	 *  an index per element. Two elements are duplicates if they have
+	 *  the same type and the same set of vertices.
+	 */
+	class DuplicatesDetector {
+	public:
+	    /**
+	     * \brief Gets the sorted vertices of an element.
+	     * \param[in] M the mesh
+	     * \param[in] where one of MESH_FACETS, MESH_CELLS
+	     * \param[in] e the element
+	     * \param[out] V the sorted vertices, followed by the cell type
+	     *  for cells
+	     */
+	    static void sorted_vertices(
+		const Mesh& M, MeshElementsFlags where, index_t e,
+		vector<index_t>& V
+	    ) {
+		V.clear();
+		if(where == MESH_FACETS) {
+		    for(index_t lv=0; lv<M.facets.nb_vertices(e); ++lv) {
+			V.push_back(M.facets.vertex(e,lv));
+		    }
+		    std::sort(V.begin(), V.end());
+		} else {
+		    for(index_t lv=0; lv<M.cells.nb_vertices(e); ++lv) {
+			V.push_back(M.cells.vertex(e,lv));
+		    }
+		    std::sort(V.begin(), V.end());
+		    V.push_back(index_t(M.cells.type(e)));
+		}
+	    }
+
+	    /**
+	     * \brief Finds the duplicated elements.
+	     * \param[in] M the mesh
+	     * \param[in] where one of MESH_FACETS, MESH_CELLS
+	     * \param[in] is_duplicate a function called with each
+	     *  duplicated element. In each set of duplicated elements, all
+	     *  elements but the one with the smallest index are duplicates.
+	     *  Facets with a repeated vertex are also reported, as
+	     *  mesh_repair() does.
+	     */
+	    template <class F> static void find(
+		const Mesh& M, MeshElementsFlags where, const F& is_duplicate
+	    ) {
+		index_t nb = (where == MESH_FACETS) ?
+		    M.facets.nb() : M.cells.nb();
+		vector<Numeric::uint64> hash(nb);
+		parallel_for_slice(
+		    0, nb, [&](index_t from, index_t to) {
+			vector<index_t> V;
+			for(index_t e=from; e<to; ++e) {
+			    sorted_vertices(M, where, e, V);
+			    Numeric::uint64 h = 14695981039346656037ull;
+			    for(index_t v: V) {
+				h ^= Numeric::uint64(v);
+				h *= 1099511628211ull;
+			    }
+			    hash[e] = h;
+			}
+		    }
+		);
+
+		vector<index_t> order(nb);
+		for(index_t e=0; e<nb; ++e) {
+		    order[e] = e;
+		}
+		GEO::sort(
+		    order.begin(), order.end(),
+		    [&](index_t e1, index_t e2)->bool {
+			return (hash[e1] < hash[e2]) ||
+			    (hash[e1] == hash[e2] && e1 < e2);
+		    }
+		);
+
+		vector<index_t> V1;
+		vector<index_t> V2;
+		for(index_t b=0; b<nb; ) {
+		    index_t e = b+1;
+		    while(e < nb && hash[order[e]] == hash[order[b]]) {
+			++e;
+		    }
+		    // Elements in [b,e) have the same hash, they are sorted
+		    // by increasing index. Compare actual vertices to handle
+		    // hash collisions.
+		    for(index_t i=b+1; i<e; ++i) {
+			sorted_vertices(M, where, order[i], V1);
+			for(index_t j=b; j<i; ++j) {
+			    sorted_vertices(M, where, order[j], V2);
+			    if(V1 == V2) {
+				is_duplicate(order[i]);
+				break;
+			    }
+			}
+		    }
+		    b = e;
+		}
+
+		if(where == MESH_FACETS) {
+		    parallel_for(
+			0, nb, [&](index_t f) {
+			    index_t N = M.facets.nb_vertices(f);
+			    for(index_t lv=0; lv<N; ++lv) {
+				if(
+				    M.facets.vertex(f,lv) ==
+				    M.facets.vertex(f,(lv+1)%N)
+				) {
+				    is_duplicate(f);
+				    break;
+				}
+			    }
+			}
+		    );
+		}
+	    }
+	};
+
+	/**
+	 * \brief Selects duplicated facets by copying the mesh and calling
+	 *  mesh_repair().
+	 * \details This is the previous implementation of
+	 *  MeshGrobSelectionsCommands::select_duplicated_facets(), used as a
+	 *  reference when dbg:duplicates_benchmark is set.
+	 * \param[in] mesh the mesh
+	 * \param[out] selection one boolean per facet
+	 */
+	void select_duplicated_facets_reference(
+	    const Mesh& mesh, vector<bool>& selection
+	) {
+	    Mesh M;
+	    M.copy(mesh);
+	    Attribute<index_t> orig_facet(M.facets.attributes(), "orig_facet");
+	    for(index_t f: M.facets) {
+		orig_facet[f] = f;
+	    }
+	    mesh_repair(M, MESH_REPAIR_DUP_F);
+	    selection.assign(mesh.facets.nb(), true);
+	    for(index_t f: M.facets) {
+		selection[orig_facet[f]] = false;
+	    }
+	}
+    }
+
     void MeshGrobSelectionsCommands::select_duplicated_facets() {
-        Mesh M;
-        M.copy(*mesh_grob());
-        Attribute<index_t> orig_facet(M.facets.attributes(), "orig_facet");
-        for(index_t f: M.facets) {
-            orig_facet[f] = f;
-        }
-        mesh_repair(M, MESH_REPAIR_DUP_F);
         Attribute<bool> selection(mesh_grob()->facets.attributes(), "selection");
-        for(index_t f: mesh_grob()->facets) {
-            selection[f] = true;
+        double t = 0.0;
+        {
+            Stopwatch W("Dup facets",false);
+            // Duplicates may be reported from several threads, they are
+            // flagged in a plain array before updating the selection.
+            vector<Numeric::uint8> dup(mesh_grob()->facets.nb(), 0);
+            DuplicatesDetector::find(
+                *mesh_grob(), MESH_FACETS,
+                [&](index_t f) { dup[f] = 1; }
+            );
+            for(index_t f: mesh_grob()->facets) {
+                selection[f] = (dup[f] != 0);
+            }
+            t = W.elapsed_time();
         }
-        for(index_t f: M.facets) {
-            selection[orig_facet[f]] = false;
+
+        if(
+            CmdLine::arg_is_declared("dbg:duplicates_benchmark") &&
+            CmdLine::get_arg_bool("dbg:duplicates_benchmark")
+        ) {
+            vector<bool> ref_selection;
+            double t_ref = 0.0;
+            {
+                Stopwatch W("Dup facets ref",false);
+                select_duplicated_facets_reference(
+                    *mesh_grob(), ref_selection
+                );
+                t_ref = W.elapsed_time();
+            }
+            index_t nb = 0;
+            index_t nb_ref = 0;
+            index_t nb_mismatch = 0;
+            for(index_t f: mesh_grob()->facets) {
+                nb += index_t(selection[f]);
+                nb_ref += index_t(ref_selection[f]);
+                nb_mismatch += index_t(selection[f] != ref_selection[f]);
+            }
+            Logger::out("Duplicates")
+                << "reference: " << t_ref << " s (" << nb_ref << " selected) "
+                << "hash: " << t << " s (" << nb << " selected) "
+                << "mismatches: " << nb_mismatch
+                << std::endl;
         }
+
         show_facets_selection();
 	mesh_grob()->update();
     }
 
+    void MeshGrobSelectionsCommands::select_duplicated_cells() {
+        Attribute<bool> selection(mesh_grob()->cells.attributes(), "selection");
+        vector<Numeric::uint8> dup(mesh_grob()->cells.nb(), 0);
+        DuplicatesDetector::find(
+            *mesh_grob(), MESH_CELLS,
+            [&](index_t c) { dup[c] = 1; }
+        );
+        for(index_t c: mesh_grob()->cells) {
+            selection[c] = (dup[c] != 0);
+        }
+        show_cells_selection();
+	mesh_grob()->update();
+    }
+
     void MeshGrobSelectionsCommands::select_facets_on_border() {
         Attribute<bool> selection(mesh_grob()->facets.attributes(), "selection");
         for(index_t f: mesh_grob()->facets) {
@@ -674,9 +1062,9 @@ namespace OGF {
         );
         try {
             Filter filter(selection.size(), selection_string);
-            for(index_t i=0; i<selection.size(); ++i) {
+            parallel_for(0, selection.size(), [&](index_t i) {
                 selection[i] = filter.test(i);
-            }
+            });
         } catch(...) {
             Logger::err("Attributes") << "Invalid filter specification"
                                       << std::endl;
@@ -177,8 +177,10 @@ namespace OGF {
         );
 
         /**
-         * \brief For each set of duplicated facet, select one facet of
-         *  the set.
+         * \brief For each set of duplicated facet, select all the facets
+         *  of the set but one.
+         * \details Facets are duplicated if they have the same vertices.
+         *  Facets with a repeated vertex are also selected.
          * \menu Facets
          */
         void select_duplicated_facets();
@@ -199,6 +201,15 @@ namespace OGF {
          */
         void show_cells_selection();
 
+        /**
+         * \brief For each set of duplicated cells, select all the cells
+         *  of the set but one.
+         * \details Cells are duplicated if they have the same type and the
+         *  same vertices.
+         * \menu Cells
+         */
+        void select_duplicated_cells();
+
     protected:
         /**
          * \brief Gets the selection displayed in the current shader, or
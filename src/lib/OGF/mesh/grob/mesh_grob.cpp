@@ -41,17 +41,131 @@
 #include <OGF/scene_graph/types/scene_graph.h>
 #include <OGF/scene_graph/types/scene_graph_library.h>
 #include <OGF/scene_graph/types/geofile.h>
+#include <OGF/scene_graph/grob/grob_snapshot.h>
 #include <OGF/gom/reflection/meta_class.h>
 
 #include <geogram/mesh/mesh_io.h>
 #include <geogram/mesh/mesh_geometry.h>
+#include <geogram/mesh/mesh_AABB.h>
+#include <geogram/mesh/mesh_reorder.h>
+#include <geogram/points/nn_search.h>
+#include <geogram/basic/stopwatch.h>
 #include <geogram/basic/file_system.h>
+#include <geogram/basic/string.h>
+#include <geogram/basic/process.h>
+
+#include <mutex>
+#include <limits>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Gets the memory used by the attributes of a mesh
+     *  sub-element store.
+     * \param[in] attributes the AttributesManager
+     * \return the number of bytes used by the attributes
+     */
+    size_t attributes_memory_size(const AttributesManager& attributes) {
+        size_t result = 0;
+        vector<std::string> names;
+        attributes.list_attribute_names(names);
+        for(const std::string& name: names) {
+            const AttributeStore* store = attributes.find_attribute_store(name);
+            if(store != nullptr) {
+                result +=
+                    size_t(store->size()) * size_t(store->dimension()) *
+                    store->element_size();
+            }
+        }
+        return result;
+    }
+
+    /**
+     * \brief A GrobSnapshot that keeps a copy of a MeshGrob in memory.
+     * \details The copy is saved to a file when it is spilled.
+     */
+    class MeshGrobSnapshot : public GrobSnapshot {
+    public:
+        MeshGrobSnapshot(MeshGrob* grob) : GrobSnapshot(grob) {
+            if(!is_lazy()) {
+                mesh_.copy(*grob, true, all_elements());
+            }
+        }
+
+        size_t memory_size() const override {
+            if(has_file()) {
+                return 0;
+            }
+            // Attributes (including vertices coordinates) and
+            // combinatorics.
+            size_t result =
+                attributes_memory_size(mesh_.vertices.attributes()) +
+                attributes_memory_size(mesh_.edges.attributes()) +
+                attributes_memory_size(mesh_.facets.attributes()) +
+                attributes_memory_size(mesh_.facet_corners.attributes()) +
+                attributes_memory_size(mesh_.cells.attributes()) +
+                attributes_memory_size(mesh_.cell_corners.attributes()) +
+                attributes_memory_size(mesh_.cell_facets.attributes());
+            result += sizeof(index_t) * (
+                2 * size_t(mesh_.edges.nb()) +
+                size_t(mesh_.facets.nb()) +
+                2 * size_t(mesh_.facet_corners.nb()) +
+                2 * size_t(mesh_.cells.nb()) +
+                size_t(mesh_.cell_corners.nb()) +
+                size_t(mesh_.cell_facets.nb())
+            );
+            return result;
+        }
+
+    protected:
+        bool restore_data(Grob* grob) override {
+            MeshGrob* mesh_grob = dynamic_cast<MeshGrob*>(grob);
+            geo_assert(mesh_grob != nullptr);
+            if(is_lazy()) {
+                mesh_grob->clear();
+                return true;
+            }
+            if(has_file()) {
+                mesh_grob->clear();
+                return read_file(
+                    [mesh_grob](InputGraphiteFile& in)->bool {
+                        return mesh_load(in, *mesh_grob);
+                    }
+                );
+            }
+            mesh_grob->copy(mesh_, true, all_elements());
+            return true;
+        }
+
+        bool spill_data() override {
+            bool result = write_file(
+                [this](OutputGraphiteFile& out)->bool {
+                    return mesh_save(mesh_, out);
+                }
+            );
+            if(result) {
+                mesh_.clear(false, false);
+            }
+            return result;
+        }
+
+        static MeshElementsFlags all_elements() {
+            return MeshElementsFlags(
+                MESH_VERTICES | MESH_EDGES | MESH_FACETS | MESH_CELLS
+            );
+        }
+
+    private:
+        Mesh mesh_;
+    };
+}
 
 namespace OGF {
 
     MeshGrob::MeshGrob(
 	CompositeGrob* parent, const std::string& name_in
-    ) : Grob(parent) {
+    ) : Grob(parent), morton_ordered_(false) {
 	std::string name = name_in;
 	if(name == "") {
 	    name = "mesh";
@@ -60,7 +174,9 @@ namespace OGF {
 	// Called from SceneGraph::create_object() that calls update_values()
     }
 
-    MeshGrob::MeshGrob(const std::string& name_in) : Grob() {
+    MeshGrob::MeshGrob(
+	const std::string& name_in
+    ) : Grob(), morton_ordered_(false) {
 	std::string name = name_in;
 	if(name == "") {
 	    name = "mesh";
@@ -73,13 +189,108 @@ namespace OGF {
     }
 
     void MeshGrob::update() {
+        morton_ordered_ = false;
+        invalidate_spatial_index();
         Grob::update();
     }
 
+    void MeshGrob::prepare_for_AABB(bool triangulate) {
+        //   The AABB trees split the elements by index range, and are
+        // only efficient if the elements are spatially sorted. Like
+        // MeshFacetsAABB / MeshCellsAABB with reorder=true, sort the
+        // mesh once (and triangulate the facets if needed), until the
+        // next update() that does not come from here. Do it with
+        // the graphics locked, and notify the change (update() also
+        // discards the cached spatial search structures, hence it is
+        // done before locking them).
+        lock_graphics();
+        if(triangulate && !facets.are_simplices()) {
+            facets.triangulate();
+        }
+        mesh_reorder(*this, MESH_ORDER_MORTON);
+        unlock_graphics();
+        update();
+        morton_ordered_ = true;
+    }
+
+    std::shared_ptr<const MeshFacetsAABB> MeshGrob::facets_AABB() {
+        if(!morton_ordered_ || !facets.are_simplices()) {
+            prepare_for_AABB(true);
+        }
+        std::lock_guard<std::mutex> lock(spatial_index_lock_);
+        if(facets_AABB_ == nullptr) {
+            Stopwatch W("AABB facets", false);
+            facets_AABB_ = std::make_shared<const MeshFacetsAABB>(
+                *this, false // already reordered by prepare_for_AABB()
+            );
+            Logger::out("AABB") << "Built facets AABB in "
+                                << W.elapsed_time() << "s" << std::endl;
+        }
+        return facets_AABB_;
+    }
+
+    std::shared_ptr<const MeshCellsAABB> MeshGrob::cells_AABB() {
+        if(!morton_ordered_) {
+            prepare_for_AABB(false);
+        }
+        std::lock_guard<std::mutex> lock(spatial_index_lock_);
+        if(cells_AABB_ == nullptr) {
+            Stopwatch W("AABB cells", false);
+            cells_AABB_ = std::make_shared<const MeshCellsAABB>(
+                *this, false // already reordered by prepare_for_AABB()
+            );
+            Logger::out("AABB") << "Built cells AABB in "
+                                << W.elapsed_time() << "s" << std::endl;
+        }
+        return cells_AABB_;
+    }
+
+    std::shared_ptr<const NearestNeighborSearch> MeshGrob::vertices_NN() {
+        std::lock_guard<std::mutex> lock(spatial_index_lock_);
+        if(vertices_NN_ == nullptr) {
+            coord_index_t dim = coord_index_t(
+                std::min(vertices.dimension(), index_t(3))
+            );
+            NearestNeighborSearch* NN = NearestNeighborSearch::create(dim);
+            NN->set_points(
+                vertices.nb(),
+                vertices.nb() == 0 ? nullptr : vertices.point_ptr(0),
+                vertices.dimension()
+            );
+            // NearestNeighborSearch is reference-counted, the shared
+            // pointer owns one reference.
+            NN->ref();
+            vertices_NN_ = std::shared_ptr<const NearestNeighborSearch>(
+                NN, [](const NearestNeighborSearch* p) { p->unref(); }
+            );
+        }
+        return vertices_NN_;
+    }
+
+    void MeshGrob::invalidate_spatial_index() {
+        std::lock_guard<std::mutex> lock(spatial_index_lock_);
+        facets_AABB_.reset();
+        cells_AABB_.reset();
+        vertices_NN_.reset();
+    }
+
     bool MeshGrob::load(const FileName& value) {
         MeshIOFlags flags;
 	flags.set_attributes(MESH_ALL_ATTRIBUTES);
-        bool result = GEO::mesh_load(value, *this, flags);
+        bool result = false;
+        if(Process::is_running_threads()) {
+            //   Called by a worker thread (SceneGraph::load_objects_batch()):
+            // same as mesh_load(), without the messages and statistics
+            // (the Logger is not thread-safe). Errors are reported by the
+            // caller.
+            GEO::Mesh::clear();
+            MeshIOHandler_var handler = MeshIOHandlerFactory::create_object(
+                String::to_lowercase(FileSystem::extension(value))
+            );
+            result = (handler != nullptr) && handler->load(value,*this,flags);
+        } else {
+            result = GEO::mesh_load(value, *this, flags);
+        }
 	if(result) {
 	    if(vertices.single_precision()) {
 		vertices.set_double_precision();
@@ -113,6 +324,7 @@ namespace OGF {
     }
 
     bool MeshGrob::save(const NewFileName& value) {
+        materialize();
 	if(FileSystem::extension(value) == "graphite") {
 	    return Grob::save(value);
 	}
@@ -136,39 +348,118 @@ namespace OGF {
     }
 
     Box3d MeshGrob::bbox() const {
-        Box3d result;
+        // The data of lazy objects is not read yet.
+        if(is_lazy()) {
+            return lazy_bbox();
+        }
 
         // If there is a vertex filter, apply it.
+        Attribute<Numeric::uint8> filter;
         Object* shader = get_shader();
         if(shader != nullptr) {
             if(shader->has_property("vertices_filter")) {
                 std::string prop;
                 shader->get_property("vertices_filter", prop);
                 if(prop == "true") {
-                    Attribute<Numeric::uint8> filter;
                     filter.bind_if_is_defined(
                         this->vertices.attributes(),"filter"
                     );
-                    if(filter.is_bound()) {
-                        for(index_t v: vertices) {
-                            if(filter[v] != 0) {
-                                result.add_point(vec3(vertices.point_ptr(v)));
-                            }
-                        }
-                        return result;
-                    }
                 }
             }
         }
 
-        if(vertices.nb() != 0) {
-            double xyzmin[3];
-            double xyzmax[3];
-            GEO::get_bbox(*this, xyzmin, xyzmax);
-            result.add_point(vec3(xyzmin));
-            result.add_point(vec3(xyzmax));
+        if(filter.is_bound()) {
+            if(!filtered_bbox_cache_valid_) {
+                filtered_bbox_cache_ = compute_bbox(&filter);
+                filtered_bbox_cache_valid_ = true;
+            }
+            return filtered_bbox_cache_;
+        }
+
+        if(!bbox_cache_valid_) {
+            bbox_cache_ = compute_bbox(nullptr);
+            bbox_cache_valid_ = true;
+        }
+        return bbox_cache_;
+    }
+
+    Box3d MeshGrob::compute_bbox(
+        const Attribute<Numeric::uint8>* filter
+    ) const {
+        Box3d result;
+        if(vertices.nb() == 0) {
+            return result;
+        }
+
+        // Non-standard vertices (2d or single precision): use the
+        // generic sequential implementation.
+        if(vertices.dimension() < 3 || vertices.single_precision()) {
+            if(filter == nullptr) {
+                double xyzmin[3];
+                double xyzmax[3];
+                GEO::get_bbox(*this, xyzmin, xyzmax);
+                result.add_point(vec3(xyzmin));
+                result.add_point(vec3(xyzmax));
+                return result;
+            }
+            // Missing coordinates are zero.
+            index_t dim = std::min(vertices.dimension(), index_t(3));
+            for(index_t v: vertices) {
+                if((*filter)[v] == 0) {
+                    continue;
+                }
+                vec3 p(0.0, 0.0, 0.0);
+                for(index_t c=0; c<dim; ++c) {
+                    p[c] = vertices.single_precision() ?
+                        double(vertices.single_precision_point_ptr(v)[c]) :
+                        vertices.point_ptr(v)[c];
+                }
+                result.add_point(p);
+            }
+            return result;
+        }
+
+        // Small meshes: not worth starting threads.
+        const index_t parallel_threshold = 100000;
+        if(vertices.nb() < parallel_threshold) {
+            for(index_t v: vertices) {
+                if(filter == nullptr || (*filter)[v] != 0) {
+                    result.add_point(vec3(vertices.point_ptr(v)));
+                }
+            }
+            return result;
         }
 
+        // Parallel min/max reduction: each slice computes its own
+        // box, then partial boxes are merged.
+        std::mutex lock;
+        parallel_for_slice(
+            0, vertices.nb(),
+            [this,filter,&result,&lock](index_t from, index_t to) {
+                index_t dim = vertices.dimension();
+                const double* p = vertices.point_ptr(0);
+                const double big = std::numeric_limits<double>::max();
+                double xyzmin[3] = {  big,  big,  big };
+                double xyzmax[3] = { -big, -big, -big };
+                bool found = false;
+                for(index_t v=from; v<to; ++v) {
+                    if(filter != nullptr && (*filter)[v] == 0) {
+                        continue;
+                    }
+                    found = true;
+                    const double* pv = p + dim * v;
+                    for(index_t c=0; c<3; ++c) {
+                        xyzmin[c] = std::min(xyzmin[c], pv[c]);
+                        xyzmax[c] = std::max(xyzmax[c], pv[c]);
+                    }
+                }
+                if(found) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    result.add_point(vec3(xyzmin));
+                    result.add_point(vec3(xyzmax));
+                }
+            }
+        );
         return result;
     }
 
@@ -196,6 +487,10 @@ namespace OGF {
         if(sg->is_bound(name)) {
             result = dynamic_cast<MeshGrob*>(sg->resolve(name));
         }
+        // Commands access the data directly
+        if(result != nullptr) {
+            result->materialize();
+        }
         return result;
     }
 
@@ -273,6 +568,10 @@ namespace OGF {
         return true;
     }
 
+    bool MeshGrob::supports_concurrent_serialization() const {
+        return true;
+    }
+
     bool MeshGrob::serialize_read(InputGraphiteFile& geofile) {
         bool result = mesh_load(geofile, *this);
         update();
@@ -283,6 +582,10 @@ namespace OGF {
         return mesh_save(*this, geofile);
     }
 
+    GrobSnapshot* MeshGrob::create_snapshot() {
+        return new MeshGrobSnapshot(this);
+    }
+
 
     std::string MeshGrob::list_attributes(
         const std::string& localisations_in,
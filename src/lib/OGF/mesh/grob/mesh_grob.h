@@ -43,6 +43,14 @@
 #include <OGF/mesh/common/common.h>
 #include <OGF/scene_graph/grob/grob.h>
 #include <geogram/mesh/mesh.h>
+#include <memory>
+#include <mutex>
+
+namespace GEO {
+    class MeshFacetsAABB;
+    class MeshCellsAABB;
+    class NearestNeighborSearch;
+}
 
 /**
  * \file OGF/mesh/grob/mesh_grob.h
@@ -104,6 +112,11 @@ namespace OGF {
          */
         bool is_serializable() const override;
 
+        /**
+         * \copydoc Grob::supports_concurrent_serialization()
+         */
+        bool supports_concurrent_serialization() const override;
+
         /**
          * \copydoc Grob::serialize_read()
          */
@@ -114,6 +127,13 @@ namespace OGF {
          */
 	bool serialize_write(OutputGraphiteFile& geofile) override;
 
+        /**
+         * \copydoc Grob::create_snapshot()
+         * \details The snapshot is a copy of the mesh in memory, with
+         *  all its attributes.
+         */
+        GrobSnapshot* create_snapshot() override;
+
 
     gom_properties:
 
@@ -172,6 +192,53 @@ namespace OGF {
          */
         Box3d bbox() const override;
 
+        /**
+         * \brief Gets the axis-aligned bounding box tree of the facets.
+         * \details The tree is created on first use and shared by all
+         *  the callers until the next update(). The returned tree can be
+         *  queried concurrently from several threads, and remains valid
+         *  as long as the caller keeps the pointer (even if update() is
+         *  called meanwhile), but it should not be used after the facets
+         *  are modified.
+         * \note Before creating the tree, the mesh is sorted in Morton
+         *  order and its facets are triangulated if they are not all
+         *  triangles (as in MeshFacetsAABB), so that the facet indices
+         *  returned by the tree refer to this mesh. This is done with the
+         *  graphics locked, and is followed by an update(). For this
+         *  reason, the function needs to be called from the main thread,
+         *  and element indices obtained before calling it are no longer
+         *  valid.
+         * \return a pointer to the facets AABB
+         */
+        std::shared_ptr<const MeshFacetsAABB> facets_AABB();
+
+        /**
+         * \brief Gets the axis-aligned bounding box tree of the cells.
+         * \details Same as facets_AABB() but for the cells. The mesh is
+         *  sorted in Morton order before creating the tree.
+         * \return a pointer to the cells AABB
+         */
+        std::shared_ptr<const MeshCellsAABB> cells_AABB();
+
+        /**
+         * \brief Gets a nearest neighbor search structure for the
+         *  vertices.
+         * \details Same as facets_AABB() but for the vertices. The search
+         *  structure refers to the coordinates stored in the mesh, and
+         *  uses the first three of them (or two for 2d meshes).
+         * \return a pointer to the NearestNeighborSearch
+         */
+        std::shared_ptr<const NearestNeighborSearch> vertices_NN();
+
+        /**
+         * \brief Discards the cached spatial search structures.
+         * \details Called by update(). Code that modifies the geometry
+         *  without calling update() afterwards needs to call this
+         *  function.
+         * \see facets_AABB(), cells_AABB(), vertices_NN()
+         */
+        void invalidate_spatial_index();
+
         /**
          * \brief Finds or creates a MeshGrob with the specified name
          * \param[in] sg a pointer to the SceneGraph
@@ -200,7 +267,32 @@ namespace OGF {
          */
         static void register_geogram_file_extensions();
 
+    protected:
+        /**
+         * \brief Computes the bounding box of the vertices.
+         * \details Uses a parallel min/max reduction for large meshes.
+         *  The result is cached by bbox().
+         * \param[in] filter if non-null, only the vertices with a
+         *  non-zero filter value are taken into account
+         * \return the bounding box
+         */
+        Box3d compute_bbox(const Attribute<Numeric::uint8>* filter) const;
+
     private:
+        /**
+         * \brief Sorts the mesh in Morton order before creating an
+         *  AABB tree.
+         * \details Sets morton_ordered_, reset by the next update().
+         * \param[in] triangulate if set, the facets are also triangulated
+         *  if they are not all triangles
+         */
+        void prepare_for_AABB(bool triangulate);
+
+        bool morton_ordered_;
+        std::mutex spatial_index_lock_;
+        std::shared_ptr<const MeshFacetsAABB> facets_AABB_;
+        std::shared_ptr<const MeshCellsAABB> cells_AABB_;
+        std::shared_ptr<const NearestNeighborSearch> vertices_NN_;
     };
 
     /**
@@ -37,6 +37,7 @@
 
 
 #include <OGF/mesh_gfx/shaders/mesh_grob_shader.h>
+#include <OGF/mesh_gfx/tools/mesh_grob_picker.h>
 #include <OGF/mesh/commands/mesh_grob_filters_commands.h>
 #include <OGF/renderer/context/rendering_context.h>
 #include <OGF/basic/os/file_manager.h>
@@ -52,11 +53,21 @@ namespace OGF {
 
     MeshGrobShader::MeshGrobShader(
         MeshGrob* grob
-    ) : Shader(grob) {
+    ) : Shader(grob),
+        cpu_picker_(nullptr) {
        no_grob_update_ = true;
     }
 
     MeshGrobShader::~MeshGrobShader() {
+        delete cpu_picker_;
+        cpu_picker_ = nullptr;
+    }
+
+    MeshGrobPicker* MeshGrobShader::cpu_picker() {
+        if(cpu_picker_ == nullptr) {
+            cpu_picker_ = new MeshGrobPicker(mesh_grob());
+        }
+        return cpu_picker_;
     }
 
     void MeshGrobShader::blink() {
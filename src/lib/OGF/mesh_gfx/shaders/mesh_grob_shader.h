@@ -64,6 +64,7 @@ namespace OGF {
 
     class Builder;
     class Texture;
+    class MeshGrobPicker;
 
     enum CullingMode {NO_CULL, CULL_FRONT, CULL_BACK};
 
@@ -105,6 +106,15 @@ namespace OGF {
          */
         void pick_object(index_t object_id) override;
 
+        /**
+         * \brief Gets the picker that finds mesh elements on the CPU.
+         * \details The picker is created on first use. It caches
+         *  the spatial search structures of the mesh, that are
+         *  rebuilt whenever the MeshGrob is modified.
+         * \return a pointer to the MeshGrobPicker
+         */
+        MeshGrobPicker* cpu_picker();
+
         /**
          * \copydoc Shader::blink()
          */
@@ -282,6 +292,9 @@ namespace OGF {
         MeshGrob* mesh_grob() const {
             return static_cast<MeshGrob*>(grob());
         }
+
+    private:
+        MeshGrobPicker* cpu_picker_;
     };
 
     /****************************************************************/
@@ -0,0 +1,562 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL,
+ *  Graphite can be linked with the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+
+
+#include <OGF/mesh_gfx/tools/mesh_grob_picker.h>
+
+#include <geogram/basic/stopwatch.h>
+
+#include <algorithm>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Tolerance for picking vertices and edges, in pixels.
+     */
+    const double PICK_TOLERANCE = 4.0;
+
+    /**
+     * \brief Gets the index used to cache the data associated
+     *  with a type of mesh elements.
+     * \param[in] what one of MESH_VERTICES, MESH_EDGES, MESH_FACETS,
+     *  MESH_CELLS
+     * \return the index in 0..3, or NO_INDEX for other values
+     */
+    index_t element_type_index(MeshElementsFlags what) {
+        switch(what) {
+        case MESH_VERTICES:
+            return 0;
+        case MESH_EDGES:
+            return 1;
+        case MESH_FACETS:
+            return 2;
+        case MESH_CELLS:
+            return 3;
+        default:
+            break;
+        }
+        return NO_INDEX;
+    }
+
+    /**
+     * \brief Gets the name of the filter property of a shader
+     *  for a type of mesh elements.
+     */
+    const char* filter_property_name(MeshElementsFlags what) {
+        switch(what) {
+        case MESH_VERTICES:
+            return "vertices_filter";
+        case MESH_EDGES:
+            return "edges_filter";
+        case MESH_FACETS:
+            return "facets_filter";
+        case MESH_CELLS:
+            return "cells_filter";
+        default:
+            break;
+        }
+        return "";
+    }
+
+    /**
+     * \brief Tests whether a point is in a triangle, in 2d, and
+     *  interpolates the depth.
+     * \param[in] p the point
+     * \param[in] q1 , q2 , q3 the vertices of the triangle, with the
+     *  depth in the z coordinate
+     * \param[out] depth the interpolated depth
+     * \retval true if \p p is in the triangle
+     * \retval false otherwise
+     */
+    bool point_in_triangle_2d(
+        const vec2& p, const vec3& q1, const vec3& q2, const vec3& q3,
+        double& depth
+    ) {
+        double d = (q2.x-q1.x)*(q3.y-q1.y) - (q3.x-q1.x)*(q2.y-q1.y);
+        if(d == 0.0) {
+            return false;
+        }
+        double l1 = ((q2.x-p.x)*(q3.y-p.y) - (q3.x-p.x)*(q2.y-p.y)) / d;
+        double l2 = ((q3.x-p.x)*(q1.y-p.y) - (q1.x-p.x)*(q3.y-p.y)) / d;
+        double l3 = 1.0 - l1 - l2;
+        if(l1 < 0.0 || l2 < 0.0 || l3 < 0.0) {
+            return false;
+        }
+        // Window depth is affine in screen space
+        depth = l1*q1.z + l2*q2.z + l3*q3.z;
+        return true;
+    }
+}
+
+namespace OGF {
+
+    /**
+     * \brief A bounding volume hierarchy on the elements of one
+     *  type (vertices, edges, facets or cells) of a mesh.
+     * \details Elements are not reordered in the mesh, the hierarchy
+     *  stores a permutation. Nodes are stored as in geogram's AABB:
+     *  the root is node 1 and the children of node n are 2n and 2n+1.
+     */
+    class MeshElementsBVH {
+    public:
+        /**
+         * \brief MeshElementsBVH constructor.
+         * \param[in] M the mesh
+         * \param[in] what one of MESH_VERTICES, MESH_EDGES, MESH_FACETS,
+         *  MESH_CELLS
+         */
+        MeshElementsBVH(const Mesh& M, MeshElementsFlags what) {
+            index_t nb = 0;
+            switch(what) {
+            case MESH_VERTICES:
+                nb = M.vertices.nb();
+                break;
+            case MESH_EDGES:
+                nb = M.edges.nb();
+                break;
+            case MESH_FACETS:
+                nb = M.facets.nb();
+                break;
+            case MESH_CELLS:
+                nb = M.cells.nb();
+                break;
+            default:
+                break;
+            }
+
+            vector<Box3d> element_bbox(nb);
+            for(index_t e=0; e<nb; ++e) {
+                Box3d& B = element_bbox[e];
+                switch(what) {
+                case MESH_VERTICES:
+                    B.add_point(vec3(M.vertices.point_ptr(e)));
+                    break;
+                case MESH_EDGES:
+                    for(index_t lv=0; lv<2; ++lv) {
+                        index_t v = M.edges.vertex(e,lv);
+                        B.add_point(vec3(M.vertices.point_ptr(v)));
+                    }
+                    break;
+                case MESH_FACETS:
+                    for(index_t lv=0; lv<M.facets.nb_vertices(e); ++lv) {
+                        index_t v = M.facets.vertex(e,lv);
+                        B.add_point(vec3(M.vertices.point_ptr(v)));
+                    }
+                    break;
+                case MESH_CELLS:
+                    for(index_t lv=0; lv<M.cells.nb_vertices(e); ++lv) {
+                        index_t v = M.cells.vertex(e,lv);
+                        B.add_point(vec3(M.vertices.point_ptr(v)));
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            elements_.resize(nb);
+            for(index_t e=0; e<nb; ++e) {
+                elements_[e] = e;
+            }
+            if(nb != 0) {
+                bboxes_.resize(4*nb+1);
+                build_recursive(1, 0, nb, element_bbox);
+            }
+        }
+
+        /**
+         * \brief Visits the nodes and the elements of the hierarchy.
+         * \param[in] visit_node called with the bounding box of each
+         *  node, returns false if the node should be skipped
+         * \param[in] visit_element called with the index of each
+         *  element in the visited leaves
+         */
+        template <class NODE_F, class ELEMENT_F> void traverse(
+            const NODE_F& visit_node, const ELEMENT_F& visit_element
+        ) const {
+            if(elements_.size() != 0) {
+                traverse_recursive(
+                    1, 0, index_t(elements_.size()),
+                    visit_node, visit_element
+                );
+            }
+        }
+
+    protected:
+        /**
+         * \brief Creates the hierarchy.
+         * \details Elements are split at the median along the longest
+         *  axis of the bounding box of their centers.
+         * \param[in] node the index of the node
+         * \param[in] b , e the range of elements in the node
+         * \param[in] element_bbox the bounding boxes of all the elements
+         */
+        void build_recursive(
+            index_t node, index_t b, index_t e,
+            const vector<Box3d>& element_bbox
+        ) {
+            geo_debug_assert(node < bboxes_.size());
+            if(e - b == 1) {
+                bboxes_[node] = element_bbox[elements_[b]];
+                return;
+            }
+            Box3d centers;
+            for(index_t i=b; i<e; ++i) {
+                centers.add_point(element_bbox[elements_[i]].center());
+            }
+            index_t axis = 0;
+            double extent = 0.0;
+            for(index_t c=0; c<3; ++c) {
+                if(centers.xyz_max[c] - centers.xyz_min[c] > extent) {
+                    extent = centers.xyz_max[c] - centers.xyz_min[c];
+                    axis = c;
+                }
+            }
+            index_t m = b + (e - b) / 2;
+            std::nth_element(
+                elements_.begin() + std::ptrdiff_t(b),
+                elements_.begin() + std::ptrdiff_t(m),
+                elements_.begin() + std::ptrdiff_t(e),
+                [&](index_t e1, index_t e2)->bool {
+                    return
+                        element_bbox[e1].center()[axis] <
+                        element_bbox[e2].center()[axis] ;
+                }
+            );
+            build_recursive(2*node, b, m, element_bbox);
+            build_recursive(2*node+1, m, e, element_bbox);
+            bboxes_[node] = bboxes_[2*node];
+            bboxes_[node].add_box(bboxes_[2*node+1]);
+        }
+
+        /**
+         * \brief The recursive function used by traverse().
+         */
+        template <class NODE_F, class ELEMENT_F> void traverse_recursive(
+            index_t node, index_t b, index_t e,
+            const NODE_F& visit_node, const ELEMENT_F& visit_element
+        ) const {
+            if(!visit_node(bboxes_[node])) {
+                return;
+            }
+            if(e - b == 1) {
+                visit_element(elements_[b]);
+                return;
+            }
+            index_t m = b + (e - b) / 2;
+            traverse_recursive(2*node, b, m, visit_node, visit_element);
+            traverse_recursive(2*node+1, m, e, visit_node, visit_element);
+        }
+
+    private:
+        vector<index_t> elements_;
+        vector<Box3d> bboxes_;
+    };
+
+    /*******************************************************************/
+
+    MeshGrobPicker::MeshGrobPicker(MeshGrob* grob) :
+        grob_(grob),
+        picked_point_(0.0, 0.0, 0.0),
+        picked_depth_(1.0) {
+        for(index_t i=0; i<4; ++i) {
+            bvh_[i] = nullptr;
+            bvh_timestamp_[i] = NO_INDEX;
+        }
+        for(index_t i=0; i<16; ++i) {
+            modelview_[i] = 0.0;
+            project_[i] = 0.0;
+        }
+        for(index_t i=0; i<4; ++i) {
+            viewport_[i] = 0;
+        }
+    }
+
+    MeshGrobPicker::~MeshGrobPicker() {
+        for(index_t i=0; i<4; ++i) {
+            delete bvh_[i];
+            bvh_[i] = nullptr;
+        }
+    }
+
+    bool MeshGrobPicker::set_transforms(
+        const GLdouble* modelview,
+        const GLdouble* project,
+        const GLint* viewport
+    ) {
+        if(
+            modelview == nullptr || project == nullptr ||
+            viewport == nullptr || viewport[2] <= 0 || viewport[3] <= 0
+        ) {
+            return false;
+        }
+        for(index_t i=0; i<16; ++i) {
+            modelview_[i] = modelview[i];
+            project_[i] = project[i];
+        }
+        for(index_t i=0; i<4; ++i) {
+            viewport_[i] = viewport[i];
+        }
+        // OpenGL matrices are stored by columns
+        mat4 MV;
+        mat4 P;
+        for(index_t i=0; i<4; ++i) {
+            for(index_t j=0; j<4; ++j) {
+                MV(i,j) = modelview_[4*j+i];
+                P(i,j) = project_[4*j+i];
+            }
+        }
+        project_modelview_ = P * MV;
+        return true;
+    }
+
+    const MeshElementsBVH* MeshGrobPicker::bvh(MeshElementsFlags what) {
+        index_t i = element_type_index(what);
+        if(i == NO_INDEX) {
+            return nullptr;
+        }
+        if(bvh_[i] == nullptr || bvh_timestamp_[i] != grob_->timestamp()) {
+            Stopwatch W("Picking BVH", false);
+            delete bvh_[i];
+            bvh_[i] = new MeshElementsBVH(*grob_, what);
+            bvh_timestamp_[i] = grob_->timestamp();
+            Logger::out("Picking")
+                << "Created BVH for " << filter_property_name(what)
+                << " in " << W.elapsed_time() << " s"
+                << std::endl;
+        }
+        return bvh_[i];
+    }
+
+    vec2 MeshGrobPicker::ndc_to_window(const vec2& p_ndc) const {
+        return vec2(
+            double(viewport_[0]) + 0.5 * (p_ndc.x + 1.0) * double(viewport_[2]),
+            double(viewport_[1]) + 0.5 * (p_ndc.y + 1.0) * double(viewport_[3])
+        );
+    }
+
+    bool MeshGrobPicker::project(const vec3& p, vec3& q) const {
+        vec4 c = project_modelview_ * vec4(p.x, p.y, p.z, 1.0);
+        if(c.w <= 0.0) {
+            return false;
+        }
+        double s = 1.0 / c.w;
+        q.x = double(viewport_[0]) + 0.5 * (c.x*s + 1.0) * double(viewport_[2]);
+        q.y = double(viewport_[1]) + 0.5 * (c.y*s + 1.0) * double(viewport_[3]);
+        q.z = 0.5 * (c.z*s + 1.0);
+        return true;
+    }
+
+    vec3 MeshGrobPicker::unproject(const vec2& p_ndc, double depth) const {
+        vec2 w = ndc_to_window(p_ndc);
+        vec3 result;
+        glupUnProject(
+            w.x, w.y, depth,
+            modelview_, project_, viewport_,
+            &result.x, &result.y, &result.z
+        );
+        return result;
+    }
+
+    index_t MeshGrobPicker::pick(
+        const vec2& p_ndc, MeshElementsFlags what, Object* shader
+    ) {
+        index_t result = NO_INDEX;
+        picked_depth_ = 1.0;
+        picked_point_ = unproject(p_ndc, 1.0);
+
+        if(grob_->vertices.dimension() < 3) {
+            return NO_INDEX;
+        }
+
+        const MeshElementsBVH* tree = bvh(what);
+        if(tree == nullptr) {
+            return NO_INDEX;
+        }
+
+        // Take into account filtered elements, as in GPU picking.
+        Attribute<Numeric::uint8> filter;
+        if(shader != nullptr) {
+            std::string prop;
+            // Test has_property() first, get_property() complains
+            // about missing properties.
+            if(
+                shader->has_property(filter_property_name(what)) &&
+                shader->get_property(filter_property_name(what), prop) &&
+                prop == "true"
+            ) {
+                MeshSubElementsStore& elements =
+                    grob_->get_subelements_by_type(what);
+                filter.bind_if_is_defined(elements.attributes(), "filter");
+            }
+        }
+
+        const Mesh& M = *grob_;
+        vec2 p = ndc_to_window(p_ndc);
+        double tol =
+            (what == MESH_VERTICES || what == MESH_EDGES) ?
+            PICK_TOLERANCE : 0.0 ;
+        double best_depth = Numeric::max_float64();
+
+        auto point = [&](index_t v)->vec3 {
+            return vec3(M.vertices.point_ptr(v));
+        };
+
+        // Tests whether the picked pixel is in the projected bounding box,
+        // and whether the bounding box can contain a nearer element.
+        auto visit_node = [&](const Box3d& B)->bool {
+            double xmin = Numeric::max_float64();
+            double ymin = Numeric::max_float64();
+            double zmin = Numeric::max_float64();
+            double xmax = -Numeric::max_float64();
+            double ymax = -Numeric::max_float64();
+            for(index_t i=0; i<8; ++i) {
+                vec3 c(
+                    (i & 1) ? B.xyz_max[0] : B.xyz_min[0],
+                    (i & 2) ? B.xyz_max[1] : B.xyz_min[1],
+                    (i & 4) ? B.xyz_max[2] : B.xyz_min[2]
+                );
+                vec3 q;
+                if(!project(c,q)) {
+                    // Box crosses the eye plane, cannot be culled.
+                    return true;
+                }
+                xmin = std::min(xmin, q.x);
+                ymin = std::min(ymin, q.y);
+                zmin = std::min(zmin, q.z);
+                xmax = std::max(xmax, q.x);
+                ymax = std::max(ymax, q.y);
+            }
+            return
+                p.x >= xmin - tol && p.x <= xmax + tol &&
+                p.y >= ymin - tol && p.y <= ymax + tol &&
+                zmin < best_depth ;
+        };
+
+        auto candidate = [&](index_t e, double depth) {
+            if(depth >= 0.0 && depth < best_depth) {
+                best_depth = depth;
+                result = e;
+            }
+        };
+
+        // Tests a polygon, decomposed into a triangle fan.
+        auto visit_polygon = [&](index_t e, const index_t* V, index_t n) {
+            vec3 q0, q1, q2;
+            if(!project(point(V[0]), q0) || !project(point(V[1]), q1)) {
+                return;
+            }
+            for(index_t lv=2; lv<n; ++lv) {
+                if(!project(point(V[lv]), q2)) {
+                    return;
+                }
+                double depth;
+                if(point_in_triangle_2d(p, q0, q1, q2, depth)) {
+                    candidate(e, depth);
+                }
+                q1 = q2;
+            }
+        };
+
+        auto visit_element = [&](index_t e) {
+            if(filter.is_bound() && filter[e] == 0) {
+                return;
+            }
+            switch(what) {
+            case MESH_VERTICES: {
+                vec3 q;
+                if(project(point(e), q)) {
+                    double dx = q.x - p.x;
+                    double dy = q.y - p.y;
+                    if(dx*dx + dy*dy <= tol*tol) {
+                        candidate(e, q.z);
+                    }
+                }
+            } break;
+            case MESH_EDGES: {
+                vec3 q1,q2;
+                if(
+                    project(point(M.edges.vertex(e,0)), q1) &&
+                    project(point(M.edges.vertex(e,1)), q2)
+                ) {
+                    vec2 d(q2.x - q1.x, q2.y - q1.y);
+                    vec2 w(p.x - q1.x, p.y - q1.y);
+                    double l2 = dot(d,d);
+                    double s = (l2 > 0.0) ? dot(w,d) / l2 : 0.0;
+                    s = std::max(0.0, std::min(1.0, s));
+                    vec2 r = w - s*d;
+                    if(dot(r,r) <= tol*tol) {
+                        candidate(e, q1.z + s*(q2.z - q1.z));
+                    }
+                }
+            } break;
+            case MESH_FACETS: {
+                index_t V[64];
+                index_t n = std::min(M.facets.nb_vertices(e), index_t(64));
+                for(index_t lv=0; lv<n; ++lv) {
+                    V[lv] = M.facets.vertex(e,lv);
+                }
+                visit_polygon(e, V, n);
+            } break;
+            case MESH_CELLS: {
+                index_t V[64];
+                for(index_t lf=0; lf<M.cells.nb_facets(e); ++lf) {
+                    index_t n = std::min(
+                        M.cells.facet_nb_vertices(e,lf), index_t(64)
+                    );
+                    for(index_t lv=0; lv<n; ++lv) {
+                        V[lv] = M.cells.facet_vertex(e,lf,lv);
+                    }
+                    visit_polygon(e, V, n);
+                }
+            } break;
+            default:
+                break;
+            }
+        };
+
+        tree->traverse(visit_node, visit_element);
+
+        if(result != NO_INDEX) {
+            picked_depth_ = best_depth;
+            picked_point_ = unproject(p_ndc, best_depth);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,186 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ *
+ * As an exception to the GPL, Graphite can be linked with the following
+ *  (non-GPL) libraries: Qt, SuperLU, WildMagic and CGAL
+ */
+
+
+
+#ifndef H_OGF_MESH_GFX_TOOLS_MESH_GROB_PICKER_H
+#define H_OGF_MESH_GFX_TOOLS_MESH_GROB_PICKER_H
+
+#include <OGF/mesh_gfx/common/common.h>
+#include <OGF/mesh/grob/mesh_grob.h>
+#include <geogram_gfx/GLUP/GLUP.h>
+
+/**
+ * \file OGF/mesh_gfx/tools/mesh_grob_picker.h
+ * \brief Picking of mesh elements on the CPU.
+ */
+
+namespace OGF {
+
+    class MeshElementsBVH;
+
+    /**
+     * \brief Picks the elements of a MeshGrob without rendering.
+     * \details Elements are found by traversing a bounding volume
+     *  hierarchy of the elements in screen space, using the viewing
+     *  transforms of the latest frame. The hierarchies are created
+     *  on demand and rebuilt when the timestamp of the MeshGrob
+     *  changes. This avoids the rendering of a picking frame and the
+     *  GPU read-back for each mouse event, and also works without an
+     *  OpenGL context once the transforms are known.
+     */
+    class MESH_GFX_API MeshGrobPicker {
+    public:
+        /**
+         * \brief MeshGrobPicker constructor.
+         * \param[in] grob a pointer to the MeshGrob
+         */
+        MeshGrobPicker(MeshGrob* grob);
+
+        /**
+         * \brief MeshGrobPicker destructor.
+         */
+        ~MeshGrobPicker();
+
+        /**
+         * \brief Forbids copy.
+         */
+        MeshGrobPicker(const MeshGrobPicker& rhs) = delete;
+
+        /**
+         * \brief Forbids copy.
+         */
+        MeshGrobPicker& operator=(const MeshGrobPicker& rhs) = delete;
+
+        /**
+         * \brief Sets the viewing transforms.
+         * \param[in] modelview the modelview matrix, in OpenGL order
+         * \param[in] project the projection matrix, in OpenGL order
+         * \param[in] viewport the viewport
+         * \retval true if the transforms are valid
+         * \retval false otherwise (for instance, if no frame was
+         *  rendered yet)
+         */
+        bool set_transforms(
+            const GLdouble* modelview,
+            const GLdouble* project,
+            const GLint* viewport
+        );
+
+        /**
+         * \brief Picks an element.
+         * \param[in] p_ndc the picked point, in normalized device
+         *  coordinates
+         * \param[in] what one of MESH_VERTICES, MESH_EDGES, MESH_FACETS,
+         *  MESH_CELLS
+         * \param[in] shader if non-null, the "xxx_filter" properties of
+         *  the shader are taken into account, as in GPU picking
+         * \return the index of the nearest element under \p p_ndc, or
+         *  NO_INDEX if there is no such element
+         */
+        index_t pick(
+            const vec2& p_ndc, MeshElementsFlags what, Object* shader
+        );
+
+        /**
+         * \brief Gets the picked point.
+         * \return the picked point, in object coordinates, or the point
+         *  on the far plane if no element was picked.
+         */
+        const vec3& picked_point() const {
+            return picked_point_;
+        }
+
+        /**
+         * \brief Gets the depth of the picked point.
+         * \return the depth of the picked point in window coordinates,
+         *  in [0,1], as in the depth buffer.
+         */
+        double picked_depth() const {
+            return picked_depth_;
+        }
+
+        /**
+         * \brief Transforms a point from window to object coordinates.
+         * \param[in] p_ndc the point, in normalized device coordinates
+         * \param[in] depth the depth, in window coordinates
+         * \return the point, in object coordinates
+         */
+        vec3 unproject(const vec2& p_ndc, double depth) const;
+
+    protected:
+        /**
+         * \brief Gets the bounding volume hierarchy of a given element
+         *  type, and creates or updates it if needed.
+         * \param[in] what one of MESH_VERTICES, MESH_EDGES, MESH_FACETS,
+         *  MESH_CELLS
+         */
+        const MeshElementsBVH* bvh(MeshElementsFlags what);
+
+        /**
+         * \brief Transforms a point from object to window coordinates.
+         * \param[in] p the point, in object coordinates
+         * \param[out] q the point, in window coordinates
+         * \retval true if the point is in front of the eye
+         * \retval false otherwise
+         */
+        bool project(const vec3& p, vec3& q) const;
+
+        /**
+         * \brief Converts normalized device coordinates into window
+         *  coordinates.
+         * \param[in] p_ndc the point in normalized device coordinates
+         * \return the point in window coordinates
+         */
+        vec2 ndc_to_window(const vec2& p_ndc) const;
+
+    private:
+        MeshGrob* grob_;
+        MeshElementsBVH* bvh_[4];
+        index_t bvh_timestamp_[4];
+
+        GLdouble modelview_[16];
+        GLdouble project_[16];
+        GLint viewport_[4];
+        mat4 project_modelview_;
+
+        vec3 picked_point_;
+        double picked_depth_;
+    };
+}
+
+#endif
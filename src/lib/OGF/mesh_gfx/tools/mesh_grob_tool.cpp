@@ -39,6 +39,7 @@
 
 #include <OGF/mesh_gfx/tools/mesh_grob_tool.h>
 #include <OGF/mesh_gfx/shaders/mesh_grob_shader.h>
+#include <OGF/mesh_gfx/tools/mesh_grob_picker.h>
 #include <OGF/renderer/context/rendering_context.h>
 
 #include <geogram/image/image_library.h>
@@ -134,7 +135,7 @@ namespace OGF {
         //   Step 2: find among all edges of the facet the one that
         // is nearest to the picked point.
 
-        vec3 picked_point = rendering_context()->picked_point();
+        vec3 picked_point = picked_point_;
         double best_distance = Numeric::max_float64();
         for(index_t c1: mesh_grob()->facets.corners(facet)) {
             index_t c2 = mesh_grob()->facets.next_corner_around_facet(facet,c1);
@@ -168,6 +169,29 @@ namespace OGF {
             return NO_INDEX;
         }
 
+        // CPU picking, using the current viewport of the rendering
+        // context and the modelview and projection of the latest drawing
+        // of the object (falls back to GPU picking if the object
+        // was not drawn yet).
+        if(image == nullptr && CmdLine::get_arg_bool("gui:cpu_picking")) {
+            MeshGrobPicker* picker = shd->cpu_picker();
+            GLint viewport[4];
+            rendering_context()->get_viewport(viewport);
+            if(
+                picker->set_transforms(
+                    shd->latest_modelview(),
+                    shd->latest_project(),
+                    viewport
+                )
+            ) {
+                index_t result = picker->pick(rp.p_ndc, what, shd);
+                picked_ndc_ = rp.p_ndc;
+                picked_point_ = picker->picked_point();
+                picked_depth_ = picker->picked_depth();
+                return result;
+            }
+        }
+
         rendering_context()->begin_picking(rp.p_ndc);
         rendering_context()->begin_frame();
 
@@ -203,9 +227,27 @@ namespace OGF {
 
     vec3 MeshGrobTool::drag_point(const RayPick& rp) const {
 
-        //   TODO: it's a bit stupid, we could do that without
-        // going through begin_frame() / end_frame() by caching
-        // the current viewport and modelview transforms...
+        // With CPU picking, unproject using the current viewport and
+        // the transforms cached by the shader.
+        if(CmdLine::get_arg_bool("gui:cpu_picking")) {
+            MeshGrobShader* shd = dynamic_cast<MeshGrobShader*>(
+                mesh_grob()->get_shader()
+            );
+            if(shd != nullptr) {
+                MeshGrobPicker* picker = shd->cpu_picker();
+                GLint viewport[4];
+                rendering_context()->get_viewport(viewport);
+                if(
+                    picker->set_transforms(
+                        shd->latest_modelview(),
+                        shd->latest_project(),
+                        viewport
+                    )
+                ) {
+                    return picker->unproject(rp.p_ndc, picked_depth_);
+                }
+            }
+        }
 
         vec2 dragged_ndc = rp.p_ndc;
         rendering_context()->begin_picking(dragged_ndc);
@@ -530,6 +530,20 @@ namespace OGF {
 	    return center_y_;
 	}
 
+        /**
+         * \brief Gets the viewport transform.
+         * \details This reads the stored viewport parameters, and does
+         *  not need a current OpenGL context.
+         * \param[out] viewport the x, y, width and height of the
+         *  viewport, in the same order as glGetIntegerv(GL_VIEWPORT)
+         */
+        void get_viewport(GLint viewport[4]) const {
+            viewport[0] = GLint(viewport_x_);
+            viewport[1] = GLint(viewport_y_);
+            viewport[2] = GLint(viewport_width_);
+            viewport[3] = GLint(viewport_height_);
+        }
+
         /**
          * \brief Transforms screen coordinates to normalized
          *  device coordinates (viewport transform).
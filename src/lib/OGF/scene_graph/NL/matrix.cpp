@@ -41,6 +41,11 @@
 #include <geogram/NL/nl_iterative_solvers.h>
 #include <geogram/NL/nl_preconditioners.h>
 #include <geogram/basic/logger.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/algorithm.h>
+#include <geogram/basic/stopwatch.h>
+
+#include <cstdlib>
 
 namespace {
     using namespace OGF;
@@ -112,6 +117,128 @@ namespace {
 	return true;
     }
 
+    /**
+     * \brief A pending coefficient, as stored in Matrix::pending_
+     *  (GEO::vector<Triplet>).
+     */
+    typedef std::pair<Numeric::uint64, double> Triplet;
+
+    /**
+     * \brief Packs a (row,column) pair into a sort key.
+     */
+    inline Numeric::uint64 triplet_key(index_t i, index_t j) {
+	return (Numeric::uint64(i) << 32) | Numeric::uint64(j);
+    }
+
+    inline index_t triplet_row(const Triplet& T) {
+	return index_t(T.first >> 32);
+    }
+
+    inline index_t triplet_col(const Triplet& T) {
+	return index_t(T.first & 0xffffffffu);
+    }
+
+    /**
+     * \brief Sorts a set of triplets and merges the duplicates.
+     * \param[in] m number of rows
+     * \param[in,out] triplets the triplets. On exit, they are sorted
+     *  by row then column, and there is no duplicate (i,j) pair.
+     * \param[out] rowptr of size m+1, on exit the triplets of row i
+     *  are in [rowptr[i], rowptr[i+1])
+     */
+    void sort_and_merge_triplets(
+	index_t m, vector<Triplet>& triplets, vector<size_t>& rowptr
+    ) {
+	GEO::sort(
+	    triplets.begin(), triplets.end(),
+	    [](const Triplet& T1, const Triplet& T2)->bool {
+		return T1.first < T2.first;
+	    }
+	);
+
+	// Beginning of each row in the sorted (unmerged) triplets
+	vector<size_t> row_begin(m+1);
+	parallel_for_slice(
+	    0, m+1,
+	    [&](index_t from, index_t to) {
+		for(index_t i=from; i<to; ++i) {
+		    row_begin[i] = size_t(
+			std::lower_bound(
+			    triplets.begin(), triplets.end(),
+			    Triplet(triplet_key(i,0),0.0),
+			    [](const Triplet& T1, const Triplet& T2)->bool {
+				return T1.first < T2.first;
+			    }
+			) - triplets.begin()
+		    );
+		}
+	    }
+	);
+
+	// Number of merged coefficients in each row
+	rowptr.assign(m+1,0);
+	parallel_for_slice(
+	    0, m,
+	    [&](index_t from, index_t to) {
+		for(index_t i=from; i<to; ++i) {
+		    size_t nb = 0;
+		    for(size_t k=row_begin[i]; k<row_begin[i+1]; ++k) {
+			if(
+			    k == row_begin[i] ||
+			    triplets[k].first != triplets[k-1].first
+			) {
+			    ++nb;
+			}
+		    }
+		    rowptr[i+1] = nb;
+		}
+	    }
+	);
+	for(index_t i=0; i<m; ++i) {
+	    rowptr[i+1] += rowptr[i];
+	}
+
+	// Merge duplicates
+	vector<Triplet> merged(rowptr[m]);
+	parallel_for_slice(
+	    0, m,
+	    [&](index_t from, index_t to) {
+		for(index_t i=from; i<to; ++i) {
+		    size_t cur = rowptr[i];
+		    for(size_t k=row_begin[i]; k<row_begin[i+1]; ++k) {
+			if(
+			    k == row_begin[i] ||
+			    triplets[k].first != triplets[k-1].first
+			) {
+			    merged[cur] = triplets[k];
+			    ++cur;
+			} else {
+			    merged[cur-1].second += triplets[k].second;
+			}
+		    }
+		}
+	    }
+	);
+	triplets.swap(merged);
+    }
+
+    /**
+     * \brief Displays assembly statistics for large matrices.
+     */
+    void show_assembly_statistics(
+	const char* method, size_t nb_triplets, size_t nnz, double time
+    ) {
+	if(nb_triplets < 100000) {
+	    return;
+	}
+	Logger::out("NL")
+	    << "Matrix::" << method << "() assembled "
+	    << nb_triplets << " triplets into "
+	    << nnz << " coefficients in " << time << " s ("
+	    << (time > 0.0 ? double(nb_triplets) / (time * 1e6) : 0.0)
+	    << " M triplets/s)"
+	    << std::endl;
+    }
 }
 
 namespace OGF {
@@ -167,6 +294,12 @@ namespace OGF {
 	void Matrix::add_coefficients(
 	    const Vector* I, const Vector* J, const Vector* A, bool ignore_OOB
 	) {
+	    if(impl_->type != NL_MATRIX_SPARSE_DYNAMIC) {
+		Logger::err("NL")
+		    << "Matrix::add_coefficients() called on wrong matrix type"
+		    << std::endl;
+		return;
+	    }
 	    if(
 		I->get_element_meta_type()!=ogf_meta<Numeric::uint32>::type() &&
 		I->get_element_meta_type()!=ogf_meta<Numeric::int32>::type()
@@ -225,42 +358,35 @@ namespace OGF {
 	    const index_t* p_j = reinterpret_cast<index_t*>(J->data());
 	    const double*  p_a = A->data_double();
 
-	    if(ignore_OOB) {
-		for(index_t k=0; k<I->nb_elements(); ++k) {
-		    if(
-			p_i[k] >= index_t(impl_->m) ||
-			p_j[k] >= index_t(impl_->n)
-		    ) {
+	    vector<Triplet> batch;
+	    batch.reserve(I->nb_elements());
+	    for(index_t k=0; k<I->nb_elements(); ++k) {
+		if(
+		    p_i[k] >= index_t(impl_->m) ||
+		    p_j[k] >= index_t(impl_->n)
+		) {
+		    if(ignore_OOB) {
 			continue;
 		    }
-		    nlSparseMatrixAdd(
-			(NLSparseMatrix*)(impl_), p_i[k], p_j[k], p_a[k]
-		    );
-		}
-	    } else {
-		for(index_t k=0; k<I->nb_elements(); ++k) {
-		    if(
-			p_i[k] >= index_t(impl_->m) ||
-			p_j[k] >= index_t(impl_->n)
-		    ) {
-			Logger::err("NL")
-			    << "Matrix(" << impl_->m << "," << impl_->n
-			    << ")::add_coefficients()"
-			    << " coefficient larger than matrix size"
-			    << std::endl;
-			return;
-		    }
-		}
-
-		for(index_t k=0; k<I->nb_elements(); ++k) {
-		    nlSparseMatrixAdd(
-			(NLSparseMatrix*)(impl_), p_i[k], p_j[k], p_a[k]
-		    );
+		    Logger::err("NL")
+			<< "Matrix(" << impl_->m << "," << impl_->n
+			<< ")::add_coefficients()"
+			<< " coefficient larger than matrix size"
+			<< std::endl;
+		    return;
 		}
+		batch.push_back(Triplet(triplet_key(p_i[k],p_j[k]), p_a[k]));
 	    }
+	    add_pending_coefficients(batch);
 	}
 
 	void Matrix::add_coefficients_to_diagonal(const Vector* A) {
+	    if(impl_->type != NL_MATRIX_SPARSE_DYNAMIC) {
+		Logger::err("NL")
+		    << "Matrix::add_coefficients_to_diagonal() called on wrong matrix type"
+		    << std::endl;
+		return;
+	    }
 	    if(A->get_element_meta_type()!=ogf_meta<double>::type()) {
 		Logger::err("NL")
 		    << "Matrix(" << impl_->m << "," << impl_->n
@@ -286,14 +412,108 @@ namespace OGF {
 		return;
 	    }
 	    const double* p_a = A->data_double();
+	    vector<Triplet> batch(A->nb_elements());
 	    for(index_t k=0; k<A->nb_elements(); ++k) {
-		nlSparseMatrixAdd(
-		    (NLSparseMatrix*)(impl_), k, k, p_a[k]
+		batch[k] = Triplet(triplet_key(k,k), p_a[k]);
+	    }
+	    add_pending_coefficients(batch);
+	}
+
+	void Matrix::add_pending_coefficients(const vector<Triplet>& batch) {
+	    std::lock_guard<std::mutex> lock(pending_lock_);
+	    pending_.insert(pending_.end(), batch.begin(), batch.end());
+	}
+
+	void Matrix::flush_pending_coefficients() const {
+	    std::lock_guard<std::mutex> lock(pending_lock_);
+	    if(pending_.empty()) {
+		return;
+	    }
+	    Stopwatch W("NL assembly", false);
+	    size_t nb_triplets = pending_.size();
+	    vector<size_t> rowptr;
+	    sort_and_merge_triplets(get_m(), pending_, rowptr);
+	    NLSparseMatrix* M = (NLSparseMatrix*)(impl_);
+	    // Rows are independent, and the matrix only stores rows,
+	    // thus rows can be filled concurrently.
+	    parallel_for_slice(
+		0, get_m(),
+		[&](index_t from, index_t to) {
+		    for(index_t i=from; i<to; ++i) {
+			for(size_t k=rowptr[i]; k<rowptr[i+1]; ++k) {
+			    nlSparseMatrixAdd(
+				M, i, triplet_col(pending_[k]),
+				pending_[k].second
+			    );
+			}
+		    }
+		}
+	    );
+	    show_assembly_statistics(
+		"flush", nb_triplets, pending_.size(), W.elapsed_time()
+	    );
+	    pending_.clear();
+	    pending_.shrink_to_fit();
+	}
+
+	void Matrix::compress_pending_coefficients() {
+	    std::lock_guard<std::mutex> lock(pending_lock_);
+	    Stopwatch W("NL assembly", false);
+	    size_t nb_triplets = pending_.size();
+	    index_t m = get_m();
+	    vector<size_t> rowptr;
+	    sort_and_merge_triplets(m, pending_, rowptr);
+
+	    size_t nnz = pending_.size();
+	    NLuint nslices = NLuint(
+		std::max(Process::maximum_concurrent_threads(), index_t(1))
+	    );
+	    NLCRSMatrix* CRS = (NLCRSMatrix*)(calloc(1,sizeof(NLCRSMatrix)));
+	    nlCRSMatrixConstruct(CRS, m, get_n(), nnz, nslices);
+
+	    for(index_t i=0; i<=m; ++i) {
+		CRS->rowptr[i] = rowptr[i];
+	    }
+	    parallel_for_slice(
+		0, m,
+		[&](index_t from, index_t to) {
+		    for(index_t i=from; i<to; ++i) {
+			for(size_t k=rowptr[i]; k<rowptr[i+1]; ++k) {
+			    CRS->colind[k] = triplet_col(pending_[k]);
+			    CRS->val[k] = pending_[k].second;
+			}
+		    }
+		}
+	    );
+
+	    // Slices with approximately the same number of coefficients,
+	    // used by the parallel matrix vector product.
+	    CRS->sliceptr[0] = 0;
+	    for(NLuint s=1; s<nslices; ++s) {
+		size_t bound = (nnz / nslices) * s;
+		CRS->sliceptr[s] = NLuint(
+		    std::lower_bound(rowptr.begin(), rowptr.end(), bound) -
+		    rowptr.begin()
+		);
+		CRS->sliceptr[s] = std::min(CRS->sliceptr[s], NLuint(m));
+		CRS->sliceptr[s] = std::max(
+		    CRS->sliceptr[s], CRS->sliceptr[s-1]
 		);
 	    }
+	    CRS->sliceptr[nslices] = m;
+
+	    nlDeleteMatrix(impl_);
+	    impl_ = (NLMatrix)(CRS);
+
+	    show_assembly_statistics(
+		"compress", nb_triplets, nnz, W.elapsed_time()
+	    );
+	    pending_.clear();
+	    pending_.shrink_to_fit();
 	}
 
 	void Matrix::mult(const Vector* x, Vector* y) const {
+	    flush_pending_coefficients();
 	    if(!check_vector(this, x, false, true, "mult", "x")) {
 		return;
 	    }
@@ -306,10 +526,18 @@ namespace OGF {
 	}
 
 	void Matrix::compress() {
+	    if(impl_->type == NL_MATRIX_SPARSE_DYNAMIC && !pending_.empty()) {
+		if(nlSparseMatrixNNZ((NLSparseMatrix*)(impl_)) == 0) {
+		    compress_pending_coefficients();
+		    return;
+		}
+		flush_pending_coefficients();
+	    }
 	    nlMatrixCompress(&impl_);
 	}
 
 	Matrix* Matrix::factorize(Factorization factorization) const {
+	    flush_pending_coefficients();
 	    NLMatrix result = nullptr;
 	    if(init_direct_solver(factorization)) {
 		switch(factorization) {
@@ -356,6 +584,8 @@ namespace OGF {
 		return;
 	    }
 
+	    flush_pending_coefficients();
+
 	    NLMatrix P = nullptr;
 	    switch(precond) {
 		case None: {
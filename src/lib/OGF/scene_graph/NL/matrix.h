@@ -39,6 +39,9 @@
 
 #include <OGF/scene_graph/common/common.h>
 #include <OGF/gom/types/object.h>
+#include <geogram/basic/memory.h>
+
+#include <mutex>
 
 struct NLMatrixStruct;
 typedef NLMatrixStruct* NLMatrix;
@@ -121,6 +124,11 @@ namespace OGF {
 	     * \brief Adds a vector of coefficient.
 	     * \details If the coefficient already exists, or if there
 	     *  are duplicated entries, a is added to its previous value.
+	     *  The (I,J,A) triplets are not inserted one by one: they are
+	     *  stored, then sorted and merged in parallel when the matrix
+	     *  is compressed (or used). If the matrix was only filled with
+	     *  add_coefficients(), compress() directly generates the CRS
+	     *  format. Several threads can add batches concurrently.
 	     * \param[in] I vector of row indices, should be integers
 	     * \param[in] J vector of column indices, should be integers
 	     * \param[in] A vector of values to be added, should be doubles
@@ -229,8 +237,36 @@ namespace OGF {
 	    Matrix(NLMatrix impl) : impl_(impl) {
 	    }
 
+	    /**
+	     * \brief Inserts the triplets accumulated by add_coefficients()
+	     *  into the dynamic matrix.
+	     * \details Does nothing if there is no pending triplet. The
+	     *  triplets are sorted and merged, then rows are filled in
+	     *  parallel.
+	     */
+	    void flush_pending_coefficients() const;
+
+	    /**
+	     * \brief Creates a CRS matrix directly from the triplets
+	     *  accumulated by add_coefficients().
+	     * \details The dynamic matrix should be empty.
+	     */
+	    void compress_pending_coefficients();
+
+	    /**
+	     * \brief Appends a batch of triplets to the pending ones.
+	     * \param[in] batch the triplets, with the row index in the
+	     *  32 most significant bits of the key and the column index
+	     *  in the 32 least significant bits.
+	     */
+	    void add_pending_coefficients(
+		const GEO::vector< std::pair<Numeric::uint64,double> >& batch
+	    );
+
 	  private:
 	    NLMatrix impl_;
+	    mutable GEO::vector< std::pair<Numeric::uint64,double> > pending_;
+	    mutable std::mutex pending_lock_;
 	};
 
     }
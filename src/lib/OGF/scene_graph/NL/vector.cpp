@@ -38,14 +38,14 @@
 #include <OGF/scene_graph/grob/grob.h>
 #include <OGF/gom/reflection/meta.h>
 
+#include <algorithm>
+
 namespace OGF {
 
     namespace NL {
 
 	/**********************************************************/
 
-	// TODO: function to copy other vector
-
 	Vector::Vector(
 	    index_t size, index_t dimension, MetaType* element_meta_type
 	) {
@@ -64,6 +64,8 @@ namespace OGF {
 	    }
 	    grob_ = nullptr;
 	    attribute_store_ = nullptr;
+	    nb_edits_ = 0;
+	    edit_modified_ = false;
 	}
 
 	Vector::Vector(Grob* grob, AttributeStore* attribute_store) {
@@ -89,6 +91,8 @@ namespace OGF {
 	    geo_assert(element_meta_type_ != nullptr);
 	    element_size_ = element_meta_type_->life_cycle()->object_size();
 	    base_addr_ = nullptr;
+	    nb_edits_ = 0;
+	    edit_modified_ = false;
 	    register_me(attribute_store_);
 	}
 
@@ -105,6 +109,8 @@ namespace OGF {
 	    base_addr_ = Memory::pointer(data);
 	    element_meta_type_ = element_meta_type;
 	    element_size_ = element_meta_type_->life_cycle()->object_size();
+	    nb_edits_ = 0;
+	    edit_modified_ = false;
 	}
 
 	Vector::~Vector() {
@@ -185,20 +191,144 @@ namespace OGF {
 	    );
 	}
 
-	void Vector::set_element(index_t index, const Any& value) {
+	bool Vector::check_writable() const {
 	    if(read_only_) {
 		Logger::err("GOM") << "Vector is read-only" << std::endl;
+		return false;
+	    }
+	    return true;
+	}
+
+	void Vector::notify_grob() {
+	    // If this vector is an attribute of an object, mark this object
+	    // as dirty for graphics update.
+	    if(grob_ == nullptr) {
 		return;
 	    }
-	    if(!check_index(index)) {
+	    if(nb_edits_ != 0) {
+		edit_modified_ = true;
+	    } else {
+		grob_->update();
+	    }
+	}
+
+	void Vector::begin_edit() {
+	    ++nb_edits_;
+	}
+
+	void Vector::end_edit() {
+	    if(nb_edits_ == 0) {
+		Logger::err("NL::Vector") << "end_edit() without begin_edit()"
+					  << std::endl;
+		return;
+	    }
+	    --nb_edits_;
+	    if(nb_edits_ == 0 && edit_modified_) {
+		edit_modified_ = false;
+		notify_grob();
+	    }
+	}
+
+	void Vector::set_element(index_t index, const Any& value) {
+	    if(!check_writable() || !check_index(index)) {
 		return;
 	    }
 	    value.copy_to(base_addr_ + index*element_size_, element_meta_type_);
-	    // If this vector is an attribute of an object, mark this object
-	    // as dirty for graphics update.
-	    if(grob_ != nullptr) {
-		grob_->update();
+	    notify_grob();
+	}
+
+	bool Vector::get_elements_data(
+	    Memory::pointer& data, MetaType*& element_meta_type,
+	    bool& read_only
+	) {
+	    data = base_addr_;
+	    element_meta_type = element_meta_type_;
+	    read_only = read_only_;
+	    return true;
+	}
+
+	void Vector::notify_elements_modified() {
+	    notify_grob();
+	}
+
+	void Vector::set_range(index_t from, index_t to, double value) {
+	    Any any;
+	    any.set_value(value);
+	    set_range_value(from, to, any);
+	}
+
+	void Vector::set_range_value(
+	    index_t from, index_t to, const Any& value
+	) {
+	    if(!check_writable()) {
+		return;
+	    }
+	    if(from > to || to > nb_elements()) {
+		Logger::err("NL::Vector") << "[" << from << "," << to << ")"
+					  << " invalid range" << std::endl;
+		return;
+	    }
+	    if(from == to) {
+		return;
+	    }
+	    Memory::pointer first = base_addr_ + from*element_size_;
+	    if(!value.copy_to(first, element_meta_type_)) {
+		Logger::err("NL::Vector") << "Could not convert value to "
+					  << element_meta_type_->name()
+					  << std::endl;
+		return;
+	    }
+	    LifeCycle* life_cycle = element_meta_type_->life_cycle();
+	    if(life_cycle->is_pod()) {
+		// Doubling copies: [first,first+n) -> [first+n,first+2n)
+		size_t nb_bytes = size_t(to - from) * element_size_;
+		size_t copied = element_size_;
+		while(copied < nb_bytes) {
+		    size_t n = std::min(copied, nb_bytes - copied);
+		    Memory::copy(first + copied, first, n);
+		    copied += n;
+		}
+	    } else {
+		for(index_t i=from+1; i<to; ++i) {
+		    life_cycle->assign(base_addr_ + i*element_size_, first);
+		}
+	    }
+	    notify_grob();
+	}
+
+	void Vector::fill(double value) {
+	    set_range(0, nb_elements(), value);
+	}
+
+	void Vector::copy_from(Vector* rhs) {
+	    if(!check_writable()) {
+		return;
+	    }
+	    if(rhs == nullptr || rhs->nb_elements() != nb_elements()) {
+		Logger::err("NL::Vector") << "copy_from(): size mismatch"
+					  << std::endl;
+		return;
+	    }
+	    if(rhs == this || nb_elements() == 0) {
+		return;
+	    }
+	    if(
+		rhs->element_meta_type_ == element_meta_type_ &&
+		element_meta_type_->life_cycle()->is_pod()
+	    ) {
+		Memory::copy(
+		    base_addr_, rhs->base_addr_, nb_elements()*element_size_
+		);
+	    } else {
+		Any value;
+		for(index_t i=0; i<nb_elements(); ++i) {
+		    rhs->get_element(i, value);
+		    value.copy_to(
+			base_addr_ + i*element_size_, element_meta_type_
+		    );
+		}
 	    }
+	    notify_grob();
 	}
 
 	double* Vector::data_double() const {
@@ -109,6 +109,19 @@ namespace OGF {
 	     */
 	    void set_element(index_t i, const Any& value) override;
 
+	    /**
+	     * \copydoc Object::get_elements_data()
+	     */
+	    bool get_elements_data(
+		Memory::pointer& data, MetaType*& element_meta_type,
+		bool& read_only
+	    ) override;
+
+	    /**
+	     * \copydoc Object::notify_elements_modified()
+	     */
+	    void notify_elements_modified() override;
+
 	    /**
 	     * \brief Gets the data pointer.
 	     * \return a pointer to the first element. All elements are stored
@@ -188,8 +201,77 @@ namespace OGF {
 		MetaType* element_meta_type=nullptr
 	    );
 
+	    /**
+	     * \brief Starts a batch of modifications.
+	     * \details Until the matching end_edit(), modifications do not
+	     *  notify the Grob this Vector is attached to. Calls can be
+	     *  nested.
+	     * \see end_edit()
+	     */
+	    void begin_edit();
+
+	    /**
+	     * \brief Terminates a batch of modifications.
+	     * \details When the outermost batch terminates, the Grob this
+	     *  Vector is attached to is updated once if the Vector was
+	     *  modified.
+	     * \see begin_edit()
+	     */
+	    void end_edit();
+
+	    /**
+	     * \brief Sets a range of elements to the same value.
+	     * \details The value is converted once to the type of the
+	     *  elements, then copied.
+	     * \param[in] from index of the first element
+	     * \param[in] to one position past the index of the last element
+	     * \param[in] value the value
+	     */
+	    void set_range(index_t from, index_t to, double value);
+
+	    /**
+	     * \brief Sets all the elements to the same value.
+	     * \param[in] value the value
+	     */
+	    void fill(double value);
+
+	    /**
+	     * \brief Copies all the elements of another vector.
+	     * \details If both vectors have the same element type,
+	     *  memory is copied directly, else elements are converted
+	     *  one by one.
+	     * \param[in] rhs the vector to copy from, with the same number
+	     *  of elements as this vector.
+	     */
+	    void copy_from(Vector* rhs);
+
 	  protected:
 
+	    /**
+	     * \brief Tests whether this vector can be modified.
+	     * \details If it is read-only, displays an error message.
+	     * \retval true if this vector can be modified
+	     * \retval false otherwise
+	     */
+	    bool check_writable() const;
+
+	    /**
+	     * \brief Notifies the Grob this vector is attached to that
+	     *  it was modified.
+	     * \details Within begin_edit() / end_edit(), the notification
+	     *  is deferred to the outermost end_edit().
+	     */
+	    void notify_grob();
+
+	    /**
+	     * \brief Sets a range of elements to the same value.
+	     * \param[in] from index of the first element
+	     * \param[in] to one position past the index of the last element
+	     * \param[in] value the value, of any type that can be converted
+	     *  to the type of the elements
+	     */
+	    void set_range_value(index_t from, index_t to, const Any& value);
+
 	    /**
 	     * \brief Tests whether index i is valid.
 	     * \details If index is invalid, displays an error message.
@@ -205,6 +287,8 @@ namespace OGF {
 	    Grob* grob_;
 	    AttributeStore* attribute_store_;
 	    bool read_only_;
+	    index_t nb_edits_;
+	    bool edit_modified_;
 	};
 
 	/**********************************************************/
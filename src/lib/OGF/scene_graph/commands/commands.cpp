@@ -58,6 +58,9 @@ namespace OGF {
 
     void Interface::set_grob(Grob* grob) {
         grob_ = grob ;
+        if(grob_ != nullptr) {
+            grob_->materialize();
+        }
     }
 
     Grob* Interface::get_grob() const {
@@ -173,6 +173,20 @@ namespace OGF {
             const ArgList& args, Any& ret_val
         ) override;
 
+        /**
+         * \copydoc Object::invoke_method_positional
+         * \details Routed through invoke_method(), so that positional
+         *  calls also get timings and history recording.
+         */
+        bool invoke_method_positional(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        ) override {
+            return invoke_method_positional_by_name(
+                method, args, nb_args, ret_val
+            );
+        }
+
 	/**
 	 * \brief Gets the main Interpreter.
 	 * \return a pointer to the main Interpreter.
@@ -40,13 +40,40 @@
 #include <OGF/scene_graph/types/scene_graph.h>
 #include <OGF/scene_graph/types/scene_graph_library.h>
 #include <OGF/scene_graph/types/geofile.h>
+#include <OGF/scene_graph/grob/grob_snapshot.h>
 #include <OGF/scene_graph/commands/commands.h>
 #include <OGF/basic/math/geometry.h>
 #include <OGF/gom/reflection/meta_class.h>
 #include <OGF/gom/interpreter/interpreter.h>
 
 #include <geogram/basic/file_system.h>
+#include <geogram/basic/stopwatch.h>
 #include <sstream>
+#include <atomic>
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Tests whether a method accesses the data of a Grob.
+     * \details The methods declared by Grob and its base classes only
+     *  access the name, visibility, shader and transform, and can be
+     *  called on a lazy Grob (for instance by the GUI, at each frame).
+     *  The methods declared by subclasses may access the data.
+     * \param[in] member a pointer to the method, or nullptr
+     * \retval true if the method is declared by a subclass of Grob
+     * \retval false otherwise
+     */
+    bool accesses_data(const MetaMember* member) {
+        if(member == nullptr) {
+            return false;
+        }
+        MetaClass* grob_class = dynamic_cast<MetaClass*>(
+            ogf_meta<Grob>::type()
+        );
+        return !grob_class->is_subclass_of(member->container_meta_class());
+    }
+}
 
 namespace OGF {
 
@@ -64,6 +91,11 @@ namespace OGF {
         obj_to_world_.load_identity();
         dirty_ = false;
         nb_graphics_locks_ = 0;
+        timestamp_ = new_timestamp();
+        lazy_part_ = NO_INDEX;
+        materialize_requested_ = false;
+        bbox_cache_valid_ = false;
+        filtered_bbox_cache_valid_ = false;
     }
 
     Grob::Grob() {
@@ -79,6 +111,16 @@ namespace OGF {
         obj_to_world_.load_identity();
         dirty_ = false;
         nb_graphics_locks_ = 0;
+        timestamp_ = new_timestamp();
+        lazy_part_ = NO_INDEX;
+        materialize_requested_ = false;
+        bbox_cache_valid_ = false;
+        filtered_bbox_cache_valid_ = false;
+    }
+
+    index_t Grob::new_timestamp() {
+        static std::atomic<index_t> last_timestamp(0);
+        return ++last_timestamp;
     }
 
     Grob::~Grob() {
@@ -114,6 +156,7 @@ namespace OGF {
     }
 
     Grob* Grob::duplicate(SceneGraph* sg) {
+        materialize();
         Grob* result = sg->create_object(this->meta_class()->name());
         result->attributes() = attributes();
         return result;
@@ -155,6 +198,8 @@ namespace OGF {
 
     void Grob::update() {
         dirty_ = true;
+        timestamp_ = new_timestamp();
+        invalidate_bbox_cache();
         value_changed(this);
         scene_graph()->update();
     }
@@ -191,6 +236,84 @@ namespace OGF {
         return false;
     }
 
+    bool Grob::supports_concurrent_serialization() const {
+        return false;
+    }
+
+    bool Grob::materialize() {
+        if(!is_lazy()) {
+            return true;
+        }
+        // Reset before reading, so that functions called by
+        // serialize_read() do not materialize again.
+        std::string filename = lazy_filename_;
+        lazy_filename_.clear();
+        materialize_requested_ = false;
+
+        Stopwatch W("Lazy",false);
+        std::string part_filename =
+            GraphiteFileIndex::part_filename(filename, lazy_part_);
+        GraphiteFileIndex index;
+        bool result =
+            index.read(filename) &&
+            lazy_part_ < index.nb_parts() &&
+            index.extract_part(lazy_part_, part_filename);
+        if(result) {
+            try {
+                InputGraphiteFile in(part_filename);
+                while(
+                    in.current_chunk_class() != "SHDR" &&
+                    in.current_chunk_class() != "EOFL"
+                ) {
+                    in.next_chunk();
+                }
+                result = serialize_read(in);
+            } catch(const std::logic_error& e) {
+                Logger::err("I/O") << "Caught exception: " << e.what()
+                                   << std::endl;
+                result = false;
+            }
+        }
+        invalidate_bbox_cache();
+        if(FileSystem::is_file(part_filename)) {
+            FileSystem::delete_file(part_filename);
+        }
+        if(result) {
+            Logger::out("Lazy") << name() << ": loaded on demand in "
+                                << W.elapsed_time() << "s" << std::endl;
+        } else {
+            Logger::err("Lazy") << name() << ": could not load from "
+                                << filename << std::endl;
+        }
+        return result;
+    }
+
+    GrobSnapshot* Grob::create_snapshot() {
+        if(!is_serializable()) {
+            return nullptr;
+        }
+        return new GrobFileSnapshot(this);
+    }
+
+    bool Grob::invoke_method(
+        const std::string& method_name, const ArgList& args, Any& ret_val
+    ) {
+        if(is_lazy() && accesses_data(meta_class()->find_method(method_name))) {
+            materialize();
+        }
+        return Node::invoke_method(method_name, args, ret_val);
+    }
+
+    bool Grob::invoke_method_positional(
+        MetaMethod* method, const Any* const* args, index_t nb_args,
+        Any& ret_val
+    ) {
+        if(is_lazy() && accesses_data(method)) {
+            materialize();
+        }
+        return Node::invoke_method_positional(method, args, nb_args, ret_val);
+    }
+
     bool Grob::serialize_read(InputGraphiteFile& in) {
         geo_argused(in);
         Logger::out("Grob") << "Cannot read from stream"
@@ -222,6 +345,7 @@ namespace OGF {
     }
 
     bool Grob::save(const NewFileName& value) {
+        materialize();
 	if(
 	    FileSystem::extension(value) == "graphite" &&
 	    scene_graph() != this
@@ -59,6 +59,7 @@ namespace OGF {
     class Commands;
     class InputGraphiteFile;
     class OutputGraphiteFile;
+    class GrobSnapshot;
     class Interpreter;
 
     /**
@@ -143,6 +144,134 @@ namespace OGF {
          */
         virtual bool serialize_write(OutputGraphiteFile& geofile);
 
+        /**
+         * \brief Tests whether serialize_read(), serialize_write() and
+         *  load() can be called concurrently on different Grobs.
+         * \details This is the case when they only access the data of
+         *  this Grob (no interpreter, no shader, no GUI, no Logger). It
+         *  is used to read and write chunk-indexed graphite files and to
+         *  load several files in parallel.
+         * \retval true if this Grob can be serialized concurrently
+         * \retval false otherwise
+         * \see GraphiteFileIndex
+         */
+        virtual bool supports_concurrent_serialization() const;
+
+        /**
+         * \brief Makes this Grob lazy.
+         * \details The data of a lazy Grob stays in the chunk-indexed
+         *  graphite file it comes from, and is only read by the first
+         *  call to materialize(), that is, when the Grob is first drawn,
+         *  targeted by a command or interface, accessed through the GOM
+         *  or saved. Until then, bbox() returns the bounding box stored
+         *  in the file.
+         * \param[in] filename the name of the chunk-indexed graphite file
+         * \param[in] part the index of the part that stores this Grob
+         * \param[in] bbox the bounding box of the data of this Grob
+         * \see GraphiteFileIndex
+         */
+        void set_lazy_source(
+            const std::string& filename, index_t part,
+            const Box3d& bbox = Box3d()
+        ) {
+            lazy_filename_ = filename;
+            lazy_part_ = part;
+            lazy_bbox_ = bbox;
+            materialize_requested_ = false;
+        }
+
+        /**
+         * \brief Tests whether this Grob is lazy.
+         * \retval true if the data of this Grob was not read yet
+         * \retval false otherwise
+         * \see set_lazy_source()
+         */
+        bool is_lazy() const {
+            return !lazy_filename_.empty();
+        }
+
+        /**
+         * \brief Gets the file the data of a lazy Grob comes from.
+         * \return the name of the chunk-indexed graphite file, or the
+         *  empty string if this Grob is not lazy
+         * \see set_lazy_source()
+         */
+        const std::string& lazy_filename() const {
+            return lazy_filename_;
+        }
+
+        /**
+         * \brief Gets the part that stores the data of a lazy Grob.
+         * \return the index of the part in the chunk-indexed graphite
+         *  file
+         * \see set_lazy_source()
+         */
+        index_t lazy_part() const {
+            return lazy_part_;
+        }
+
+        /**
+         * \brief Gets the bounding box of a lazy Grob.
+         * \return the bounding box stored in the chunk-indexed graphite
+         *  file
+         * \see set_lazy_source()
+         */
+        const Box3d& lazy_bbox() const {
+            return lazy_bbox_;
+        }
+
+        /**
+         * \brief Indicates that a lazy Grob should be read as soon as
+         *  possible.
+         * \details Called when a lazy Grob needs to be drawn. Reading it
+         *  from the draw pass would emit signals in the middle of a
+         *  frame, so that the Grob is skipped and read by
+         *  SceneGraph::materialize_requested_objects(), called after
+         *  the frame.
+         */
+        void request_materialize() {
+            materialize_requested_ = is_lazy();
+        }
+
+        /**
+         * \brief Tests whether request_materialize() was called.
+         * \retval true if this Grob is lazy and needs to be read
+         * \retval false otherwise
+         */
+        bool materialize_requested() const {
+            return materialize_requested_;
+        }
+
+        /**
+         * \brief Reads the data of a lazy Grob.
+         * \details Does nothing if this Grob is not lazy.
+         * \retval true if the data could be read or if the Grob
+         *  was not lazy
+         * \retval false otherwise
+         * \see set_lazy_source()
+         */
+        bool materialize();
+
+        /**
+         * \copydoc Object::invoke_method
+         * \details Lazy Grobs are materialized before invoking the
+         *  methods declared by subclasses, that access the data.
+         */
+        bool invoke_method(
+            const std::string& method_name,
+            const ArgList& args, Any& ret_val
+        ) override;
+
+        /**
+         * \copydoc Object::invoke_method_positional
+         * \details Lazy Grobs are materialized before invoking the
+         *  methods declared by subclasses, that access the data.
+         */
+        bool invoke_method_positional(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        ) override;
+
         /**
          * \brief Changes the current shader of this Grob
 	 * \details Ignored in non-graphic mode
@@ -249,6 +378,8 @@ namespace OGF {
         void lock_graphics() {
             ++nb_graphics_locks_;
             dirty_ = true;
+            timestamp_ = new_timestamp();
+            invalidate_bbox_cache();
         }
 
         /**
@@ -267,6 +398,48 @@ namespace OGF {
          */
         void unlock_graphics() {
             --nb_graphics_locks_;
+            timestamp_ = new_timestamp();
+            invalidate_bbox_cache();
+        }
+
+        /**
+         * \brief Gets the modification timestamp.
+         * \details The timestamp changes each time update(),
+         *  lock_graphics() / unlock_graphics(), set_visible(),
+         *  set_obj_to_world_transform() or set_grob_attribute() is
+         *  called. It can be
+         *  used by the data structures that depend on the geometry of
+         *  this Grob (e.g., spatial search structures) to detect that
+         *  they need to be rebuilt. Unlike dirty(), it is not reset by
+         *  the shaders. Timestamps come from a global counter, thus
+         *  two different Grobs never share the same timestamp.
+         * \return the modification timestamp
+         */
+        index_t timestamp() const {
+            return timestamp_;
+        }
+
+        /**
+         * \brief Creates a snapshot of this Grob, used by undo / redo.
+         * \details The default implementation creates a snapshot that
+         *  stores the Grob in a file, using serialize_write(). Derived
+         *  classes can overload this function to keep a copy in memory.
+         * \return a pointer to the new snapshot, or nullptr if this Grob
+         *  cannot be saved
+         * \see GrobSnapshot
+         */
+        virtual GrobSnapshot* create_snapshot();
+
+        /**
+         * \brief Discards the cached bounding boxes.
+         * \details Called by update(). Subclasses that cache their
+         *  bounding box (see bbox_cache_) recompute it on the next
+         *  call to bbox(). Code that modifies the geometry without
+         *  calling update() afterwards needs to call this function.
+         */
+        void invalidate_bbox_cache() {
+            bbox_cache_valid_ = false;
+            filtered_bbox_cache_valid_ = false;
         }
 
         /**
@@ -410,6 +583,7 @@ namespace OGF {
             const std::string& name, const std::string& value
         ) {
             attributes().set_arg(name, value);
+            timestamp_ = new_timestamp();
         }
 
     gom_signals:
@@ -514,6 +688,7 @@ namespace OGF {
          */
         void set_obj_to_world_transform(const mat4& value) {
             obj_to_world_ = value;
+            timestamp_ = new_timestamp();
         }
 
         /**
@@ -545,6 +720,15 @@ namespace OGF {
             shader_manager_ = s;
         }
 
+    protected:
+        /**
+         * \brief Gets a new modification timestamp.
+         * \details Can be called concurrently.
+         * \return a value that was never returned before
+         * \see timestamp()
+         */
+        static index_t new_timestamp();
+
     protected:
         std::string name_;
         std::string filename_;
@@ -556,6 +740,23 @@ namespace OGF {
         ArgList grob_attributes_;
         bool dirty_;
         index_t nb_graphics_locks_;
+        index_t timestamp_;
+        std::string lazy_filename_;
+        index_t lazy_part_;
+        Box3d lazy_bbox_;
+        bool materialize_requested_;
+
+        /**
+         * \brief Bounding box cache, used by the subclasses
+         *  that implement bbox().
+         * \details The filtered version is used when the shader
+         *  filters the displayed elements. Both are invalidated by
+         *  update() and by lock_graphics() / unlock_graphics().
+         */
+        mutable Box3d bbox_cache_;
+        mutable Box3d filtered_bbox_cache_;
+        mutable bool bbox_cache_valid_;
+        mutable bool filtered_bbox_cache_valid_;
 
         friend class SceneGraph;
         friend class SceneGraphShaderManager;
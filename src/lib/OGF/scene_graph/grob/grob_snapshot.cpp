@@ -0,0 +1,250 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/scene_graph/grob/grob_snapshot.h>
+#include <OGF/scene_graph/grob/grob.h>
+#include <OGF/scene_graph/types/geofile.h>
+#include <OGF/gom/reflection/meta_class.h>
+
+#include <geogram/basic/file_system.h>
+
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Tests whether two ArgLists have the same names and values.
+     */
+    bool same_args(const ArgList& A, const ArgList& B) {
+        if(A.nb_args() != B.nb_args()) {
+            return false;
+        }
+        for(index_t i=0; i<A.nb_args(); ++i) {
+            if(
+                A.ith_arg_name(i) != B.ith_arg_name(i) ||
+                A.ith_arg_value(i).as_string() !=
+                B.ith_arg_value(i).as_string()
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Tests whether two matrices are equal.
+     */
+    bool same_matrix(const mat4& A, const mat4& B) {
+        for(index_t i=0; i<4; ++i) {
+            for(index_t j=0; j<4; ++j) {
+                if(A(i,j) != B(i,j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+namespace OGF {
+
+    GrobSnapshot::GrobSnapshot(Grob* grob) :
+        grob_(grob),
+        timestamp_(grob->timestamp()),
+        grob_name_(grob->name()),
+        grob_class_name_(grob->meta_class()->name()),
+        grob_attributes_(grob->attributes()),
+        obj_to_world_(grob->get_obj_to_world_transform()),
+        visible_(grob->get_visible()),
+        lazy_filename_(grob->lazy_filename()),
+        lazy_part_(grob->lazy_part()),
+        lazy_bbox_(grob->lazy_bbox()) {
+        grob->get_shader_and_shader_properties(
+            shader_class_name_, shader_properties_, false
+        );
+    }
+
+    bool GrobSnapshot::is_up_to_date(Grob* grob) const {
+        if(
+            grob != grob_ || grob->timestamp() != timestamp_ ||
+            grob->get_visible() != visible_ ||
+            !same_matrix(grob->get_obj_to_world_transform(), obj_to_world_) ||
+            !same_args(grob->attributes(), grob_attributes_)
+        ) {
+            return false;
+        }
+        std::string shader_class_name;
+        ArgList shader_properties;
+        grob->get_shader_and_shader_properties(
+            shader_class_name, shader_properties, false
+        );
+        return (
+            shader_class_name == shader_class_name_ &&
+            same_args(shader_properties, shader_properties_)
+        );
+    }
+
+    GrobSnapshot::~GrobSnapshot() {
+        if(has_file() && FileSystem::is_file(filename_)) {
+            FileSystem::delete_file(filename_);
+        }
+    }
+
+    bool GrobSnapshot::restore(Grob* grob) {
+        if(grob->meta_class()->name() != grob_class_name_) {
+            Logger::err("Undo") << grob->name() << ": cannot restore a "
+                                << grob_class_name_ << std::endl;
+            return false;
+        }
+        // The restored data must not be overwritten by a pending
+        // lazy source.
+        if(!is_lazy()) {
+            grob->set_lazy_source("", NO_INDEX);
+        }
+        bool result = restore_data(grob);
+        if(is_lazy()) {
+            grob->set_lazy_source(lazy_filename_, lazy_part_, lazy_bbox_);
+        }
+        grob->attributes() = grob_attributes_;
+        grob->set_obj_to_world_transform(obj_to_world_);
+        grob->set_visible(visible_);
+        if(shader_class_name_ != "") {
+            grob->set_shader_and_shader_properties(
+                shader_class_name_, shader_properties_
+            );
+        }
+        grob->update();
+        // The Grob is now identical to this snapshot
+        grob_ = grob;
+        timestamp_ = grob->timestamp();
+        return result;
+    }
+
+    size_t GrobSnapshot::memory_size() const {
+        return 0;
+    }
+
+    bool GrobSnapshot::spill() {
+        if(memory_size() == 0) {
+            return true;
+        }
+        return spill_data();
+    }
+
+    bool GrobSnapshot::spill_data() {
+        return false;
+    }
+
+    bool GrobSnapshot::write_file(
+        const std::function<bool(OutputGraphiteFile&)>& write
+    ) {
+        // Private temporary directory of this process, so that the
+        // files are not created in the current working directory.
+        if(!has_file()) {
+            filename_ = temporary_file_name("_undo.graphite");
+        }
+        bool result = false;
+        try {
+            OutputGraphiteFile out(filename_);
+            // Same layout as the parts of chunk-indexed graphite files,
+            // serialize_read() expects to start after a SHDR chunk.
+            ArgList shader_args;
+            out.write_shader(shader_args);
+            result = write(out);
+            out.write_separator();
+        } catch(const std::logic_error& e) {
+            Logger::err("Undo") << "Caught exception: " << e.what()
+                                << std::endl;
+            result = false;
+        }
+        if(!result) {
+            if(FileSystem::is_file(filename_)) {
+                FileSystem::delete_file(filename_);
+            }
+            filename_.clear();
+        }
+        return result;
+    }
+
+    bool GrobSnapshot::read_file(
+        const std::function<bool(InputGraphiteFile&)>& read
+    ) const {
+        if(!has_file() || !FileSystem::is_file(filename_)) {
+            return false;
+        }
+        bool result = false;
+        try {
+            InputGraphiteFile in(filename_);
+            while(
+                in.current_chunk_class() != "SHDR" &&
+                in.current_chunk_class() != "EOFL"
+            ) {
+                in.next_chunk();
+            }
+            result = read(in);
+        } catch(const std::logic_error& e) {
+            Logger::err("Undo") << "Caught exception: " << e.what()
+                                << std::endl;
+            result = false;
+        }
+        return result;
+    }
+
+    /**********************************************************************/
+
+    GrobFileSnapshot::GrobFileSnapshot(Grob* grob) : GrobSnapshot(grob) {
+        if(is_lazy()) {
+            return;
+        }
+        write_file(
+            [grob](OutputGraphiteFile& out)->bool {
+                return grob->serialize_write(out);
+            }
+        );
+    }
+
+    bool GrobFileSnapshot::restore_data(Grob* grob) {
+        grob->clear();
+        if(is_lazy()) {
+            return true;
+        }
+        return read_file(
+            [grob](InputGraphiteFile& in)->bool {
+                return grob->serialize_read(in);
+            }
+        );
+    }
+}
@@ -0,0 +1,273 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_SCENE_GRAPH_GROB_GROB_SNAPSHOT_H
+#define H_OGF_SCENE_GRAPH_GROB_GROB_SNAPSHOT_H
+
+#include <OGF/scene_graph/common/common.h>
+#include <OGF/gom/types/arg_list.h>
+#include <OGF/basic/math/geometry.h>
+
+#include <functional>
+
+/**
+ * \file OGF/scene_graph/grob/grob_snapshot.h
+ * \brief Copies of the state of Grobs, used by undo / redo.
+ */
+
+namespace OGF {
+
+    class Grob;
+    class InputGraphiteFile;
+    class OutputGraphiteFile;
+
+    /**
+     * \brief A copy of the state of a Grob, used by undo / redo.
+     * \details A snapshot remembers the Grob and the timestamp it was
+     *  taken from. Several saved states of the scene graph share the
+     *  same snapshot as long as the Grob is not modified (see
+     *  is_up_to_date()). The data of
+     *  a snapshot is either in memory or in a file. Snapshots in memory
+     *  can be moved to a file (spilled) when the memory budget is
+     *  exceeded.
+     * \see Grob::create_snapshot(), UndoHistory
+     */
+    class SCENE_GRAPH_API GrobSnapshot : public Counted {
+    public:
+        /**
+         * \brief GrobSnapshot constructor.
+         * \details Copies the name, class name, attributes, visibility,
+         *  transform and shader properties of the Grob. Derived classes
+         *  copy the data.
+         *  If the Grob is lazy, only its lazy source is remembered
+         *  (its data was not read yet, and is not copied).
+         * \param[in] grob a pointer to the Grob
+         */
+        GrobSnapshot(Grob* grob);
+
+        /**
+         * \brief GrobSnapshot destructor.
+         * \details Deletes the file used to store the data if any.
+         */
+        ~GrobSnapshot() override;
+
+        /**
+         * \brief Gets the Grob this snapshot was taken from or was
+         *  last restored to.
+         * \details The Grob may have been deleted since then, thus
+         *  the returned pointer should only be compared, never
+         *  dereferenced.
+         * \return a pointer to the Grob
+         */
+        const Grob* grob() const {
+            return grob_;
+        }
+
+        /**
+         * \brief Gets the timestamp of the Grob when this snapshot
+         *  was taken or restored.
+         * \details If the Grob has still the same timestamp, then
+         *  it is identical to this snapshot.
+         * \return the timestamp
+         * \see Grob::timestamp()
+         */
+        index_t timestamp() const {
+            return timestamp_;
+        }
+
+        /**
+         * \brief Tests whether a Grob is identical to this snapshot.
+         * \details The Grob needs to be the one this snapshot was taken
+         *  from or last restored to, with the same timestamp. Since the
+         *  attributes, visibility, transform and shader properties can
+         *  be modified without changing the timestamp (for instance
+         *  directly through Grob::attributes() or from the GUI), they
+         *  are compared as well.
+         * \param[in] grob a pointer to the Grob
+         * \retval true if \p grob is identical to this snapshot
+         * \retval false otherwise
+         */
+        bool is_up_to_date(Grob* grob) const;
+
+        /**
+         * \brief Gets the name of the Grob.
+         * \return the name of the Grob when the snapshot was taken
+         */
+        const std::string& grob_name() const {
+            return grob_name_;
+        }
+
+        /**
+         * \brief Gets the class name of the Grob.
+         * \return the class name, with the "OGF::" prefix
+         */
+        const std::string& grob_class_name() const {
+            return grob_class_name_;
+        }
+
+        /**
+         * \brief Copies this snapshot into a Grob.
+         * \param[in] grob a pointer to a Grob of the same class
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool restore(Grob* grob);
+
+        /**
+         * \brief Gets the memory used by this snapshot.
+         * \return the number of bytes used in memory by the
+         *  copy of the data, or zero if the data is in a file
+         */
+        virtual size_t memory_size() const;
+
+        /**
+         * \brief Moves the data of this snapshot to a file.
+         * \details Does nothing if the data is already in a file.
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool spill();
+
+    protected:
+        /**
+         * \brief Copies the data of this snapshot into a Grob.
+         * \param[in] grob a pointer to a Grob of the same class
+         * \retval true on success
+         * \retval false otherwise
+         */
+        virtual bool restore_data(Grob* grob) = 0;
+
+        /**
+         * \brief Writes the data of this snapshot to a file and
+         *  frees the memory.
+         * \details Called by spill(). Base class implementation
+         *  does nothing and returns false.
+         * \retval true on success
+         * \retval false otherwise
+         * \see write_file()
+         */
+        virtual bool spill_data();
+
+        /**
+         * \brief Writes the file associated with this snapshot.
+         * \details If writing fails, the file is deleted and
+         *  has_file() returns false.
+         * \param[in] write a function that writes the data
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool write_file(
+            const std::function<bool(OutputGraphiteFile&)>& write
+        );
+
+        /**
+         * \brief Reads the file associated with this snapshot.
+         * \param[in] read a function that reads the data
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool read_file(
+            const std::function<bool(InputGraphiteFile&)>& read
+        ) const;
+
+        /**
+         * \brief Tests whether the data is in a file.
+         * \retval true if write_file() was successfully called
+         * \retval false otherwise
+         */
+        bool has_file() const {
+            return (filename_ != "");
+        }
+
+        /**
+         * \brief Tests whether the Grob was lazy when the snapshot
+         *  was taken.
+         * \details In this case, derived classes do not need to
+         *  copy the data, that is read again from the lazy source
+         *  when needed.
+         * \retval true if the Grob was lazy
+         * \retval false otherwise
+         * \see Grob::set_lazy_source()
+         */
+        bool is_lazy() const {
+            return (lazy_filename_ != "");
+        }
+
+    private:
+        const Grob* grob_;
+        index_t timestamp_;
+        std::string grob_name_;
+        std::string grob_class_name_;
+        ArgList grob_attributes_;
+        mat4 obj_to_world_;
+        bool visible_;
+        std::string shader_class_name_;
+        ArgList shader_properties_;
+        std::string lazy_filename_;
+        index_t lazy_part_;
+        Box3d lazy_bbox_;
+        std::string filename_;
+    };
+
+    /**
+     * \brief An automatic reference-counted pointer to a GrobSnapshot.
+     */
+    typedef SmartPointer<GrobSnapshot> GrobSnapshot_var;
+
+    /**
+     * \brief A GrobSnapshot that stores the data in a file,
+     *  using Grob::serialize_write().
+     * \details This is the default snapshot, used by the Grobs that
+     *  cannot copy their data in memory.
+     */
+    class SCENE_GRAPH_API GrobFileSnapshot : public GrobSnapshot {
+    public:
+        /**
+         * \brief GrobFileSnapshot constructor.
+         * \param[in] grob a pointer to the Grob, that should be
+         *  serializable
+         */
+        GrobFileSnapshot(Grob* grob);
+
+    protected:
+        /**
+         * \copydoc GrobSnapshot::restore_data()
+         */
+        bool restore_data(Grob* grob) override;
+    };
+}
+
+#endif
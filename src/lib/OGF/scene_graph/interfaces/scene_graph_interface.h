@@ -71,6 +71,20 @@ namespace OGF {
             const std::string& method_name,
             const ArgList& args, Any& ret_val
         ) override;
+
+        /**
+         * \copydoc Object::invoke_method_positional
+         * \details Routed through invoke_method(), so that positional
+         *  calls are also recorded in the history.
+         */
+        bool invoke_method_positional(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        ) override {
+            return invoke_method_positional_by_name(
+                method, args, nb_args, ret_val
+            );
+        }
     };
 
 }
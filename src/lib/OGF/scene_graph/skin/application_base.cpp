@@ -36,6 +36,8 @@
 
 #include <OGF/scene_graph/skin/application_base.h>
 #include <OGF/scene_graph/skin/preferences.h>
+#include <OGF/scene_graph/types/undo_history.h>
+#include <OGF/scene_graph/types/scene_graph.h>
 #include <OGF/gom/interpreter/interpreter.h>
 #include <OGF/gom/reflection/meta.h>
 #include <OGF/basic/modules/modmgr.h>
@@ -75,20 +77,16 @@ namespace OGF {
         state_buffer_end_     = 0;
         state_buffer_current_ = 0;
         undo_redo_called_ = false;
+        undo_history_ = new UndoHistory(state_buffer_size_);
         started_callback_called_ = false;
     }
 
     ApplicationBase::~ApplicationBase() {
 
         // Cleanup saved states for undo and redo
-        if(Environment::instance()->get_value("gui:undo") == "true") {
-            for(index_t i=0; i<state_buffer_size_; ++i) {
-                std::string filename = state_buffer_filename(i);
-                if(FileSystem::is_file(filename)) {
-                    FileSystem::delete_file(filename);
-                }
-            }
-        }
+        // (deletes the files of the snapshots moved to disk)
+        delete undo_history_;
+        undo_history_ = nullptr;
 
         geo_assert(instance_ == this);
 	if(logger_client_ != nullptr) {
@@ -199,7 +197,7 @@ namespace OGF {
     }
 
 
-    void ApplicationBase::save_state_to_file(const std::string& filename) {
+    void ApplicationBase::save_state_to_buffer(index_t i) {
         if(Environment::instance()->get_value("gui:undo") != "true") {
             return;
         }
@@ -209,36 +207,34 @@ namespace OGF {
             return;
         }
 
-        Object* scene_graph = interpreter()->resolve_object("scene_graph");
+        SceneGraph* scene_graph = dynamic_cast<SceneGraph*>(
+            interpreter()->resolve_object("scene_graph")
+        );
         if(scene_graph != nullptr) {
-            ArgList args;
-            args.create_arg("filename",filename);
-            scene_graph->invoke_method("save", args);
+            // Read at each save, since it can be changed in
+            // the preferences.
+            if(CmdLine::arg_is_declared("gui:undo_memory")) {
+                undo_history_->set_memory_budget(
+                    size_t(CmdLine::get_arg_uint("gui:undo_memory")) *
+                    size_t(1024*1024)
+                );
+            }
+            undo_history_->save(i, scene_graph);
         }
     }
 
-    void ApplicationBase::load_state_from_file(const std::string& filename) {
+    void ApplicationBase::load_state_from_buffer(index_t i) {
         if(Environment::instance()->get_value("gui:undo") != "true") {
             return;
         }
-        if(!FileSystem::is_file(filename)) {
-            Logger::err("App") << "No saved state to restore"
-                               << std::endl;
-            return;
-        }
-        Object* scene_graph = interpreter()->resolve_object("scene_graph");
+        SceneGraph* scene_graph = dynamic_cast<SceneGraph*>(
+            interpreter()->resolve_object("scene_graph")
+        );
         if(scene_graph != nullptr) {
-            ArgList args;
-            scene_graph->invoke_method("clear",args);
-            args.create_arg("filename",filename);
-            scene_graph->invoke_method("load_object", args);
+            undo_history_->restore(i, scene_graph);
         }
     }
 
-    std::string ApplicationBase::state_buffer_filename(index_t i) const {
-        return String::format("graphite_state_%02d.graphite",int(i));
-    }
-
     bool ApplicationBase::get_can_undo() const {
         return (state_buffer_current_ != state_buffer_begin_);
     }
@@ -249,11 +245,14 @@ namespace OGF {
 
 
     void ApplicationBase::save_state() {
-        if(Environment::instance()->get_value("gui:undo") != "true") {
+        if(
+            Environment::instance()->get_value("gui:undo") != "true" ||
+            state_buffer_size_ == 0
+        ) {
             return;
         }
 
-        save_state_to_file(state_buffer_filename(state_buffer_current_));
+        save_state_to_buffer(state_buffer_current_);
         state_buffer_current_ = (state_buffer_current_ + 1) % state_buffer_size_;
         state_buffer_end_ = state_buffer_current_;
         if(state_buffer_current_ == state_buffer_begin_) {
@@ -272,14 +271,14 @@ namespace OGF {
 
         // Make it possible to call redo()
         if(state_buffer_current_ == state_buffer_end_) {
-            save_state_to_file(state_buffer_filename(state_buffer_current_));
+            save_state_to_buffer(state_buffer_current_);
         }
 
         state_buffer_current_ =
             (state_buffer_current_ + state_buffer_size_ - 1) %
             state_buffer_size_;
 
-        load_state_from_file(state_buffer_filename(state_buffer_current_));
+        load_state_from_buffer(state_buffer_current_);
         undo_redo_called_ = true;
     }
 
@@ -291,7 +290,7 @@ namespace OGF {
             return;
         }
         state_buffer_current_ = (state_buffer_current_ + 1) % state_buffer_size_;
-        load_state_from_file(state_buffer_filename(state_buffer_current_));
+        load_state_from_buffer(state_buffer_current_);
         undo_redo_called_ = true;
     }
 
@@ -304,6 +303,15 @@ namespace OGF {
             started_callback_called_ = true;
             started();
         }
+        SceneGraph* scene_graph = dynamic_cast<SceneGraph*>(
+            interpreter()->resolve_object("scene_graph")
+        );
+        if(
+            scene_graph != nullptr &&
+            scene_graph->materialize_requested_objects() != 0
+        ) {
+            update();
+        }
     }
 
     void ApplicationBase::lock_updates() {
@@ -50,6 +50,8 @@
 
 namespace OGF {
 
+    class UndoHistory;
+
     /**
      * \brief Base class for Application.
      * \details Contains all the toolkit-independent
@@ -366,35 +368,23 @@ namespace OGF {
     protected:
 
         /**
-         * \brief Saves Graphite state to a file.
-	 * \param[in] filename a filename with or without path with .graphite
-	 *   extension.
-	 * \details The Graphite state contains all the objects of the
-	 *   scene graph, their graphic attributes, the command-line parameters,
-	 *   the placement of the windows and the command history.
-         */
-        virtual void save_state_to_file(const std::string& filename);
-
-        /**
-         * \brief Loads Graphite state from a file.
-	 * \param[in] filename a filename with or without path with .graphite
-	 *   extension.
-	 * \details The Graphite state contains all the objects of the
-	 *   scene graph, their graphic attributes, the command-line parameters,
-	 *   the placement of the windows and the command history.
+         * \brief Saves the state of the scene graph in a state buffer.
+         * \details Only the objects modified since the previous saved
+         *  state are copied, the others share their copy with the
+         *  previous states.
+         * \param[in] i the index of the state buffer
+         * \see UndoHistory
          */
-        virtual void load_state_from_file(const std::string& filename);
+        virtual void save_state_to_buffer(index_t i);
 
         /**
-         * \brief Gets the file name to be used to store a state buffer.
-         * \details Used by undo() / redo(). State buffers are stored
-         *  as .graphite files, that store the scene graph and the
-         *  complete state of Graphite.
+         * \brief Restores the state of the scene graph from a state buffer.
+         * \details Only the objects that differ from the saved state are
+         *  copied back.
          * \param[in] i the index of the state buffer
-         * \return the file name to be used to store or retreive the
-         *  state buffer.
+         * \see UndoHistory
          */
-        std::string state_buffer_filename(index_t i) const;
+        virtual void load_state_from_buffer(index_t i);
 
 
 	/**
@@ -482,6 +472,7 @@ namespace OGF {
         index_t state_buffer_size_;
         index_t state_buffer_current_;
         bool undo_redo_called_;
+        UndoHistory* undo_history_;
 
         static ApplicationBase* instance_;
 	static bool stopping_;
@@ -35,6 +35,99 @@
  */
 
 #include <OGF/scene_graph/types/geofile.h>
+#include <geogram/basic/file_system.h>
+#include <geogram/basic/string.h>
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#ifdef GEO_OS_WINDOWS
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief The magic number at the end of chunk-indexed graphite files.
+     * \details The last character is the version of the format:
+     *  - '1': part 0 only has the scene graph header and the history;
+     *  - '2': part 0 also has a copy of the GROB and SHDR chunks of
+     *    all the grobs, with their bounding boxes.
+     */
+    const char graphite_index_magic[8] = {
+        'G','R','P','H','I','D','X','2'
+    };
+
+    /**
+     * \brief Copies a range of bytes from a stream to another one.
+     * \param[in] in the input stream, positioned at the beginning of the
+     *  range
+     * \param[in] out the output stream
+     * \param[in] size number of bytes to be copied
+     * \retval true on success
+     * \retval false otherwise
+     */
+    bool copy_bytes(
+        std::istream& in, std::ostream& out, Numeric::uint64 size
+    ) {
+        std::vector<char> buffer(1024*1024);
+        while(size != 0) {
+            size_t nb = size_t(
+                std::min(size, Numeric::uint64(buffer.size()))
+            );
+            in.read(buffer.data(), std::streamsize(nb));
+            if(!in) {
+                return false;
+            }
+            out.write(buffer.data(), std::streamsize(nb));
+            if(!out) {
+                return false;
+            }
+            size -= Numeric::uint64(nb);
+        }
+        return true;
+    }
+
+    /**
+     * \brief Gets the identifier of the current process.
+     * \return the process id, used to create temporary files that do
+     *  not collide with the ones of other Graphite instances
+     */
+    long process_id() {
+#ifdef GEO_OS_WINDOWS
+        return long(_getpid());
+#else
+        return long(getpid());
+#endif
+    }
+
+    /**
+     * \brief The private temporary directory of this process.
+     */
+    std::string temporary_directory;
+
+    /**
+     * \brief Deletes the private temporary directory and the files
+     *  that remain in it.
+     * \details Registered with atexit() by temporary_file_name().
+     */
+    void delete_temporary_directory() {
+        if(!FileSystem::is_directory(temporary_directory)) {
+            return;
+        }
+        std::vector<std::string> files;
+        FileSystem::get_files(temporary_directory, files, false);
+        for(const std::string& file: files) {
+            FileSystem::delete_file(file);
+        }
+        FileSystem::delete_directory(temporary_directory);
+    }
+}
 
 namespace OGF {
 
@@ -131,7 +224,231 @@ namespace OGF {
         return result;
     }
 
+    /*************************************************************/
+
+    bool GraphiteFileIndex::is_indexed(const std::string& filename) {
+        return file_version(filename) != 0;
+    }
+
+    index_t GraphiteFileIndex::file_version(const std::string& filename) {
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        if(!in) {
+            return 0;
+        }
+        in.seekg(0, std::ios::end);
+        std::streamoff file_size = in.tellg();
+        if(file_size < std::streamoff(sizeof(graphite_index_magic))) {
+            return 0;
+        }
+        in.seekg(
+            -std::streamoff(sizeof(graphite_index_magic)), std::ios::end
+        );
+        char magic[sizeof(graphite_index_magic)];
+        in.read(magic, sizeof(magic));
+        size_t prefix_size = sizeof(magic)-1;
+        if(!in || ::memcmp(magic, graphite_index_magic, prefix_size)) {
+            return 0;
+        }
+        char version = magic[prefix_size];
+        if(version < '1' || version > graphite_index_magic[prefix_size]) {
+            Logger::err("GeoFile") << filename
+                                   << ": unsupported chunk index version "
+                                   << version << std::endl;
+            return 0;
+        }
+        return index_t(version - '0');
+    }
+
+    bool GraphiteFileIndex::read(const std::string& filename) {
+        filename_ = filename;
+        part_offset_.clear();
+        part_size_.clear();
+        version_ = file_version(filename);
+        if(version_ == 0) {
+            return false;
+        }
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        in.seekg(0, std::ios::end);
+        Numeric::uint64 file_size = Numeric::uint64(in.tellg());
+        Numeric::uint64 trailer_size = Numeric::uint64(
+            sizeof(Numeric::uint64) + sizeof(graphite_index_magic)
+        );
+        if(!in || file_size < trailer_size) {
+            return false;
+        }
+        in.seekg(-std::streamoff(trailer_size), std::ios::end);
+        Numeric::uint64 nb = 0;
+        in.read(reinterpret_cast<char*>(&nb), sizeof(nb));
+
+        // The number of parts comes from the file: check that the
+        // index fits in the file before allocating anything.
+        Numeric::uint64 entry_size = 2*sizeof(Numeric::uint64);
+        if(!in || nb == 0 || nb > (file_size - trailer_size) / entry_size) {
+            Logger::err("GeoFile") << filename << ": corrupted chunk index"
+                                   << std::endl;
+            return false;
+        }
+        Numeric::uint64 index_begin = file_size - trailer_size - nb*entry_size;
+        in.seekg(std::streamoff(index_begin), std::ios::beg);
+        part_offset_.resize(size_t(nb));
+        part_size_.resize(size_t(nb));
+        for(size_t i=0; i<size_t(nb); ++i) {
+            in.read(
+                reinterpret_cast<char*>(&part_offset_[i]),
+                sizeof(Numeric::uint64)
+            );
+            in.read(
+                reinterpret_cast<char*>(&part_size_[i]),
+                sizeof(Numeric::uint64)
+            );
+            if(
+                in && (
+                    part_offset_[i] > index_begin ||
+                    part_size_[i] > index_begin - part_offset_[i]
+                )
+            ) {
+                in.setstate(std::ios::failbit);
+            }
+        }
+        if(!in) {
+            Logger::err("GeoFile") << filename << ": corrupted chunk index"
+                                   << std::endl;
+            part_offset_.clear();
+            part_size_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool GraphiteFileIndex::extract_part(
+        index_t i, const std::string& part_filename
+    ) const {
+        geo_assert(i < nb_parts());
+        std::ifstream in(filename_.c_str(), std::ios::binary);
+        std::ofstream out(part_filename.c_str(), std::ios::binary);
+        if(!in || !out) {
+            return false;
+        }
+        in.seekg(std::streamoff(part_offset_[i]), std::ios::beg);
+        return copy_bytes(in, out, part_size_[i]);
+    }
+
+    bool GraphiteFileIndex::begin_write(
+        const std::string& filename, index_t nb_parts
+    ) {
+        geo_assert(nb_parts != 0);
+        filename_ = filename;
+        out_.open(
+            filename.c_str(),
+            std::ios::in | std::ios::out | std::ios::binary
+        );
+        if(!out_) {
+            return false;
+        }
+        out_.seekp(0, std::ios::end);
+        part_offset_.assign(nb_parts, Numeric::uint64(NO_PART));
+        part_size_.assign(nb_parts, 0);
+        part_offset_[0] = 0;
+        part_size_[0] = Numeric::uint64(out_.tellp());
+        return bool(out_);
+    }
+
+    bool GraphiteFileIndex::append_part(
+        index_t i, const std::string& part_filename
+    ) {
+        geo_assert(i < nb_parts());
+        std::ifstream in(part_filename.c_str(), std::ios::binary);
+        if(!in) {
+            return false;
+        }
+        in.seekg(0, std::ios::end);
+        Numeric::uint64 part_size = Numeric::uint64(in.tellg());
+        in.seekg(0, std::ios::beg);
+        std::lock_guard<std::mutex> lock(out_lock_);
+        Numeric::uint64 offset = Numeric::uint64(out_.tellp());
+        if(!copy_bytes(in, out_, part_size)) {
+            return false;
+        }
+        part_offset_[i] = offset;
+        part_size_[i] = part_size;
+        return true;
+    }
+
+    bool GraphiteFileIndex::end_write() {
+        bool result = bool(out_);
+        for(index_t i=0; i<nb_parts(); ++i) {
+            if(part_offset_[i] == NO_PART) {
+                result = false;
+            }
+        }
+        if(result) {
+            for(index_t i=0; i<nb_parts(); ++i) {
+                out_.write(
+                    reinterpret_cast<const char*>(&part_offset_[i]),
+                    sizeof(Numeric::uint64)
+                );
+                out_.write(
+                    reinterpret_cast<const char*>(&part_size_[i]),
+                    sizeof(Numeric::uint64)
+                );
+            }
+            Numeric::uint64 nb = Numeric::uint64(nb_parts());
+            out_.write(reinterpret_cast<const char*>(&nb), sizeof(nb));
+            out_.write(graphite_index_magic, sizeof(graphite_index_magic));
+            result = bool(out_);
+        }
+        out_.close();
+        return result;
+    }
+
+    std::string GraphiteFileIndex::part_filename(
+        const std::string& filename, index_t i
+    ) {
+        return temporary_file_name(
+            FileSystem::base_name(filename) +
+            String::format("_part_%05d.graphite", int(i))
+        );
+    }
 
+    /*************************************************************/
 
+    std::string temporary_file_name(const std::string& suffix) {
+        static std::mutex lock;
+        static std::string directory;
+        static index_t counter = 0;
+        std::lock_guard<std::mutex> guard(lock);
+        if(directory == "") {
+            std::string tmp_dir;
+            for(const char* var : {"TMPDIR", "TEMP", "TMP"}) {
+                const char* value = ::getenv(var);
+                if(value != nullptr && FileSystem::is_directory(value)) {
+                    tmp_dir = value;
+                    break;
+                }
+            }
+            if(tmp_dir == "") {
+#ifdef GEO_OS_WINDOWS
+                tmp_dir = FileSystem::get_current_working_directory();
+#else
+                tmp_dir = "/tmp";
+#endif
+            }
+            directory = tmp_dir + "/graphite_" +
+                String::to_string(process_id());
+            if(
+                !FileSystem::is_directory(directory) &&
+                !FileSystem::create_directory(directory)
+            ) {
+                Logger::warn("GeoFile") << "Could not create " << directory
+                                        << std::endl;
+                directory = tmp_dir;
+            } else {
+                temporary_directory = directory;
+                std::atexit(delete_temporary_directory);
+            }
+        }
+        ++counter;
+        return directory + "/" + String::to_string(counter) + "_" + suffix;
+    }
     /*************************************************************/
 }
@@ -41,6 +41,9 @@
 #include <OGF/gom/types/arg_list.h>
 #include <geogram/basic/geofile.h>
 
+#include <fstream>
+#include <mutex>
+
 /**
  * \file OGF/scene_graph/types/geofile.h
  * \brief Structured binary files for saving Graphite scene graph.
@@ -178,7 +181,170 @@ namespace OGF {
         size_t arg_list_size(const ArgList& args) const;
     };
 
-    /***************************************************************/    
+    /***************************************************************/
+
+    /**
+     * \brief The index of a chunk-indexed graphite file.
+     * \details A chunk-indexed graphite file is the concatenation of
+     *  independent graphite files (parts), followed by an index with
+     *  the offset and size of each part, the number of parts and a
+     *  magic number (with the version of the format). The first part
+     *  has the scene graph header, the history and a copy of the GROB
+     *  and SHDR chunks of all the grobs, with a "bbox" argument in the
+     *  GROB chunks.
+     *  Each other part has the GROB and SHDR chunks of a single grob
+     *  followed by the grob's own chunks. Since the parts are
+     *  independent, they can be encoded and decoded concurrently, and
+     *  a grob can be read only when it is needed (see
+     *  Grob::set_lazy_source()).
+     */
+    class SCENE_GRAPH_API GraphiteFileIndex {
+    public:
+        /**
+         * \brief GraphiteFileIndex constructor.
+         */
+        GraphiteFileIndex() : version_(0) {
+        }
+
+        /**
+         * \brief Tests whether a file is a chunk-indexed graphite file.
+         * \param[in] filename the name of the file
+         * \retval true if the file ends with a chunk index
+         * \retval false otherwise (plain graphite files)
+         */
+        static bool is_indexed(const std::string& filename);
+
+        /**
+         * \brief Gets the version of the format of a chunk-indexed
+         *  graphite file.
+         * \param[in] filename the name of the file
+         * \return the version of the format, or 0 if the file is not
+         *  a chunk-indexed graphite file or has an unsupported version
+         * \see version()
+         */
+        static index_t file_version(const std::string& filename);
+
+        /**
+         * \brief Gets the version of the format of the file.
+         * \details Part 0 of version 1 files does not have a copy of the
+         *  grob headers, and lazy loading is not possible with them.
+         *  Files are always written with the latest version.
+         * \return the version of the file read by read()
+         */
+        index_t version() const {
+            return version_;
+        }
+
+        /**
+         * \brief Reads the index of a chunk-indexed graphite file.
+         * \param[in] filename the name of the file
+         * \retval true if the index could be read
+         * \retval false otherwise
+         */
+        bool read(const std::string& filename);
+
+        /**
+         * \brief Gets the number of parts.
+         * \return the number of parts, including the scene graph
+         *  header part
+         */
+        index_t nb_parts() const {
+            return index_t(part_offset_.size());
+        }
+
+        /**
+         * \brief Copies a part into a separate graphite file.
+         * \param[in] i the index of the part
+         * \param[in] part_filename the name of the file to be created,
+         *  that can then be read with an InputGraphiteFile
+         * \retval true on success
+         * \retval false otherwise
+         * \details Can be called concurrently for different parts.
+         */
+        bool extract_part(index_t i, const std::string& part_filename) const;
+
+        /**
+         * \brief Starts writing a chunk-indexed graphite file.
+         * \details The first part (with the scene graph header) is
+         *  expected to be already written in the file, the other ones
+         *  are appended by append_part() and the index is written by
+         *  end_write().
+         * \param[in] filename the name of the file
+         * \param[in] nb_parts the total number of parts, including the
+         *  first one
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool begin_write(const std::string& filename, index_t nb_parts);
+
+        /**
+         * \brief Appends a part to the file being written.
+         * \details Parts can be appended in any order, and concurrently
+         *  from different threads.
+         * \param[in] i the index of the part
+         * \param[in] part_filename the name of the graphite file with
+         *  the part
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool append_part(index_t i, const std::string& part_filename);
+
+        /**
+         * \brief Writes the index and closes the file.
+         * \retval true on success
+         * \retval false otherwise (including when a part is missing)
+         */
+        bool end_write();
+
+        /**
+         * \brief Gets the offset of a part.
+         * \param[in] i the index of the part
+         * \return the offset of the part in the file, in bytes. A part
+         *  at offset 0 can be read directly from the file, without
+         *  extracting it.
+         */
+        Numeric::uint64 part_offset(index_t i) const {
+            geo_debug_assert(i < nb_parts());
+            return part_offset_[i];
+        }
+
+        /**
+         * \brief Gets a name for a temporary part file.
+         * \param[in] filename the name of the chunk-indexed graphite file
+         * \param[in] i the index of the part
+         * \return a unique file name in the temporary directory of the
+         *  current process
+         * \see temporary_file_name()
+         */
+        static std::string part_filename(
+            const std::string& filename, index_t i
+        );
+
+    private:
+        static const Numeric::uint64 NO_PART = Numeric::uint64(-1);
+
+        std::string filename_;
+        index_t version_;
+        std::vector<Numeric::uint64> part_offset_;
+        std::vector<Numeric::uint64> part_size_;
+        std::fstream out_;
+        std::mutex out_lock_;
+    };
+
+    /***************************************************************/
+
+    /**
+     * \brief Gets a name for a temporary file.
+     * \details Temporary files are created in a directory that is
+     *  private to the current process (so that several instances of
+     *  Graphite do not overwrite each other's files), and that is
+     *  deleted on exit.
+     * \param[in] suffix the end of the file name
+     * \return a file name that was not returned before by this function
+     */
+    std::string SCENE_GRAPH_API temporary_file_name(const std::string& suffix);
+
+    /***************************************************************/
 }
 
 #endif
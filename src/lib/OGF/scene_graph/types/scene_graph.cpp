@@ -51,10 +51,49 @@
 #include <geogram/basic/file_system.h>
 #include <geogram/basic/stopwatch.h>
 #include <geogram/basic/command_line.h>
+#include <geogram/basic/process.h>
 
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
 
 
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Gets the bounding box stored in a grob header.
+     * \details The "bbox" argument is only present in part 0 of
+     *  chunk-indexed graphite files. It is removed from \p args.
+     * \param[in,out] args the grob header
+     * \return the bounding box, or an uninitialized box if there
+     *  is no (valid) "bbox" argument
+     */
+    Box3d extract_bbox(ArgList& args) {
+        Box3d result;
+        index_t i = args.find_arg_index("bbox");
+        if(i == index_t(-1)) {
+            return result;
+        }
+        std::vector<std::string> coords;
+        String::split_string(args.ith_arg_value(i).as_string(), ' ', coords);
+        args.delete_ith_arg(i);
+        double xyz[6];
+        if(coords.size() != 6) {
+            return result;
+        }
+        for(index_t c=0; c<6; ++c) {
+            if(!String::from_string(coords[c], xyz[c])) {
+                return result;
+            }
+        }
+        result.add_point(vec3(xyz[0], xyz[1], xyz[2]));
+        result.add_point(vec3(xyz[3], xyz[4], xyz[5]));
+        return result;
+    }
+}
+
 namespace OGF {
 
 /*****************************************************************************/
@@ -342,24 +381,26 @@ namespace OGF {
 	if(FileSystem::is_directory(file_name)) {
 	    std::vector<std::string> files;
 	    FileSystem::get_files(file_name, files, false); // false: !recursive
+	    std::vector<std::string> batch;
 	    for(const std::string& cur_file_name: files) {
 		std::string extension = FileSystem::extension(cur_file_name);
 
-		bool can_load = (
+		if(
 		    extension == "graphite" || extension == "graphite_ascii" ||
 		    extension == "aln"
-		);
-		if(!can_load) {
+		) {
+		    load_object(cur_file_name, "default", change_cwd);
+		} else {
 		    std::string class_name_str =
 			SceneGraphLibrary::instance()->file_extension_to_grob(
 			    extension
 			);
-		    can_load = (class_name_str.length() != 0);
-		}
-		if(can_load) {
-		    load_object(cur_file_name, "default", change_cwd);
+		    if(class_name_str.length() != 0) {
+			batch.push_back(cur_file_name);
+		    }
 		}
 	    }
+	    load_objects_batch(batch, change_cwd);
 	    return this;
 	}
 
@@ -377,12 +418,16 @@ namespace OGF {
         }
 
         if(extension == "graphite" || extension == "graphite_ascii") {
-            try {
-                InputGraphiteFile in(file_name);
-                serialize_read(in);
-            } catch(const std::logic_error& e) {
-                Logger::err("GeoFile") << "Caught exception: "
-                                   << e.what() << std::endl;
+            if(GraphiteFileIndex::is_indexed(file_name)) {
+                serialize_read_indexed(file_name);
+            } else {
+                try {
+                    InputGraphiteFile in(file_name);
+                    serialize_read(in);
+                } catch(const std::logic_error& e) {
+                    Logger::err("GeoFile") << "Caught exception: "
+                                           << e.what() << std::endl;
+                }
             }
 	    {
 		Object* sgsm = get_scene_graph_shader_manager();
@@ -464,6 +509,168 @@ namespace OGF {
         }
     }
 
+    void SceneGraph::load_objects_batch(
+        const std::vector<std::string>& file_names, bool change_cwd
+    ) {
+        if(file_names.size() == 0) {
+            return;
+        }
+
+        Stopwatch W("Load",false);
+
+        // Objects are created serially, with signals disabled
+        // (the GUI sees them once they are all loaded).
+        std::vector<Grob*> grobs;
+        std::vector<std::string> grob_file_names;
+        std::vector<std::vector<std::string> > grob_class_names;
+        bool signals_enabled = get_signals_enabled();
+        disable_signals();
+        for(const std::string& file_name: file_names) {
+            std::string extension = FileSystem::extension(file_name);
+            std::string base_name = FileSystem::base_name(file_name);
+            if(extension == "gz") {
+                base_name = FileSystem::base_name(base_name);
+            }
+            std::vector<std::string> class_names;
+            String::split_string(
+                SceneGraphLibrary::instance()->file_extension_to_grob(
+                    extension
+                ),
+                ';', class_names
+            );
+            Grob* grob = (class_names.size() == 0) ?
+                nullptr : create_object(class_names[0]);
+            if(grob == nullptr) {
+                Logger::err("Load") << file_name
+                                    << ": could not create object"
+                                    << std::endl;
+                continue;
+            }
+            grob->rename(base_name);
+            grob->set_filename(file_name);
+            grobs.push_back(grob);
+            grob_file_names.push_back(file_name);
+            grob_class_names.push_back(class_names);
+        }
+
+        index_t nb_grobs = index_t(grobs.size());
+        std::vector<double> load_time(nb_grobs, 0.0);
+        std::vector<bool> load_ok(nb_grobs, false);
+
+        //   The Logger is not thread-safe: errors are stored per file
+        // and reported once all the files are loaded.
+        std::vector<std::string> load_error(nb_grobs);
+
+        auto load_grob = [&](index_t i) {
+            Stopwatch W_grob("Load",false);
+            grobs[i]->disable_signals();
+            bool ok = false;
+            try {
+                ok = grobs[i]->load(grob_file_names[i]);
+            } catch(const std::logic_error& e) {
+                load_error[i] = e.what();
+            }
+            grobs[i]->enable_signals();
+            load_time[i] = W_grob.elapsed_time();
+            return ok;
+        };
+
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(!grobs[i]->supports_concurrent_serialization()) {
+                load_ok[i] = load_grob(i);
+            }
+        }
+
+        // std::vector<bool> cannot be written concurrently
+        std::vector<Numeric::uint8> concurrent_load_ok(nb_grobs, 0);
+        parallel_for(
+            0, nb_grobs,
+            [&](index_t i) {
+                if(grobs[i]->supports_concurrent_serialization()) {
+                    concurrent_load_ok[i] = load_grob(i) ? 1 : 0;
+                }
+            }
+        );
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(grobs[i]->supports_concurrent_serialization()) {
+                load_ok[i] = (concurrent_load_ok[i] != 0);
+            }
+            if(load_error[i] != "") {
+                Logger::err("SceneGraph") << grob_file_names[i]
+                                          << ": caught exception: "
+                                          << load_error[i] << std::endl;
+            }
+        }
+
+        set_signals_enabled(signals_enabled);
+
+        // Attach all the objects with a single notification
+        update_values();
+
+        Numeric::uint64 total_size = 0;
+        index_t nb_loaded = 0;
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(!load_ok[i]) {
+                continue;
+            }
+            std::ifstream in(
+                grob_file_names[i].c_str(), std::ios::binary | std::ios::ate
+            );
+            Numeric::uint64 size = in ? Numeric::uint64(in.tellg()) : 0;
+            total_size += size;
+            ++nb_loaded;
+            Logger::out("Load")
+                << FileSystem::base_name(grob_file_names[i], false)
+                << ": " << load_time[i] << "s"
+                << " (" << double(size) / (1024.0 * 1024.0) << " MB)"
+                << std::endl;
+        }
+
+        //   Files that could not be loaded with the first class
+        // associated with their extension are tried with the other
+        // classes (if any), like in load_object().
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(load_ok[i]) {
+                continue;
+            }
+            delete_object(grobs[i]->name());
+            grobs[i] = nullptr;
+            for(index_t j=1; j<grob_class_names[i].size(); ++j) {
+                grobs[i] = load_object(
+                    grob_file_names[i], grob_class_names[i][j], false
+                );
+                if(grobs[i] != nullptr) {
+                    break;
+                }
+            }
+            if(grobs[i] == nullptr) {
+                Logger::err("Load") << grob_file_names[i]
+                                    << ": could not load file"
+                                    << std::endl;
+            }
+        }
+
+        if(nb_grobs != 0 && grobs[nb_grobs-1] != nullptr) {
+            set_current_object(grobs[nb_grobs-1]->name());
+        }
+
+        // Same as calling load_object() with change_cwd for each file
+        if(change_cwd) {
+            const std::string dir = FileSystem::dir_name(file_names.back());
+            if(FileSystem::is_directory(dir)) {
+                FileSystem::set_current_working_directory(dir);
+            }
+        }
+
+        double elapsed = std::max(W.elapsed_time(), 1e-6);
+        Logger::out("Load")
+            << nb_loaded << " files loaded in " << elapsed << "s ("
+            << double(total_size) / (1024.0 * 1024.0 * elapsed)
+            << " MB/s, "
+            << double(nb_loaded) / elapsed << " files/s)"
+            << std::endl;
+    }
+
     bool SceneGraph::save_current_object(const NewFileName& file_name) {
         if(is_bound(current_object_name_)) {
             Grob* grob = current();
@@ -722,8 +929,400 @@ namespace OGF {
         return true;
     }
 
+    bool SceneGraph::save(const NewFileName& filename) {
+        if(
+            FileSystem::extension(filename) == "graphite" &&
+            Environment::instance()->get_value("gui:indexed_graphite") ==
+            "true"
+        ) {
+            return serialize_write_indexed(filename);
+        }
+        return CompositeGrob::save(filename);
+    }
+
+    bool SceneGraph::serialize_write_indexed(const std::string& filename) {
+        Stopwatch W("GeoFile");
+
+        std::vector<Grob*> grobs;
+        for(index_t i=0; i<get_nb_children(); i++) {
+            Grob* grob = ith_child(i);
+            if(grob->is_serializable()) {
+                grobs.push_back(grob);
+            } else {
+                Logger::out("SceneGraph")
+                    << "Could not serialize " << grob->name()
+                    << "(" << grob->meta_class()->name() << ")" << std::endl;
+            }
+        }
+
+        // Part 0 is the scene graph header, part i+1 is grobs[i]
+        index_t nb_grobs = index_t(grobs.size());
+
+        // Grob and shader headers are gathered serially, since they
+        // use the GOM.
+        std::vector<ArgList> grob_headers(nb_grobs);
+        std::vector<ArgList> shader_headers(nb_grobs);
+        for(index_t i=0; i<nb_grobs; ++i) {
+            Logger::out("GeoFile")
+                << "<< " << grobs[i]->name()
+                << " (" << grobs[i]->meta_class()->name() << ")"
+                << std::endl;
+            grobs[i]->materialize();
+            get_grob_header(grobs[i], grob_headers[i]);
+            get_grob_shader_header(grobs[i], shader_headers[i]);
+        }
+
+        std::atomic<bool> ok(true);
+
+        //   The headers of all the grobs are replicated in part 0, so that
+        // objects can be created without reading the other parts. Part 0
+        // is written directly at the beginning of the file.
+        try {
+            OutputGraphiteFile out(filename);
+            begin_graphite_file(out,true);
+            for(index_t i=0; i<nb_grobs; ++i) {
+                // The bounding box is used by lazy objects before they
+                // are read.
+                ArgList grob_header = grob_headers[i];
+                Box3d B = grobs[i]->bbox();
+                if(B.initialized()) {
+                    grob_header.create_arg(
+                        "bbox", String::format(
+                            "%.17g %.17g %.17g %.17g %.17g %.17g",
+                            B.x_min(), B.y_min(), B.z_min(),
+                            B.x_max(), B.y_max(), B.z_max()
+                        )
+                    );
+                }
+                out.write_grob_header(grob_header);
+                out.write_shader(shader_headers[i]);
+            }
+        } catch(const std::logic_error& e) {
+            Logger::err("GeoFile") << "Caught exception: " << e.what()
+                                   << std::endl;
+            ok = false;
+        }
+
+        GraphiteFileIndex index;
+        if(ok && !index.begin_write(filename, nb_grobs+1)) {
+            ok = false;
+        }
+
+        //   The other parts are encoded concurrently (GeoFiles can only
+        // be written to a file), and each one is appended to the file as
+        // soon as it is ready, so that at most one part per thread is
+        // stored in a temporary file. The Logger is not thread-safe:
+        // errors are stored per part and reported once all the parts
+        // are written.
+        std::vector<std::string> part_error(nb_grobs);
+        auto write_part = [&](index_t i) {
+            if(!ok) {
+                return;
+            }
+            std::string part_filename =
+                GraphiteFileIndex::part_filename(filename,i+1);
+            try {
+                {
+                    OutputGraphiteFile out(part_filename);
+                    out.write_grob_header(grob_headers[i]);
+                    out.write_shader(shader_headers[i]);
+                    if(!grobs[i]->serialize_write(out)) {
+                        ok = false;
+                    }
+                    out.write_separator();
+                }
+                if(ok && !index.append_part(i+1, part_filename)) {
+                    ok = false;
+                }
+            } catch(const std::logic_error& e) {
+                part_error[i] = e.what();
+                ok = false;
+            }
+            if(FileSystem::is_file(part_filename)) {
+                FileSystem::delete_file(part_filename);
+            }
+        };
+
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(!grobs[i]->supports_concurrent_serialization()) {
+                write_part(i);
+            }
+        }
+
+        parallel_for(
+            0, nb_grobs,
+            [&](index_t i) {
+                if(grobs[i]->supports_concurrent_serialization()) {
+                    write_part(i);
+                }
+            }
+        );
+
+        if(!index.end_write()) {
+            ok = false;
+        }
+
+        for(index_t i=0; i<nb_grobs; ++i) {
+            if(part_error[i] != "") {
+                Logger::err("GeoFile") << "Caught exception: "
+                                       << part_error[i] << std::endl;
+            }
+        }
+
+        if(!ok) {
+            Logger::err("GeoFile") << "Could not save " << filename
+                                   << std::endl;
+            return false;
+        }
+
+        Logger::out("GeoFile") << "<< EOF (" << nb_grobs+1
+                               << " indexed parts)" << std::endl;
+        return true;
+    }
+
+    bool SceneGraph::serialize_read_indexed(const std::string& filename) {
+        Stopwatch W("GeoFile");
+
+        GraphiteFileIndex index;
+        if(!index.read(filename) || index.nb_parts() == 0) {
+            Logger::err("GeoFile") << filename << ": invalid chunk index"
+                                   << std::endl;
+            return false;
+        }
+
+        index_t nb_parts = index.nb_parts();
+
+        //   In lazy mode, the grobs only keep the file and the index of
+        // their part, and are read by Grob::materialize() when they are
+        // first used.
+        bool lazy =
+            (Environment::instance()->get_value("gui:lazy_graphite") == "true");
+
+        //   In version 1 files, the grob headers are not replicated in
+        // part 0, and each part is read serially with its header.
+        if(index.version() < 2 && lazy) {
+            Logger::warn("GeoFile") << filename
+                                    << ": old format, cannot load lazily"
+                                    << std::endl;
+            lazy = false;
+        }
+
+        //   Part 0 is normally at the beginning of the file, where it can
+        // be read directly. The other parts are extracted to a temporary
+        // file right before being read (GeoFiles can only be read from a
+        // file).
+        std::atomic<bool> ok(true);
+        std::string header_filename = filename;
+        if(index.part_offset(0) != 0) {
+            header_filename = GraphiteFileIndex::part_filename(filename,0);
+            if(!index.extract_part(0, header_filename)) {
+                ok = false;
+            }
+        }
+
+        std::string current_object;
+        // grobs[i] is stored in part i (part 0 is the scene graph header)
+        std::vector<Grob*> grobs(nb_parts, nullptr);
+        std::vector<ArgList> shader_properties(nb_parts);
+
+        //   The scene graph header and the headers of all the grobs
+        // (replicated in part 0) are read serially, since they create
+        // the objects and set the properties.
+        // Signals are emitted once all the objects are read.
+        bool signals_enabled = get_signals_enabled();
+        disable_signals();
+
+        if(ok) {
+            try {
+                InputGraphiteFile in(header_filename);
+                index_t part = 1;
+                for(std::string chunk_class = in.current_chunk_class();
+                    chunk_class != "EOFL";
+                    chunk_class = in.next_chunk()) {
+                    if(chunk_class == "SCNG") {
+                        ArgList scene_graph_args;
+                        in.read_scene_graph_header(scene_graph_args);
+                        if(scene_graph_args.has_arg("current_object")) {
+                            current_object =
+                                scene_graph_args.get_arg("current_object");
+                        }
+                        copy_arglist_to_properties(scene_graph_args);
+                    } else if(chunk_class == "GROB" && part < nb_parts) {
+                        grobs[part] = serialize_grob_read_header(
+                            in, shader_properties[part]
+                        );
+                        if(grobs[part] != nullptr) {
+                            Box3d B = extract_bbox(grobs[part]->attributes());
+                            if(lazy) {
+                                grobs[part]->set_lazy_source(
+                                    filename, part, B
+                                );
+                            }
+                        }
+                        ++part;
+                    }
+                }
+            } catch(const std::logic_error& e) {
+                Logger::err("GeoFile") << "Caught exception: " << e.what()
+                                       << std::endl;
+                ok = false;
+            }
+        }
+
+        if(header_filename != filename &&
+           FileSystem::is_file(header_filename)) {
+            FileSystem::delete_file(header_filename);
+        }
+
+        //   The Logger is not thread-safe: errors are stored per part
+        // and reported once all the parts are read.
+        std::vector<std::string> part_error(nb_parts);
+
+        auto read_part = [&](index_t i) {
+            std::string part_filename =
+                GraphiteFileIndex::part_filename(filename,i);
+            if(!index.extract_part(i, part_filename)) {
+                ok = false;
+                return;
+            }
+            grobs[i]->disable_signals();
+            try {
+                InputGraphiteFile in(part_filename);
+                while(
+                    in.current_chunk_class() != "SHDR" &&
+                    in.current_chunk_class() != "EOFL"
+                ) {
+                    in.next_chunk();
+                }
+                if(!grobs[i]->serialize_read(in)) {
+                    ok = false;
+                }
+            } catch(const std::logic_error& e) {
+                part_error[i] = e.what();
+                ok = false;
+            }
+            grobs[i]->enable_signals();
+            FileSystem::delete_file(part_filename);
+        };
+
+        auto read_part_with_header = [&](index_t i) {
+            std::string part_filename =
+                GraphiteFileIndex::part_filename(filename,i);
+            if(!index.extract_part(i, part_filename)) {
+                ok = false;
+                return;
+            }
+            try {
+                InputGraphiteFile in(part_filename);
+                while(
+                    in.current_chunk_class() != "GROB" &&
+                    in.current_chunk_class() != "EOFL"
+                ) {
+                    in.next_chunk();
+                }
+                if(in.current_chunk_class() == "GROB") {
+                    grobs[i] = serialize_grob_read_header(
+                        in, shader_properties[i]
+                    );
+                }
+                if(grobs[i] != nullptr) {
+                    grobs[i]->disable_signals();
+                    if(!grobs[i]->serialize_read(in)) {
+                        ok = false;
+                    }
+                    grobs[i]->enable_signals();
+                }
+            } catch(const std::logic_error& e) {
+                part_error[i] = e.what();
+                ok = false;
+            }
+            FileSystem::delete_file(part_filename);
+        };
+
+        if(ok && index.version() < 2) {
+            for(index_t i=1; i<nb_parts; ++i) {
+                read_part_with_header(i);
+            }
+        } else if(!lazy) {
+            for(index_t i=1; i<nb_parts; ++i) {
+                if(
+                    grobs[i] != nullptr &&
+                    !grobs[i]->supports_concurrent_serialization()
+                ) {
+                    read_part(i);
+                }
+            }
+
+            parallel_for(
+                1, nb_parts,
+                [&](index_t i) {
+                    if(
+                        grobs[i] != nullptr &&
+                        grobs[i]->supports_concurrent_serialization()
+                    ) {
+                        read_part(i);
+                    }
+                }
+            );
+        }
+
+        for(index_t i=1; i<nb_parts; ++i) {
+            if(part_error[i] != "") {
+                Logger::err("GeoFile") << "Caught exception: "
+                                       << part_error[i] << std::endl;
+            }
+        }
+
+        if(!ok) {
+            Logger::err("GeoFile") << "Could not load " << filename
+                                   << std::endl;
+        }
+
+        set_signals_enabled(signals_enabled);
+
+        // Creates the shader managers of the new objects
+        update_values();
+
+        Grob* grob = nullptr;
+        for(index_t i=1; i<nb_parts; ++i) {
+            if(grobs[i] != nullptr) {
+                grob = grobs[i];
+                serialize_grob_read_shader(grob, shader_properties[i]);
+            }
+        }
+
+        if(current_object != "" && is_bound(current_object)) {
+            set_current_object(current_object);
+            grob = current();
+        } else if(grob != nullptr) {
+            set_current_object(grob->name());
+        }
+
+        if(grob != nullptr) {
+            grob->update();
+        }
+
+        Logger::out("GeoFile") << ">> EOF (" << nb_parts
+                               << " indexed parts"
+                               << (lazy ? ", lazy" : "") << ")"
+                               << std::endl;
+        return ok;
+    }
+
     /************************************************************************/
 
+    index_t SceneGraph::materialize_requested_objects() {
+        index_t result = 0;
+        for(index_t i=0; i<get_nb_children(); ++i) {
+            Grob* grob = ith_child(i);
+            if(grob->materialize_requested()) {
+                grob->materialize();
+                ++result;
+            }
+        }
+        return result;
+    }
+
     void SceneGraph::update_values() {
         values_changed(get_values());
         value_changed(this);
@@ -850,39 +1449,44 @@ namespace OGF {
         Logger::out("GeoFile") << "<< EOF" << std::endl;
     }
 
+    void SceneGraph::get_grob_header(Grob* grob, ArgList& args) {
+        args = grob->attributes();
+        args.create_arg("class_name", grob->meta_class()->name());
+        args.create_arg("name", grob->name());
+    }
+
+    void SceneGraph::get_grob_shader_header(Grob* grob, ArgList& args) {
+        std::string shader_class_name;
+        get_grob_shader(grob, shader_class_name, args);
+        if(shader_class_name != "") {
+            args.create_arg("class_name", shader_class_name);
+            args.create_arg(
+                "visible", grob->get_visible() ? "true" : "false"
+            );
+        }
+    }
+
     void SceneGraph::serialize_grob_write(
         Grob* grob, OutputGraphiteFile& out
     ) {
-        std::string classname = grob->meta_class()->name();
-
         if(grob->is_serializable()) {
             Logger::out("GeoFile")
                 << "<< " << grob->name()
                 << " (" << grob->meta_class()->name() << ")" << std::endl;
 
+            grob->materialize();
+
             // Grob header
             {
-                ArgList grob_properties = grob->attributes();
-                grob_properties.create_arg(
-                    "class_name", grob->meta_class()->name()
-                );
-                grob_properties.create_arg("name", grob->name());
+                ArgList grob_properties;
+                get_grob_header(grob, grob_properties);
                 out.write_grob_header(grob_properties);
             }
 
             // Shader
             {
-                std::string shader_class_name;
                 ArgList shader_properties;
-                get_grob_shader(grob, shader_class_name, shader_properties);
-                if(shader_class_name != "") {
-                    shader_properties.create_arg(
-                        "class_name", shader_class_name
-                    );
-                    shader_properties.create_arg(
-                        "visible", grob->get_visible() ? "true" : "false"
-                    );
-                }
+                get_grob_shader_header(grob, shader_properties);
                 out.write_shader(shader_properties);
             }
             grob->serialize_write(out);
@@ -896,6 +1500,20 @@ namespace OGF {
 
     Grob* SceneGraph::serialize_grob_read(
         InputGraphiteFile& in
+    ) {
+        ArgList shader_properties;
+        Grob* result = serialize_grob_read_header(in, shader_properties);
+        if(result != nullptr) {
+            result->serialize_read(in);
+            update_values();
+            set_current_object(result->name());
+            serialize_grob_read_shader(result, shader_properties);
+        }
+        return result;
+    }
+
+    Grob* SceneGraph::serialize_grob_read_header(
+        InputGraphiteFile& in, ArgList& shader_properties
     ) {
         Grob* result = nullptr;
 
@@ -916,6 +1534,7 @@ namespace OGF {
         Logger::out("GeoFile")
             << ">> " << grob_name
             << " (" << grob_class_name << ")" << std::endl;
+        bool signals_enabled = get_signals_enabled();
         disable_signals();
         result = create_object(grob_class_name);
 
@@ -930,8 +1549,10 @@ namespace OGF {
             grob_properties.delete_ith_arg(i);
         }
 
-        result->attributes() = grob_properties;
-        enable_signals();
+        if(result != nullptr) {
+            result->attributes() = grob_properties;
+        }
+        set_signals_enabled(signals_enabled);
 
         in.next_chunk();
         if(in.current_chunk_class() != "SHDR") {
@@ -944,30 +1565,30 @@ namespace OGF {
             return nullptr;
         }
 
-        ArgList shader_properties;
         in.read_shader(shader_properties);
 
+        if(result != nullptr) {
+            result->rename(grob_name);
+        }
+        return result;
+    }
+
+    void SceneGraph::serialize_grob_read_shader(
+        Grob* grob, const ArgList& shader_properties
+    ) {
         bool visible = true;
         if(shader_properties.has_arg("visible")) {
             visible = (shader_properties.get_arg("visible") == "true");
         }
+        grob->set_visible(visible);
 
-        if(result != nullptr) {
-            result->rename(grob_name);
-            result->serialize_read(in);
-            result->set_visible(visible);
-            update_values();
-            set_current_object(result->name());
-
-            std::string shader_class_name;
-            if(shader_properties.has_arg("class_name")) {
-                shader_class_name = shader_properties.get_arg("class_name");
-            }
-            if(shader_class_name != "") {
-                set_grob_shader(result, shader_class_name, shader_properties);
-            }
+        std::string shader_class_name;
+        if(shader_properties.has_arg("class_name")) {
+            shader_class_name = shader_properties.get_arg("class_name");
+        }
+        if(shader_class_name != "") {
+            set_grob_shader(grob, shader_class_name, shader_properties);
         }
-        return result;
     }
 
     void SceneGraph::copy_property_to_arglist(
@@ -414,6 +414,14 @@ namespace OGF {
          */
         void update_values();
 
+        /**
+         * \brief Reads the lazy objects that need to be drawn.
+         * \details Called by the application after each frame.
+         * \return the number of objects that were read
+         * \see Grob::request_materialize()
+         */
+        index_t materialize_requested_objects();
+
         /**
          * \copydoc Grob::is_serializable()
          */
@@ -429,6 +437,15 @@ namespace OGF {
          */
 	 bool serialize_write(OutputGraphiteFile& out) override;
 
+        /**
+         * \copydoc Grob::save()
+         * \details If the gui:indexed_graphite preference is set, the
+         *  scene graph is saved to a chunk-indexed graphite file, where
+         *  the grobs are encoded in parallel.
+         * \see GraphiteFileIndex
+         */
+        bool save(const NewFileName& filename) override;
+
 	/**
 	 * \copydoc Grob::interpreter()
 	 */
@@ -467,6 +484,20 @@ namespace OGF {
             const ArgList& args, Any& ret_val
         ) override;
 
+        /**
+         * \copydoc Object::invoke_method_positional
+         * \details Routed through invoke_method(), so that positional
+         *  calls are also recorded in the history.
+         */
+        bool invoke_method_positional(
+            MetaMethod* method, const Any* const* args, index_t nb_args,
+            Any& ret_val
+        ) override {
+            return invoke_method_positional_by_name(
+                method, args, nb_args, ret_val
+            );
+        }
+
     protected:
         /**
          * \brief Loads alignment data for pointsets.
@@ -506,6 +537,22 @@ namespace OGF {
             Grob* grob, OutputGraphiteFile& out
         );
 
+        /**
+         * \brief Gets the ArgList stored in the GROB chunk of an object.
+         * \param[in] grob a pointer to the object
+         * \param[out] args the attributes, class name and name of the
+         *  object
+         */
+        void get_grob_header(Grob* grob, ArgList& args);
+
+        /**
+         * \brief Gets the ArgList stored in the SHDR chunk of an object.
+         * \param[in] grob a pointer to the object
+         * \param[out] args the class name and properties of the shader
+         *  attached to the object, and its visibility flag
+         */
+        void get_grob_shader_header(Grob* grob, ArgList& args);
+
         /**
          * \brief Reads an object from a geogram file.
          * \param[in,out] in the stream
@@ -515,6 +562,75 @@ namespace OGF {
             InputGraphiteFile& in
         );
 
+        /**
+         * \brief Reads the GROB and SHDR chunks of an object from a
+         *  geogram file and creates the object.
+         * \param[in,out] in the stream
+         * \param[out] shader_properties the ArgList stored in the SHDR
+         *  chunk, to be used by serialize_grob_read_shader()
+         * \return a pointer to the created object or nullptr if the
+         *  object could not be created
+         */
+        Grob* serialize_grob_read_header(
+            InputGraphiteFile& in, ArgList& shader_properties
+        );
+
+        /**
+         * \brief Restores the visibility and the shader of an object
+         *  read from a geogram file.
+         * \param[in] grob a pointer to the object
+         * \param[in] shader_properties the ArgList stored in the
+         *  SHDR chunk
+         * \pre update_values() was called after the creation of the
+         *  object (so that it has a shader manager)
+         */
+        void serialize_grob_read_shader(
+            Grob* grob, const ArgList& shader_properties
+        );
+
+        /**
+         * \brief Writes the scene graph to a chunk-indexed graphite file.
+         * \details The grobs that support concurrent serialization are
+         *  encoded in parallel.
+         * \param[in] filename the name of the file
+         * \retval true on success
+         * \retval false otherwise
+         * \see GraphiteFileIndex, Grob::supports_concurrent_serialization()
+         */
+        bool serialize_write_indexed(const std::string& filename);
+
+        /**
+         * \brief Loads a batch of objects.
+         * \details The objects are created serially, then the files are
+         *  parsed in parallel for the objects that support concurrent
+         *  serialization, while the scene graph signals are disabled.
+         *  The objects are then attached with a single update_values().
+         *  Per-file timings and total throughput are displayed.
+         * \param[in] file_names the names of the files to be loaded. The
+         *  class of each object is deduced from the file extension. If
+         *  a file cannot be loaded, the other classes associated with
+         *  its extension are tried, and it is reported if none works.
+         * \param[in] change_cwd if true, the current working directory is
+         *  changed to the directory of the last file, as load_object()
+         *  does.
+         * \see Grob::supports_concurrent_serialization()
+         */
+        void load_objects_batch(
+            const std::vector<std::string>& file_names, bool change_cwd
+        );
+
+        /**
+         * \brief Reads the objects of a chunk-indexed graphite file.
+         * \details The grobs that support concurrent serialization are
+         *  decoded in parallel. Only object creation, shader creation
+         *  and signal emission are done serially.
+         * \param[in] filename the name of the file
+         * \retval true on success
+         * \retval false otherwise
+         * \see GraphiteFileIndex, Grob::supports_concurrent_serialization()
+         */
+        bool serialize_read_indexed(const std::string& filename);
+
 	void get_grob_shader(
 	    Grob* grob, std::string& classname, ArgList& properties
 	);
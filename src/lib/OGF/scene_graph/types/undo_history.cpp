@@ -0,0 +1,241 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#include <OGF/scene_graph/types/undo_history.h>
+#include <OGF/scene_graph/types/scene_graph.h>
+#include <OGF/gom/reflection/meta_class.h>
+
+#include <geogram/basic/stopwatch.h>
+
+#include <set>
+#include <algorithm>
+
+namespace OGF {
+
+    UndoHistory::UndoHistory(index_t nb_slots) :
+        states_(nb_slots),
+        age_(0),
+        memory_budget_(size_t(1024)*size_t(1024)*size_t(1024)) {
+    }
+
+    UndoHistory::~UndoHistory() {
+        clear();
+    }
+
+    void UndoHistory::clear() {
+        for(State& S: states_) {
+            S = State();
+        }
+        latest_.clear();
+    }
+
+    GrobSnapshot* UndoHistory::snapshot(Grob* grob, bool& copied) {
+        copied = false;
+        auto it = latest_.find(grob);
+        if(it != latest_.end() && it->second->is_up_to_date(grob)) {
+            return it->second;
+        }
+        GrobSnapshot* result = grob->create_snapshot();
+        if(result == nullptr) {
+            Logger::warn("Undo") << "Could not save " << grob->name()
+                                 << " (" << grob->meta_class()->name() << ")"
+                                 << std::endl;
+            latest_.erase(grob);
+            return nullptr;
+        }
+        copied = true;
+        latest_[grob] = result;
+        return result;
+    }
+
+    void UndoHistory::save(index_t slot, SceneGraph* sg) {
+        geo_assert(slot < states_.size());
+        Stopwatch W("Undo",false);
+
+        State& S = states_[slot];
+        S = State();
+        S.valid = true;
+        S.age = ++age_;
+        if(sg->current() != nullptr) {
+            S.current_object = sg->current()->name();
+        }
+
+        index_t nb_copied = 0;
+        std::set<const Grob*> grobs;
+        for(index_t i=0; i<sg->get_nb_children(); ++i) {
+            Grob* grob = sg->ith_child(i);
+            grobs.insert(grob);
+            bool copied = false;
+            GrobSnapshot* snap = snapshot(grob, copied);
+            if(snap != nullptr) {
+                S.grobs.push_back(snap);
+                if(copied) {
+                    ++nb_copied;
+                }
+            }
+        }
+
+        // Forget the deleted objects (their snapshots stay
+        // in the states that reference them).
+        for(auto it = latest_.begin(); it != latest_.end(); ) {
+            if(grobs.find(it->first) == grobs.end()) {
+                it = latest_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        enforce_memory_budget();
+
+        Logger::out("Undo") << "Saved state: " << nb_copied << "/"
+                            << S.grobs.size() << " object(s) copied in "
+                            << W.elapsed_time() << "s" << std::endl;
+    }
+
+    bool UndoHistory::restore(index_t slot, SceneGraph* sg) {
+        geo_assert(slot < states_.size());
+        State& S = states_[slot];
+        if(!S.valid) {
+            Logger::err("Undo") << "No saved state to restore" << std::endl;
+            return false;
+        }
+
+        Stopwatch W("Undo",false);
+
+        // Delete the objects that did not exist in the saved state
+        std::set<std::string> names;
+        for(const GrobSnapshot_var& snap: S.grobs) {
+            names.insert(snap->grob_name());
+        }
+        std::vector<std::string> to_delete;
+        for(index_t i=0; i<sg->get_nb_children(); ++i) {
+            Grob* grob = sg->ith_child(i);
+            if(names.find(grob->name()) == names.end()) {
+                to_delete.push_back(grob->name());
+            }
+        }
+        for(const std::string& name: to_delete) {
+            sg->delete_object(name);
+        }
+
+        // Copy back the objects that differ from their snapshot,
+        // re-create the deleted ones.
+        index_t nb_restored = 0;
+        bool result = true;
+        for(const GrobSnapshot_var& snap: S.grobs) {
+            Grob* grob = Grob::find(sg, snap->grob_name());
+            if(
+                grob != nullptr &&
+                grob->meta_class()->name() != snap->grob_class_name()
+            ) {
+                sg->delete_object(snap->grob_name());
+                grob = nullptr;
+            }
+            if(grob == nullptr) {
+                grob = sg->create_object(
+                    snap->grob_class_name(), snap->grob_name()
+                );
+                if(grob == nullptr) {
+                    result = false;
+                    continue;
+                }
+            } else if(snap->is_up_to_date(grob)) {
+                latest_[grob] = snap;
+                continue;
+            }
+            if(!snap->restore(grob)) {
+                result = false;
+            }
+            latest_[grob] = snap;
+            ++nb_restored;
+        }
+
+        if(S.current_object != "" && sg->is_bound(S.current_object)) {
+            sg->set_current_object(S.current_object);
+        }
+        sg->update_values();
+
+        Logger::out("Undo") << "Restored state: " << nb_restored << "/"
+                            << S.grobs.size() << " object(s) copied in "
+                            << W.elapsed_time() << "s" << std::endl;
+        return result;
+    }
+
+    void UndoHistory::enforce_memory_budget() {
+        //   Each snapshot is associated with the most recent state that
+        // references it. Snapshots of the oldest states are spilled first.
+        std::map<GrobSnapshot*, index_t> snapshot_age;
+        for(const State& S: states_) {
+            if(!S.valid) {
+                continue;
+            }
+            for(const GrobSnapshot_var& snap: S.grobs) {
+                index_t& age = snapshot_age[snap];
+                age = std::max(age, S.age);
+            }
+        }
+
+        size_t total = 0;
+        std::vector<std::pair<index_t, GrobSnapshot*> > in_memory;
+        for(auto& it: snapshot_age) {
+            size_t size = it.first->memory_size();
+            if(size != 0) {
+                total += size;
+                in_memory.push_back(std::make_pair(it.second, it.first));
+            }
+        }
+        if(total <= memory_budget_) {
+            return;
+        }
+
+        std::sort(in_memory.begin(), in_memory.end());
+        Stopwatch W("Undo",false);
+        index_t nb_spilled = 0;
+        for(auto& it: in_memory) {
+            if(total <= memory_budget_) {
+                break;
+            }
+            size_t size = it.second->memory_size();
+            if(it.second->spill()) {
+                total -= size;
+                ++nb_spilled;
+            }
+        }
+        Logger::out("Undo") << "Memory budget exceeded, moved "
+                            << nb_spilled << " snapshot(s) to disk in "
+                            << W.elapsed_time() << "s" << std::endl;
+    }
+}
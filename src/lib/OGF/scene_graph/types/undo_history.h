@@ -0,0 +1,157 @@
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000 Bruno Levy
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     levy@loria.fr
+ *
+ *     ISA Project
+ *     LORIA, INRIA Lorraine,
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs.
+ */
+
+#ifndef H_OGF_SCENE_GRAPH_TYPES_UNDO_HISTORY_H
+#define H_OGF_SCENE_GRAPH_TYPES_UNDO_HISTORY_H
+
+#include <OGF/scene_graph/common/common.h>
+#include <OGF/scene_graph/grob/grob_snapshot.h>
+
+#include <map>
+
+/**
+ * \file OGF/scene_graph/types/undo_history.h
+ * \brief Saved states of the scene graph, used by undo / redo.
+ */
+
+namespace OGF {
+
+    class SceneGraph;
+    class Grob;
+
+    /**
+     * \brief Saved states of the scene graph, used by undo / redo.
+     * \details Each state stores a GrobSnapshot per object. Grobs that
+     *  were not modified between two saved states share the same
+     *  snapshot (see GrobSnapshot::is_up_to_date()), so that saving
+     *  a state only copies the objects modified by the latest command,
+     *  and restoring a state only copies the objects that differ.
+     *  When the snapshots use more memory than the budget, the oldest
+     *  ones are moved to files.
+     * \see GrobSnapshot::is_up_to_date(), Grob::create_snapshot()
+     */
+    class SCENE_GRAPH_API UndoHistory {
+    public:
+        /**
+         * \brief UndoHistory constructor.
+         * \param[in] nb_slots maximum number of saved states
+         */
+        UndoHistory(index_t nb_slots);
+
+        /**
+         * \brief UndoHistory destructor.
+         */
+        ~UndoHistory();
+
+        /**
+         * \brief Forbids copy.
+         */
+        UndoHistory(const UndoHistory& rhs) = delete;
+
+        /**
+         * \brief Forbids copy.
+         */
+        UndoHistory& operator=(const UndoHistory& rhs) = delete;
+
+        /**
+         * \brief Sets the maximum memory used by the snapshots.
+         * \param[in] nb_bytes the memory budget, in bytes
+         */
+        void set_memory_budget(size_t nb_bytes) {
+            memory_budget_ = nb_bytes;
+        }
+
+        /**
+         * \brief Saves the state of a scene graph.
+         * \param[in] slot the index of the state, in 0..nb_slots-1.
+         *  The previous state stored in this slot is discarded.
+         * \param[in] sg a pointer to the SceneGraph
+         */
+        void save(index_t slot, SceneGraph* sg);
+
+        /**
+         * \brief Restores a saved state of a scene graph.
+         * \param[in] slot the index of the state, in 0..nb_slots-1
+         * \param[in] sg a pointer to the SceneGraph
+         * \retval true if the state could be restored
+         * \retval false otherwise
+         */
+        bool restore(index_t slot, SceneGraph* sg);
+
+        /**
+         * \brief Discards all the saved states.
+         */
+        void clear();
+
+    protected:
+        /**
+         * \brief Gets a snapshot of a Grob.
+         * \details Reuses the latest snapshot of the Grob if it was
+         *  not modified since then, else creates a new one.
+         * \param[in] grob a pointer to the Grob
+         * \param[out] copied true if a new snapshot was created
+         * \return a pointer to the snapshot or nullptr if the Grob
+         *  cannot be saved
+         */
+        GrobSnapshot* snapshot(Grob* grob, bool& copied);
+
+        /**
+         * \brief Moves the oldest snapshots to files until the memory
+         *  used by the snapshots fits in the budget.
+         */
+        void enforce_memory_budget();
+
+        /**
+         * \brief A saved state of the scene graph.
+         */
+        struct State {
+            State() : valid(false), age(0) {
+            }
+            bool valid;
+            index_t age;
+            vector<GrobSnapshot_var> grobs;
+            std::string current_object;
+        };
+
+    private:
+        vector<State> states_;
+        std::map<const Grob*, GrobSnapshot_var> latest_;
+        index_t age_;
+        size_t memory_budget_;
+    };
+}
+
+#endif
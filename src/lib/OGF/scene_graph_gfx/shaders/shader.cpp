@@ -60,6 +60,14 @@ namespace OGF {
         grob_(grob),
         no_grob_update_(false),
 	transparency_(TRANSP_OPAQUE) {
+        // Zero viewport means that transforms were not captured yet
+        for(index_t i=0; i<16; ++i) {
+            modelview_[i] = 0.0;
+            project_[i] = 0.0;
+        }
+        for(index_t i=0; i<4; ++i) {
+            viewport_[i] = 0;
+        }
     }
 
     Shader::~Shader() {
@@ -106,6 +106,12 @@ namespace OGF {
 	if(grob() == nullptr || grob()->nb_graphics_locks_ > 0) {
 	    return;
 	}
+	// Lazy objects are read after the frame (reading them here would
+	// emit signals in the middle of the draw pass).
+	if(grob()->is_lazy()) {
+	    grob()->request_materialize();
+	    return;
+	}
         if(current_shader_ == nullptr) {
 	    return;
 	}
@@ -39,8 +39,54 @@
 #include <OGF/scene_graph/types/scene_graph.h>
 
 #include <geogram/mesh/mesh_AABB.h>
+#include <geogram/basic/geometry_nd.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/process.h>
+
+#include <atomic>
+#include <algorithm>
 #include <geogram/third_party/PoissonRecon/poisson_geogram.h>
 
+namespace {
+    using namespace OGF;
+
+    /**
+     * \brief Computes the squared distance between a point
+     *  and a triangle.
+     * \param[in] p the point
+     * \param[in] T a pointer to the three vertices of the triangle
+     * \return the squared distance between \p p and \p T
+     */
+    inline double point_triangle_sq_dist(const vec3& p, const vec3* T) {
+        vec3 closest;
+        double l0, l1, l2;
+        return Geom::point_triangle_squared_distance(
+            p, T[0], T[1], T[2], closest, l0, l1, l2
+        );
+    }
+
+    /**
+     * \brief Clamps a range of grid coordinates.
+     * \param[in] lo , hi the range, as floating point grid coordinates
+     * \param[in] n the number of voxels along the axis
+     * \param[out] imin , imax the range of voxel indices. If empty, then
+     *  imin > imax.
+     */
+    inline void clamp_range(
+        double lo, double hi, index_t n, index_t& imin, index_t& imax
+    ) {
+        double flo = ::floor(lo);
+        double fhi = ::ceil(hi);
+        if(fhi < 0.0 || flo > double(n) - 1.0) {
+            imin = 1;
+            imax = 0;
+            return;
+        }
+        imin = index_t(std::max(flo, 0.0));
+        imax = index_t(std::min(fhi, double(n) - 1.0));
+    }
+}
+
 namespace OGF {
 
     VoxelGrobAttributesCommands::VoxelGrobAttributesCommands() {
@@ -151,7 +197,7 @@ namespace OGF {
 	double su = 1.0 / double(voxel_grob()->nu());
 	double sv = 1.0 / double(voxel_grob()->nv());
 	double sw = 1.0 / double(voxel_grob()->nw());
-        MeshFacetsAABB AABB(*surface);
+        std::shared_ptr<const MeshFacetsAABB> AABB = surface->facets_AABB();
 
         {
 #if defined(_OPENMP)
@@ -167,7 +213,7 @@ namespace OGF {
                             uf * voxel_grob()->U() +
                             vf * voxel_grob()->V() +
                             wf * voxel_grob()->W() ;
-                        double d = AABB.squared_distance(p);
+                        double d = AABB->squared_distance(p);
                         distance[voxel_grob()->linear_index(u,v,w)] =
                             float(::sqrt(d));
                     }
@@ -192,7 +238,7 @@ namespace OGF {
 			    uf * voxel_grob()->U() +
 			    vf * voxel_grob()->V() +
 			    wf * voxel_grob()->W() ;
-			if(AABB.contains(p)) {
+			if(AABB->contains(p)) {
 			    distance[voxel_grob()->linear_index(u,v,w)]
 				*= -1.0f;
 			}
@@ -206,7 +252,7 @@ namespace OGF {
 
     // Using cells is probably faster (to be tested)
     if(signed_dist && surface->cells.nb() != 0) {
-	MeshCellsAABB cAABB(*surface);
+	std::shared_ptr<const MeshCellsAABB> cAABB = surface->cells_AABB();
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -220,7 +266,7 @@ namespace OGF {
 			uf * voxel_grob()->U() +
 			vf * voxel_grob()->V() +
 			wf * voxel_grob()->W() ;
-		    index_t tet = cAABB.containing_tet(p);
+		    index_t tet = cAABB->containing_tet(p);
 		    if(tet != MeshCellsAABB::NO_TET) {
 			distance[voxel_grob()->linear_index(u,v,w)]*=-1.0f;
 		    }
@@ -233,6 +279,335 @@ namespace OGF {
 
 
 
+    void VoxelGrobAttributesCommands::compute_narrow_band_distance_to_surface(
+        const MeshGrobName& surface_name, const std::string& attribute_name,
+        bool signed_dist, index_t band, bool compare
+    ) {
+        MeshGrob* surface = MeshGrob::find(scene_graph(), surface_name);
+        if(surface == nullptr) {
+            Logger::err("VoxelGrob") << surface_name << " : no such MeshGrob"
+                                     << std::endl;
+            return;
+        }
+        if(surface->facets.nb() == 0) {
+            Logger::err("VoxelGrob") << surface_name << " : has no facet"
+                                     << std::endl;
+            return;
+        }
+
+        VoxelGrob* grid = voxel_grob();
+        index_t n[3] = { grid->nu(), grid->nv(), grid->nw() };
+        index_t nuvw = n[0]*n[1]*n[2];
+        if(nuvw == 0) {
+            return;
+        }
+
+        Stopwatch W("Distance",false);
+
+        // Grid coordinates: the center of voxel (u,v,w) is at (u,v,w).
+        // They are computed with the dual basis of (U,V,W), so that
+        // boxes with non-orthogonal axes are also supported.
+        vec3 O = grid->origin();
+        vec3 U = grid->U();
+        vec3 V = grid->V();
+        vec3 Wax = grid->W();
+        double det = dot(U, cross(V,Wax));
+        if(::fabs(det) < 1e-30) {
+            Logger::err("VoxelGrob") << "degenerate box" << std::endl;
+            return;
+        }
+        vec3 dual[3] = {
+            (double(n[0])/det) * cross(V,Wax),
+            (double(n[1])/det) * cross(Wax,U),
+            (double(n[2])/det) * cross(U,V)
+        };
+        vec3 step[3] = {
+            (1.0/double(n[0])) * U,
+            (1.0/double(n[1])) * V,
+            (1.0/double(n[2])) * Wax
+        };
+
+        auto voxel_center = [&](index_t u, index_t v, index_t w)->vec3 {
+            return O +
+                (double(u) + 0.5) * step[0] +
+                (double(v) + 0.5) * step[1] +
+                (double(w) + 0.5) * step[2] ;
+        };
+
+        // Width of the band along each axis, in voxels
+        double h[3] = {
+            length(step[0]), length(step[1]), length(step[2])
+        };
+        double hmax = std::max(h[0], std::max(h[1], h[2]));
+        double band_width[3];
+        for(index_t c=0; c<3; ++c) {
+            band_width[c] = double(std::max(band, index_t(1))) * hmax / h[c];
+        }
+
+        // Triangulate the facets (as fans), and get the range of voxels
+        // covered by the bounding box of each triangle enlarged by the
+        // band width. Triangles are binned in W slabs.
+        vector<vec3> triangles;
+        vector<vec3> grid_triangles;
+        for(index_t f: surface->facets) {
+            index_t v0 = surface->facets.vertex(f,0);
+            for(index_t lv=1; lv+1<surface->facets.nb_vertices(f); ++lv) {
+                index_t v1 = surface->facets.vertex(f,lv);
+                index_t v2 = surface->facets.vertex(f,lv+1);
+                triangles.push_back(vec3(surface->vertices.point_ptr(v0)));
+                triangles.push_back(vec3(surface->vertices.point_ptr(v1)));
+                triangles.push_back(vec3(surface->vertices.point_ptr(v2)));
+            }
+        }
+        index_t nt = index_t(triangles.size() / 3);
+        grid_triangles.resize(triangles.size());
+        vector<index_t> tri_range(6*nt);
+        for(index_t t=0; t<nt; ++t) {
+            for(index_t c=0; c<3; ++c) {
+                double lo = Numeric::max_float64();
+                double hi = -Numeric::max_float64();
+                for(index_t lv=0; lv<3; ++lv) {
+                    double x = dot(triangles[3*t+lv] - O, dual[c]) - 0.5;
+                    grid_triangles[3*t+lv][c] = x;
+                    lo = std::min(lo, x);
+                    hi = std::max(hi, x);
+                }
+                clamp_range(
+                    lo - band_width[c], hi + band_width[c], n[c],
+                    tri_range[6*t+2*c], tri_range[6*t+2*c+1]
+                );
+            }
+        }
+
+        // Note: in signed mode, triangles that are outside the grid along
+        // U are kept, because they are needed by the scanlines that
+        // compute the sign.
+        vector<vector<index_t> > slab(n[2]);
+        for(index_t t=0; t<nt; ++t) {
+            if(tri_range[6*t+2] > tri_range[6*t+3]) {
+                continue;
+            }
+            if(!signed_dist && tri_range[6*t] > tri_range[6*t+1]) {
+                continue;
+            }
+            for(index_t w=tri_range[6*t+4]; w<=tri_range[6*t+5]; ++w) {
+                slab[w].push_back(t);
+            }
+        }
+
+        Attribute<float> distance(grid->attributes(), attribute_name);
+        vector<index_t> nearest(nuvw, NO_INDEX);
+        for(index_t i=0; i<nuvw; ++i) {
+            distance[i] = Numeric::max_float32();
+        }
+
+        // Step 1: exact (squared) distances in the narrow band.
+        // Each thread processes a W slab, so there is no conflict.
+        parallel_for(
+            0, n[2],
+            [&](index_t w) {
+                for(index_t t: slab[w]) {
+                    const index_t* R = &tri_range[6*t];
+                    for(index_t v=R[2]; v<=R[3]; ++v) {
+                        for(index_t u=R[0]; u<=R[1]; ++u) {
+                            index_t i = grid->linear_index(u,v,w);
+                            double d = point_triangle_sq_dist(
+                                voxel_center(u,v,w), &triangles[3*t]
+                            );
+                            if(d < double(distance[i])) {
+                                distance[i] = float(d);
+                                nearest[i] = t;
+                            }
+                        }
+                    }
+                }
+            }
+        );
+
+        bool has_band = false;
+        for(index_t i=0; i<nuvw; ++i) {
+            if(nearest[i] != NO_INDEX) {
+                has_band = true;
+                break;
+            }
+        }
+        if(!has_band) {
+            Logger::warn("VoxelGrob")
+                << "surface does not intersect the narrow band,"
+                << " using compute_distance_to_surface()"
+                << std::endl;
+            compute_distance_to_surface(
+                surface_name, attribute_name, signed_dist
+            );
+            return;
+        }
+
+        // Step 2: propagate the nearest triangles to the other voxels,
+        // with forward and backward sweeps along each axis. All the
+        // lines along an axis are independent and processed in parallel.
+        // Iterate until nothing changes.
+        auto relax = [&](index_t i, index_t j, const vec3& p)->bool {
+            index_t t = nearest[j];
+            if(t == NO_INDEX || t == nearest[i]) {
+                return false;
+            }
+            double d = point_triangle_sq_dist(p, &triangles[3*t]);
+            if(d < double(distance[i])) {
+                distance[i] = float(d);
+                nearest[i] = t;
+                return true;
+            }
+            return false;
+        };
+
+        index_t nb_rounds = 0;
+        bool changed = true;
+        while(changed && nb_rounds < 10) {
+            changed = false;
+            for(index_t axis=0; axis<3; ++axis) {
+                index_t a1 = (axis+1)%3;
+                index_t a2 = (axis+2)%3;
+                std::atomic<bool> axis_changed(false);
+                parallel_for(
+                    0, n[a1]*n[a2],
+                    [&](index_t line) {
+                        index_t c[3];
+                        c[a1] = line % n[a1];
+                        c[a2] = line / n[a1];
+                        bool line_changed = false;
+                        index_t prev = NO_INDEX;
+                        for(index_t k=0; k<n[axis]; ++k) {
+                            c[axis] = k;
+                            index_t i = grid->linear_index(c[0],c[1],c[2]);
+                            if(prev != NO_INDEX) {
+                                line_changed = relax(
+                                    i, prev, voxel_center(c[0],c[1],c[2])
+                                ) || line_changed;
+                            }
+                            prev = i;
+                        }
+                        prev = NO_INDEX;
+                        for(index_t k=n[axis]; k>0; --k) {
+                            c[axis] = k-1;
+                            index_t i = grid->linear_index(c[0],c[1],c[2]);
+                            if(prev != NO_INDEX) {
+                                line_changed = relax(
+                                    i, prev, voxel_center(c[0],c[1],c[2])
+                                ) || line_changed;
+                            }
+                            prev = i;
+                        }
+                        if(line_changed) {
+                            axis_changed = true;
+                        }
+                    }
+                );
+                changed = changed || axis_changed;
+            }
+            ++nb_rounds;
+        }
+
+        // Step 3: square roots, and (in signed mode) sign from the parity
+        // of the number of intersections between the scanlines along U
+        // and the surface.
+        // Scanlines are slightly shifted to avoid hitting edges exactly.
+        const double eps_v = 1.2345678e-5;
+        const double eps_w = 2.3456789e-5;
+        parallel_for(
+            0, n[2],
+            [&](index_t w) {
+                std::vector<double> crossings;
+                for(index_t v=0; v<n[1]; ++v) {
+                    crossings.resize(0);
+                    if(signed_dist) {
+                        double py = double(v) + eps_v;
+                        double pz = double(w) + eps_w;
+                        for(index_t t: slab[w]) {
+                            if(v < tri_range[6*t+2] || v > tri_range[6*t+3]) {
+                                continue;
+                            }
+                            const vec3& a = grid_triangles[3*t];
+                            const vec3& b = grid_triangles[3*t+1];
+                            const vec3& c = grid_triangles[3*t+2];
+                            double d = (b.y-a.y)*(c.z-a.z)-(c.y-a.y)*(b.z-a.z);
+                            if(d == 0.0) {
+                                continue;
+                            }
+                            double la = (
+                                (b.y-py)*(c.z-pz)-(c.y-py)*(b.z-pz)
+                            ) / d;
+                            double lb = (
+                                (c.y-py)*(a.z-pz)-(a.y-py)*(c.z-pz)
+                            ) / d;
+                            double lc = 1.0 - la - lb;
+                            if(la < 0.0 || lb < 0.0 || lc < 0.0) {
+                                continue;
+                            }
+                            crossings.push_back(la*a.x + lb*b.x + lc*c.x);
+                        }
+                        std::sort(crossings.begin(), crossings.end());
+                    }
+                    index_t cur = 0;
+                    for(index_t u=0; u<n[0]; ++u) {
+                        while(
+                            cur < crossings.size() &&
+                            crossings[cur] < double(u)
+                        ) {
+                            ++cur;
+                        }
+                        index_t i = grid->linear_index(u,v,w);
+                        distance[i] = ::sqrtf(distance[i]);
+                        if((cur & 1) != 0) {
+                            distance[i] = -distance[i];
+                        }
+                    }
+                }
+            }
+        );
+
+        double elapsed = W.elapsed_time();
+        Logger::out("VoxelGrob")
+            << "narrow band distance: " << elapsed << " s ("
+            << nt << " triangles, "
+            << nb_rounds << " propagation rounds)"
+            << std::endl;
+
+        if(compare) {
+            std::string exact_name = attribute_name + "_exact";
+            Stopwatch W_exact("Distance",false);
+            compute_distance_to_surface(surface_name, exact_name, signed_dist);
+            double elapsed_exact = W_exact.elapsed_time();
+            Attribute<float> exact(grid->attributes(), exact_name);
+            double max_err = 0.0;
+            index_t nb_sign_errors = 0;
+            for(index_t i=0; i<nuvw; ++i) {
+                max_err = std::max(
+                    max_err,
+                    ::fabs(::fabs(double(distance[i])) -
+                           ::fabs(double(exact[i])))
+                );
+                if((distance[i] < 0.0f) != (exact[i] < 0.0f)) {
+                    ++nb_sign_errors;
+                }
+            }
+            exact.unbind();
+            grid->attributes().delete_attribute_store(exact_name);
+            Logger::out("VoxelGrob")
+                << "compute_distance_to_surface(): " << elapsed_exact << " s"
+                << " speedup: "
+                << (elapsed > 0.0 ? elapsed_exact / elapsed : 0.0)
+                << " max error: " << max_err
+                << " (" << max_err / hmax << " voxels)"
+                << std::endl;
+            if(signed_dist) {
+                Logger::out("VoxelGrob")
+                    << "sign mismatches: " << nb_sign_errors << std::endl;
+            }
+        }
+
+        grid->update();
+    }
+
     void VoxelGrobAttributesCommands::Poisson_reconstruction(
         const MeshGrobName& points_name,
         const std::string& attribute_name,
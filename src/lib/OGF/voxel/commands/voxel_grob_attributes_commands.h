@@ -114,6 +114,33 @@ namespace OGF {
             bool signed_dist=false
         );
 
+        /**
+         * \brief Computes the distance between each voxel and a surface,
+         *  using a narrow band and distance propagation.
+         * \details Exact distances are computed in a narrow band around
+         *  the facets, then the nearest facets are propagated to the
+         *  other voxels by parallel sweeps along the three axes. If
+         *  \p signed_dist is set, the sign is obtained by counting the
+         *  intersections of the scanlines along the U axis with the
+         *  surface (the surface needs to be closed). Much faster than
+         *  compute_distance_to_surface() for large grids.
+         * \param[in] surface the surface
+         * \param[in] attribute the name of the attribute
+         * \param[in] signed_dist if true, computes the signed distance,
+         *  else the (unsigned) distance, as compute_distance_to_surface()
+         * \param[in] band width of the narrow band, in voxels
+         * \param[in] compare if set, also runs
+         *  compute_distance_to_surface() and reports the maximum
+         *  difference and the speedup
+         */
+        void compute_narrow_band_distance_to_surface(
+            const MeshGrobName& surface,
+            const std::string& attribute="distance",
+            bool signed_dist=false,
+            index_t band=2,
+            bool compare=false
+        );
+
         /**
          * \brief Reconstructs a surface from points and normals using
          *  Misha Kahzdan's Screened Poisson Reconstruction.
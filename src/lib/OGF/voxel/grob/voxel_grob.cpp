@@ -105,6 +105,10 @@ namespace OGF {
     }
 
     Box3d VoxelGrob::bbox() const {
+        // The data of lazy objects is not read yet.
+        if(is_lazy()) {
+            return lazy_bbox();
+        }
         Box3d result;
         result.add_point(origin_);
         result.add_point(origin_ + U_);
@@ -156,6 +160,10 @@ namespace OGF {
         if(sg->is_bound(name)) {
             result = dynamic_cast<VoxelGrob*>(sg->resolve(name));
         }
+        // Commands access the data directly
+        if(result != nullptr) {
+            result->materialize();
+        }
         return result;
     }
 
@@ -196,6 +204,10 @@ namespace OGF {
         return true;
     }
 
+    bool VoxelGrob::supports_concurrent_serialization() const {
+        return true;
+    }
+
     bool VoxelGrob::serialize_read(InputGraphiteFile& in) {
         for(
             std::string chunk_class = in.next_chunk();
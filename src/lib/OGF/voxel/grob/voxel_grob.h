@@ -171,6 +171,11 @@ namespace OGF {
          */
         bool is_serializable() const override;
 
+        /**
+         * \copydoc Grob::supports_concurrent_serialization()
+         */
+        bool supports_concurrent_serialization() const override;
+
         /**
          * \copydoc Grob::serialize_read()
          */